@@ -0,0 +1,314 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "asyncio.h"
+
+#include <errno.h>
+#include <string.h>
+
+AsyncIO::AsyncIO(int fd, int depth):
+	errors(0), timers(depth), fd(fd), depth(depth), free_slots(depth) {
+	// lowest slots are taken first
+	for(int i = 0; i < depth; ++i) {
+		free_slots[i] = depth - 1 - i;
+	}
+}
+
+AsyncIO::~AsyncIO() {}
+
+int AsyncIO::TakeSlot() {
+	if(free_slots.empty()) {
+		return -1;
+	}
+	int slot = free_slots.back();
+	free_slots.pop_back();
+	return slot;
+}
+
+void AsyncIO::ReleaseSlot(int slot) {
+	free_slots.push_back(slot);
+}
+
+int AsyncIO::InFlight() {
+	return depth - free_slots.size();
+}
+
+int AsyncIO::GetDepth() {
+	return depth;
+}
+
+AsyncIO* AsyncIO::Create(int fd, int depth) {
+	// prefer io_uring
+	UringIO *uring = new UringIO(fd, depth);
+	if(uring->Init()) {
+		return uring;
+	}
+	delete uring;
+
+	// fall back to native AIO
+	NativeIO *native = new NativeIO(fd, depth);
+	if(native->Init()) {
+		return native;
+	}
+	delete native;
+
+	return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// io_uring engine ///////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+UringIO::UringIO(int fd, int depth):
+	AsyncIO(fd, depth), ring_fd(-1), to_submit(0),
+	sq_ptr(MAP_FAILED), sq_size(0), sqes(NULL), sqes_size(0),
+	cq_ptr(MAP_FAILED), cq_size(0), iovecs(depth) {}
+
+UringIO::~UringIO() {
+	if(sqes != NULL) {
+		munmap(sqes, sqes_size);
+	}
+	if((cq_ptr != MAP_FAILED) && (cq_ptr != sq_ptr)) {
+		munmap(cq_ptr, cq_size);
+	}
+	if(sq_ptr != MAP_FAILED) {
+		munmap(sq_ptr, sq_size);
+	}
+	if(ring_fd >= 0) {
+		close(ring_fd);
+	}
+}
+
+bool UringIO::Init() {
+	io_uring_params params;
+	memset(&params, 0, sizeof(io_uring_params));
+
+	// create ring
+	ring_fd = syscall(__NR_io_uring_setup, depth, &params);
+	if(ring_fd < 0) {
+		return false;
+	}
+
+	// map rings, newer kernels share one mapping for both of them
+	sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if(params.features & IORING_FEAT_SINGLE_MMAP) {
+		sq_size = cq_size = qMax(sq_size, cq_size);
+	}
+
+	sq_ptr = mmap(0, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+	if(sq_ptr == MAP_FAILED) {
+		return false;
+	}
+
+	if(params.features & IORING_FEAT_SINGLE_MMAP) {
+		cq_ptr = sq_ptr;
+	} else {
+		cq_ptr = mmap(0, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+		if(cq_ptr == MAP_FAILED) {
+			return false;
+		}
+	}
+
+	sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+	void *sqes_ptr = mmap(0, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+	if(sqes_ptr == MAP_FAILED) {
+		return false;
+	}
+	sqes = (io_uring_sqe*)sqes_ptr;
+
+	// locate ring fields
+	char *sq = (char*)sq_ptr;
+	sq_head = (unsigned*)(sq + params.sq_off.head);
+	sq_tail = (unsigned*)(sq + params.sq_off.tail);
+	sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+	sq_entries = (unsigned*)(sq + params.sq_off.ring_entries);
+	sq_array = (unsigned*)(sq + params.sq_off.array);
+
+	char *cq = (char*)cq_ptr;
+	cq_head = (unsigned*)(cq + params.cq_off.head);
+	cq_tail = (unsigned*)(cq + params.cq_off.tail);
+	cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+	cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	return true;
+}
+
+QString UringIO::Name() {
+	return "io_uring";
+}
+
+bool UringIO::Queue(int slot, char *buffer, hddsize size, hddsize pos) {
+	// check free space in submission ring
+	unsigned tail = *sq_tail;
+	if(tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= *sq_entries) {
+		return false;
+	}
+
+	// fill submission entry
+	iovecs[slot].iov_base = buffer;
+	iovecs[slot].iov_len = size;
+
+	unsigned index = tail & *sq_mask;
+	io_uring_sqe *sqe = &sqes[index];
+	memset(sqe, 0, sizeof(io_uring_sqe));
+	sqe->opcode = IORING_OP_READV;
+	sqe->fd = fd;
+	sqe->addr = (quint64)&iovecs[slot];
+	sqe->len = 1;
+	sqe->off = pos;
+	sqe->user_data = slot;
+
+	// publish entry
+	sq_array[index] = index;
+	__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+	++to_submit;
+
+	return true;
+}
+
+bool UringIO::Submit() {
+	while(to_submit > 0) {
+		int ret = syscall(__NR_io_uring_enter, ring_fd, to_submit, 0, 0, NULL, 0);
+		if(ret < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		to_submit -= ret;
+	}
+
+	return true;
+}
+
+int UringIO::Complete(int min, int *slots, qint64 *results) {
+	int done = 0;
+	while(true) {
+		// collect completed requests
+		unsigned head = *cq_head;
+		unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+		while((head != tail) && (done < depth)) {
+			io_uring_cqe *cqe = &cqes[head & *cq_mask];
+			if(cqe->res <= 0) {
+				++errors;
+			}
+			results[done] = cqe->res;
+			slots[done++] = cqe->user_data;
+			++head;
+		}
+		__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+		if(done >= min) {
+			return done;
+		}
+
+		// wait for the rest
+		int ret = syscall(__NR_io_uring_enter, ring_fd, 0, min - done, IORING_ENTER_GETEVENTS, NULL, 0);
+		if((ret < 0) && (errno != EINTR)) {
+			return -1;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// Native AIO engine /////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+NativeIO::NativeIO(int fd, int depth):
+	AsyncIO(fd, depth), ctx(0), iocbs(depth), events(depth) {
+	pending.reserve(depth);
+}
+
+NativeIO::~NativeIO() {
+	if(ctx != 0) {
+		syscall(__NR_io_destroy, ctx);
+	}
+}
+
+bool NativeIO::Init() {
+	return syscall(__NR_io_setup, depth, &ctx) == 0;
+}
+
+QString NativeIO::Name() {
+	return "aio";
+}
+
+bool NativeIO::Queue(int slot, char *buffer, hddsize size, hddsize pos) {
+	iocb &cb = iocbs[slot];
+	memset(&cb, 0, sizeof(iocb));
+	cb.aio_fildes = fd;
+	cb.aio_lio_opcode = IOCB_CMD_PREAD;
+	cb.aio_buf = (quint64)buffer;
+	cb.aio_nbytes = size;
+	cb.aio_offset = pos;
+	cb.aio_data = slot;
+
+	pending.push_back(&cb);
+
+	return true;
+}
+
+bool NativeIO::Submit() {
+	// kernel may accept only part of the requests
+	int submitted = 0;
+	int retries = 0;
+	while(submitted < pending.size()) {
+		int ret = syscall(__NR_io_submit, ctx, pending.size() - submitted, pending.data() + submitted);
+		if(ret < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			// resources may be freed by other processes, give up when they are not
+			if((errno == EAGAIN) && (++retries < SUBMIT_RETRIES)) {
+				usleep(1000);
+				continue;
+			}
+			pending.clear();
+			return false;
+		}
+		submitted += ret;
+		retries = 0;
+	}
+	pending.clear();
+
+	return true;
+}
+
+int NativeIO::Complete(int min, int *slots, qint64 *results) {
+	int ret;
+	do {
+		ret = syscall(__NR_io_getevents, ctx, min, depth, events.data(), NULL);
+	} while((ret < 0) && (errno == EINTR));
+
+	if(ret < 0) {
+		return -1;
+	}
+
+	for(int i = 0; i < ret; ++i) {
+		if((qint64)events[i].res <= 0) {
+			++errors;
+		}
+		results[i] = events[i].res;
+		slots[i] = events[i].data;
+	}
+
+	return ret;
+}
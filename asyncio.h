@@ -0,0 +1,153 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <linux/io_uring.h>
+#include <linux/aio_abi.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <QVector>
+#include <QString>
+
+#include "definitions.h"
+#include "timer.h"
+
+using namespace HDDTest;
+
+/// Keeps several read requests in flight on one file descriptor
+/** AsyncIO is common interface of asynchronous read engines used by Device
+to run benchmarks with queue depth higher than one. Every request occupies
+one slot (0 to depth - 1) until it is completed. Requests are queued by Queue,
+sent to kernel by Submit and collected by Complete. Create picks io_uring when
+kernel supports it and falls back to Linux native AIO. Both are used through
+raw system calls so no extra library is needed. **/
+class AsyncIO {
+public:
+	virtual ~AsyncIO();
+
+	/** Creates the best engine available for descriptor
+	  @param fd descriptor requests are issued on
+	  @param depth maximal count of requests in flight
+	  @return new engine or NULL when no asynchronous interface is available **/
+	static AsyncIO* Create(int fd, int depth);
+
+	virtual QString Name() = 0;	/// Engine name stored with results
+
+	/** Queue read request. Request is not sent to kernel until Submit is called.
+	  @param slot request slot, must not be in flight
+	  @param buffer target buffer
+	  @param size size to be read
+	  @param pos position to read from
+	  @return false when request cannot be queued **/
+	virtual bool Queue(int slot, char *buffer, hddsize size, hddsize pos) = 0;
+
+	/** Sends all queued requests to kernel
+	  @return false on failure **/
+	virtual bool Submit() = 0;
+
+	/** Waits for completed requests
+	  @param min minimal count of requests to wait for
+	  @param slots array receiving slots of completed requests (at least depth items)
+	  @param results array receiving bytes read by completed requests, 0 or negative error code on failure (at least depth items)
+	  @return count of completed requests or -1 on failure **/
+	virtual int Complete(int min, int *slots, qint64 *results) = 0;
+
+	/** Takes free slot for new request
+	  @return slot or -1 when all slots are in flight **/
+	int TakeSlot();
+
+	void ReleaseSlot(int slot);	/// Returns slot of completed request
+	int InFlight();				/// Count of requests in flight
+	int GetDepth();				/// Maximal count of requests in flight
+
+	int errors;				/// Count of requests that failed or read no data
+	QVector<Timer> timers;	/// Latency timer of every slot, kept while request is in flight
+
+protected:
+	AsyncIO(int fd, int depth);
+
+	int fd;		/// Descriptor requests are issued on
+	int depth;	/// Maximal count of requests in flight
+	QVector<int> free_slots;	/// Slots not in flight
+};
+
+/// io_uring engine
+/** Implements AsyncIO on top of io_uring submission and completion rings
+mapped to process memory. Read requests use IORING_OP_READV in order to
+work on the first kernels providing io_uring. **/
+class UringIO : public AsyncIO {
+public:
+	UringIO(int fd, int depth);
+	~UringIO();
+
+	bool Init();	/// Sets up rings, returns false when io_uring is not available
+
+	QString Name();
+	bool Queue(int slot, char *buffer, hddsize size, hddsize pos);
+	bool Submit();
+	int Complete(int min, int *slots, qint64 *results);
+
+private:
+	int ring_fd;
+	unsigned to_submit;
+
+	// submission ring
+	void *sq_ptr;
+	size_t sq_size;
+	unsigned *sq_head, *sq_tail, *sq_mask, *sq_entries, *sq_array;
+	io_uring_sqe *sqes;
+	size_t sqes_size;
+
+	// completion ring
+	void *cq_ptr;
+	size_t cq_size;
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	io_uring_cqe *cqes;
+
+	QVector<iovec> iovecs;	// one vector per slot, alive until request completes
+};
+
+/// Linux native AIO engine
+/** Implements AsyncIO on top of io_setup/io_submit/io_getevents. Native AIO
+is only really asynchronous for descriptors opened with O_DIRECT. **/
+class NativeIO : public AsyncIO {
+public:
+	static const int SUBMIT_RETRIES = 100;	/// Attempts to submit while kernel is out of AIO resources
+
+	NativeIO(int fd, int depth);
+	~NativeIO();
+
+	bool Init();	/// Sets up AIO context, returns false when AIO is not available
+
+	QString Name();
+	bool Queue(int slot, char *buffer, hddsize size, hddsize pos);
+	bool Submit();
+	int Complete(int min, int *slots, qint64 *results);
+
+private:
+	aio_context_t ctx;
+	QVector<iocb> iocbs;		// one control block per slot
+	QVector<iocb*> pending;		// control blocks waiting for submit
+	QVector<io_event> events;	// completion events buffer
+};
@@ -0,0 +1,142 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include <iostream>
+
+#include "benchmark.h"
+
+// TestThread holds pointer to Benchmark and vice versa
+// so extra including in cpp file is needed
+#include "testthread.h"
+
+Benchmark::Benchmark(QObject *parent) :
+	QObject(parent), sampler(&counters) {
+	device = NULL;
+
+	test_thread = new TestThread(this);
+	testState = STOPPED;
+	directIO = false;
+	verify = false;
+	mode = 0;
+	destructive = false;
+	seed = RandomGenerator::DEFAULT_SEED;
+	rangeBegin = 0;
+	rangeEnd = 0;
+
+	connect(test_thread, SIGNAL(test_started()), this, SLOT(test_started()));
+	connect(test_thread, SIGNAL(test_stopped()), this, SLOT(test_stopped()));
+}
+
+Benchmark::~Benchmark() {
+	delete test_thread;
+}
+
+void Benchmark::SetDevice(Device *device) {
+	this->device = device;
+}
+
+void Benchmark::SetRange(hddsize begin, hddsize end) {
+	rangeBegin = begin;
+	rangeEnd = end;
+}
+
+RandomOffset Benchmark::GetOffsets(hddsize block, hddsize begin, hddsize length, hddsize align) {
+	hddsize end = (length > 0)?begin + length:device->GetSize();
+	begin = qMax(begin, rangeBegin);
+	if(rangeEnd > 0) {
+		end = qMin(end, rangeEnd);
+	}
+
+	// block aligned positions are valid for direct access of any block size
+	hddsize logical = qMax(device->GetBlockSize(), (hddsize)1);
+	align = (((align > 0)?align:block) + logical - 1) / logical * logical;
+
+	RandomOffset offsets(begin, end, block, align);
+	if(offsets.Count() == 0) {
+		std::cerr << "Range of random positions is smaller than block of " << qPrintable(Def::FormatSize(block)) << std::endl;
+	}
+
+	return offsets;
+}
+
+hddsize Benchmark::GetRandomBlock() {
+	return 0;
+}
+
+bool Benchmark::StartTest() {
+	if(!device) {
+		std::cerr << "WARNING: Start test without valid device pointer - ignoring" << std::endl;
+		return false;
+	}
+
+	// start test in another thread
+	testState = STARTING;
+	verifier.stopping = false;
+	InitResults();
+	test_thread->start();
+
+	return true;
+}
+
+void Benchmark::StopTest() {
+	testState = STOPPING;
+	verifier.stopping = true;
+}
+
+void Benchmark::InitResults() {}
+
+void Benchmark::test_started() {
+	testState = STARTED;
+	emit started();
+}
+
+void Benchmark::test_stopped() {
+	testState = STOPPED;
+	emit stopped();
+}
+
+void Benchmark::SetDestructive(bool destructive) {
+	this->destructive = destructive;
+}
+
+void Benchmark::AddMode(QString name) {
+	modes.append(name);
+}
+
+Benchmark::Metric::Metric(QString name, qreal value, QString unit, bool higher):
+	name(name), value(value), unit(unit), higher(higher) {}
+
+QList<Benchmark::Metric> Benchmark::GetMetrics() {
+	return QList<Metric>();
+}
+
+QStringList Benchmark::GetModes() {
+	return modes;
+}
+
+bool Benchmark::SetMode(int index) {
+	if((index < 0) || (index >= modes.size())) {
+		return false;
+	}
+
+	mode = index;
+
+	return true;
+}
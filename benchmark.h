@@ -0,0 +1,178 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "device.h"
+#include "histogram.h"
+#include "randomgenerator.h"
+#include "sampler.h"
+#include "verifier.h"
+
+// Forward declaration od TestThread class
+class TestThread;
+
+/// Base for all benchmarks - measuring code, results and their storage
+/** The Benchmark class is base for all specialized benchmark classes.
+It holds benchmark settings, runs measuring code in separate thread
+and defines interface to results. It depends on QtCore only, so the same
+benchmark classes are used by graphical application, where TestWidget
+subclasses draw their results, and by command line runner without any
+display. The benchmark classes are intended to extend this class and
+implement pure virtual methods to provide benchmark specific functionality. **/
+class Benchmark : public QObject {
+	Q_OBJECT
+
+public:
+	enum DataSet { RESULTS, REFERENCE };
+	enum TestState { STARTING, STARTED, STOPPING, STOPPED };
+
+	/// One number describing results, used to compare many results
+	struct Metric {
+		Metric(QString name, qreal value, QString unit, bool higher);
+
+		QString name;	/// Metric name including its parameters
+		qreal value;	/// Measured value
+		QString unit;	/// Unit of value
+		bool higher;	/// Whenever higher value is better
+	};
+
+	explicit Benchmark(QObject *parent = 0);
+	~Benchmark();
+
+	/** Set pointer to device benchmark is run on.
+	  @param device pointer to new device **/
+	void SetDevice(Device *device);
+
+	/** Add benchmark mode. Selected mode index is stored in mode.
+	  @param name mode description **/
+	void AddMode(QString name);
+
+	QStringList GetModes();	/// Names of benchmark modes, empty when benchmark has no modes
+
+	/** Select benchmark mode
+	  @param index mode index
+	  @return false when there is no such mode **/
+	bool SetMode(int index);
+
+	/** Set whenever the benchmark overwrites data on raw device. Destructive
+	  benchmarks are only started once device is open for exclusive writing.
+	  @param destructive whenever benchmark writes to device **/
+	void SetDestructive(bool destructive);
+
+	/** Limit random positions to part of device
+	  @param begin first byte of range
+	  @param end byte behind range, 0 for end of device **/
+	void SetRange(hddsize begin, hddsize end);
+
+	/** Creates generator of random block positions in selected range of device
+	  @param block size of accessed block, positions are aligned to it
+	  @param begin first byte of area, range is applied on top of it
+	  @param length area size, 0 for whole device
+	  @param align alignment of positions, block size when 0
+	  @return offset generator, without positions when block does not fit to range **/
+	RandomOffset GetOffsets(hddsize block, hddsize begin = 0, hddsize length = 0, hddsize align = 0);
+
+	/** Largest block accessed at random positions of device, selected range has to hold it.
+	Benchmarks without random device access do not reimplement it and return 0. **/
+	virtual hddsize GetRandomBlock();
+
+	/** Starts the benchmark in separate thread
+	  @return false when there is no device to run on **/
+	bool StartTest();
+	void StopTest();	/// Cancels benchmark
+
+	// test specific functions
+	/** Erases results of previous run before benchmark thread is started.
+	Benchmark class reimplements it when its results are not erased by TestLoop. **/
+	virtual void InitResults();
+
+	/** Benchmarking code run in separate thread.
+	This method is implemntd by benchmark specific class. **/
+	virtual void TestLoop() = 0;
+
+	/** Reports test progress in range from 0 to 100.
+	This is implemented by benchmark class. The return value is used to
+	update progress bar below the graph.**/
+	virtual int GetProgress() = 0;
+
+	/** Returns human readable summary of primary results, one value per line.
+	This is implemented by benchmark class and used by command line runner.**/
+	virtual QString GetSummary() = 0;
+
+	/** Returns main numbers of measured results. Benchmark classes reimplement
+	it to take part in comparison of many results, there are none by default.**/
+	virtual QList<Metric> GetMetrics();
+
+	/** This method is implemented by benchmark specific class.
+	It should erase reference or measured resutls.
+	  @param dataset which resutls should be erased
+	  @see DataSet **/
+	virtual void EraseResults(DataSet dataset) = 0;
+
+	/** This method is called when resutls should be saved.
+	 The class extending Benchmark should supply code neede to save resutls.
+	 Results are streamed element by element, attributes go before child elements.
+	 @param writer ResultWriter to which results should be saved. **/
+	virtual void WriteResults(ResultWriter &writer) = 0;
+
+	/** Method implemented by benchmark specific class. It should load results from
+	result file element.
+	 @param root resutls root element
+	 @param dataset which results are to be replace **/
+	virtual void RestoreResults(const ResultElement &root, DataSet dataset) = 0;
+
+	Device *device;				/// Pointer to device selected for testing
+
+	QString testName;			/// Test name
+	QString testDescription;	/// Test description - used by info box
+
+	TestState testState;		/// Current test state
+	bool directIO;				/// Whenever device is accessed with O_DIRECT during benchmark
+	int mode;					/// Selected benchmark mode
+	bool destructive;			/// Whenever benchmark overwrites data on device
+	quint64 seed;				/// Seed of random generators, stored with results
+	hddsize rangeBegin;			/// First byte of device used by random positions
+	hddsize rangeEnd;			/// Byte behind device range, 0 for end of device
+	DataPattern pattern;		/// Content of data written by benchmark, stored with results
+	bool verify;				/// Whenever written data are stamped and checked on read
+	Verifier verifier;			/// Integrity of data written in verify mode
+	Counters counters;			/// Operations of running benchmark, taken by sampler
+	Sampler sampler;			/// Throughput time series of results
+
+private:
+	TestThread *test_thread;
+	QStringList modes;
+
+private slots:
+	void test_started();
+	void test_stopped();
+
+signals:
+	/// Emited when benchmark thread has started measuring
+	void started();
+	/// Emitted when benchmark thread has finished
+	void stopped();
+};
@@ -0,0 +1,261 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "blockstats.h"
+#include "resultfile.h"
+#include "resultwriter.h"
+
+#include <time.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+
+/// Reads first line of sysfs file
+static QString ReadLine(QString path) {
+	QFile file(path);
+	if(!file.open(QFile::ReadOnly | QIODevice::Text)) {
+		return QString();
+	}
+
+	return QString::fromLatin1(file.readLine()).trimmed();
+}
+
+/// Current monotonic time
+static hddtime Now() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * s + now.tv_nsec * ns;
+}
+
+BlockStats::Snapshot::Snapshot():
+	valid(false), time(0), reads(0), read_merges(0), read_sectors(0), read_ticks(0),
+	writes(0), write_merges(0), write_sectors(0), write_ticks(0),
+	in_flight(0), io_ticks(0), time_in_queue(0) {}
+
+BlockStats::BlockStats() {
+	erase();
+}
+
+void BlockStats::Start(QString path) {
+	erase();
+	name = QFileInfo(QFileInfo(path).canonicalFilePath()).fileName();
+	if(name.isEmpty()) {
+		return;
+	}
+
+	// queue belongs to whole disk, partition directory is inside of it
+	QString dir = QFileInfo("/sys/class/block/" + name).canonicalFilePath();
+	if(!QDir(dir + "/queue").exists()) {
+		dir = QFileInfo(dir).path();
+	}
+	QString active = ReadLine(dir + "/queue/scheduler");
+	scheduler = active.contains('[')?active.section('[', 1).section(']', 0, 0):active;
+	nr_requests = ReadLine(dir + "/queue/nr_requests").toLongLong();
+	rotational = ReadLine(dir + "/queue/rotational").toLongLong();
+	logical_block_size = ReadLine(dir + "/queue/logical_block_size").toLongLong();
+	read_ahead_kb = ReadLine(dir + "/queue/read_ahead_kb").toLongLong();
+
+	first = Read();
+}
+
+void BlockStats::Sample() {
+	if(!first.valid) {
+		return;
+	}
+
+	Snapshot current = Read();
+	if(current.valid) {
+		in_flight_sum += current.in_flight;
+		++in_flight_samples;
+		diff.in_flight = qMax(diff.in_flight, current.in_flight);
+	}
+}
+
+void BlockStats::Stop() {
+	if(!first.valid) {
+		return;
+	}
+
+	Snapshot last = Read();
+	if(!last.valid) {
+		return;
+	}
+
+	diff.valid = true;
+	diff.time = last.time - first.time;
+	diff.reads = last.reads - first.reads;
+	diff.read_merges = last.read_merges - first.read_merges;
+	diff.read_sectors = last.read_sectors - first.read_sectors;
+	diff.read_ticks = last.read_ticks - first.read_ticks;
+	diff.writes = last.writes - first.writes;
+	diff.write_merges = last.write_merges - first.write_merges;
+	diff.write_sectors = last.write_sectors - first.write_sectors;
+	diff.write_ticks = last.write_ticks - first.write_ticks;
+	diff.io_ticks = last.io_ticks - first.io_ticks;
+	diff.time_in_queue = last.time_in_queue - first.time_in_queue;
+}
+
+BlockStats::Snapshot BlockStats::Read() {
+	Snapshot snapshot;
+	snapshot.time = Now();
+
+	// sysfs stat holds the same fields as diskstats line behind device name
+	QStringList fields = ReadLine("/sys/class/block/" + name + "/stat").split(' ', Qt::SkipEmptyParts);
+	if(fields.size() < 11) {
+		fields.clear();
+		QFile diskstats("/proc/diskstats");
+		if(diskstats.open(QFile::ReadOnly | QIODevice::Text)) {
+			while(true) {
+				QString line = diskstats.readLine();
+				if(line.length() == 0)
+					break;
+
+				QStringList list = line.split(' ', Qt::SkipEmptyParts);
+				if((list.size() >= 14) && (list[2] == name)) {
+					fields = list.mid(3);
+					break;
+				}
+			}
+		}
+		if(fields.size() < 11) {
+			return snapshot;
+		}
+	}
+
+	snapshot.reads = fields[0].toLongLong();
+	snapshot.read_merges = fields[1].toLongLong();
+	snapshot.read_sectors = fields[2].toLongLong();
+	snapshot.read_ticks = fields[3].toLongLong();
+	snapshot.writes = fields[4].toLongLong();
+	snapshot.write_merges = fields[5].toLongLong();
+	snapshot.write_sectors = fields[6].toLongLong();
+	snapshot.write_ticks = fields[7].toLongLong();
+	snapshot.in_flight = fields[8].toLongLong();
+	snapshot.io_ticks = fields[9].toLongLong();
+	snapshot.time_in_queue = fields[10].toLongLong();
+	snapshot.valid = true;
+
+	return snapshot;
+}
+
+bool BlockStats::IsValid() const {
+	return diff.valid;
+}
+
+qreal BlockStats::Utilization() const {
+	return (diff.time > 0)?100.0 * diff.io_ticks * ms / diff.time:0;
+}
+
+qreal BlockStats::QueueSize() const {
+	return (diff.time > 0)?(qreal)diff.time_in_queue * ms / diff.time:0;
+}
+
+qreal BlockStats::InFlight() const {
+	return (in_flight_samples > 0)?(qreal)in_flight_sum / in_flight_samples:0;
+}
+
+QString BlockStats::Summary() const {
+	return name + " (" + scheduler + "): utilization " + QString::number(Utilization(), 'f', 1) + " %" +
+			", queue " + QString::number(QueueSize(), 'f', 2) +
+			", in flight " + QString::number(InFlight(), 'f', 2) + " max " + QString::number(diff.in_flight) +
+			", merged reads " + QString::number(diff.read_merges) + " of " + QString::number(diff.reads + diff.read_merges) +
+			", merged writes " + QString::number(diff.write_merges) + " of " + QString::number(diff.writes + diff.write_merges);
+}
+
+void BlockStats::Write(ResultWriter &writer) const {
+	if(!diff.valid) {
+		return;
+	}
+
+	writer.StartElement("Block_Stats");
+	writer.Attribute("device", name);
+	writer.Attribute("scheduler", scheduler);
+	writer.Attribute("nr_requests", nr_requests);
+	writer.Attribute("rotational", rotational);
+	writer.Attribute("logical_block_size", logical_block_size);
+	writer.Attribute("read_ahead_kb", read_ahead_kb);
+	writer.Attribute("time", diff.time);
+	writer.Attribute("reads", diff.reads);
+	writer.Attribute("read_merges", diff.read_merges);
+	writer.Attribute("read_sectors", diff.read_sectors);
+	writer.Attribute("read_ticks", diff.read_ticks);
+	writer.Attribute("writes", diff.writes);
+	writer.Attribute("write_merges", diff.write_merges);
+	writer.Attribute("write_sectors", diff.write_sectors);
+	writer.Attribute("write_ticks", diff.write_ticks);
+	writer.Attribute("io_ticks", diff.io_ticks);
+	writer.Attribute("time_in_queue", diff.time_in_queue);
+	writer.Attribute("in_flight_max", diff.in_flight);
+	writer.Attribute("in_flight_sum", in_flight_sum);
+	writer.Attribute("in_flight_samples", in_flight_samples);
+
+	// derived numbers for readers of the file
+	writer.Attribute("utilization", Utilization());
+	writer.Attribute("queue_size", QueueSize());
+	writer.Attribute("in_flight", InFlight());
+	writer.EndElement();
+}
+
+void BlockStats::Read(const ResultElement &root) {
+	erase();
+
+	ResultElement master = root.Child("Block_Stats");
+	if(master.IsNull()) {
+		return;
+	}
+
+	name = master.Attribute("device");
+	scheduler = master.Attribute("scheduler");
+	nr_requests = master.Integer("nr_requests");
+	rotational = master.Integer("rotational");
+	logical_block_size = master.Integer("logical_block_size");
+	read_ahead_kb = master.Integer("read_ahead_kb");
+	diff.time = master.Integer("time");
+	diff.reads = master.Integer("reads");
+	diff.read_merges = master.Integer("read_merges");
+	diff.read_sectors = master.Integer("read_sectors");
+	diff.read_ticks = master.Integer("read_ticks");
+	diff.writes = master.Integer("writes");
+	diff.write_merges = master.Integer("write_merges");
+	diff.write_sectors = master.Integer("write_sectors");
+	diff.write_ticks = master.Integer("write_ticks");
+	diff.io_ticks = master.Integer("io_ticks");
+	diff.time_in_queue = master.Integer("time_in_queue");
+	diff.in_flight = master.Integer("in_flight_max");
+	in_flight_sum = master.Integer("in_flight_sum");
+	in_flight_samples = master.Integer("in_flight_samples");
+	diff.valid = true;
+}
+
+void BlockStats::erase() {
+	name.clear();
+	scheduler.clear();
+	nr_requests = 0;
+	rotational = 0;
+	logical_block_size = 0;
+	read_ahead_kb = 0;
+	diff = Snapshot();
+	first = Snapshot();
+	in_flight_sum = 0;
+	in_flight_samples = 0;
+}
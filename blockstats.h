@@ -0,0 +1,93 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+#include "definitions.h"
+
+class ResultWriter;
+class ResultElement;
+
+using namespace HDDTest;
+
+/// Collects kernel block layer counters of device during benchmark
+/** BlockStats snapshots I/O statistics of block device from sysfs stat file
+(or /proc/diskstats when sysfs is not available) when benchmark starts and
+stops and reads count of requests in flight on every sample in between.
+Queue settings of the disk are read at start. Derived numbers tell whether
+kernel merged requests, how busy the device was and how deep its queue got,
+so results can be told apart from effects of scheduler or read ahead. **/
+class BlockStats {
+public:
+	/// Counters of one stat file read, in stat file order
+	struct Snapshot {
+		Snapshot();
+
+		bool valid;			/// Whenever counters were read
+		hddtime time;		/// Time of reading
+		qint64 reads;		/// Finished reads
+		qint64 read_merges;	/// Reads merged with other reads
+		qint64 read_sectors;/// 512 byte sectors read
+		qint64 read_ticks;	/// Time spent reading in ms
+		qint64 writes;		/// Finished writes
+		qint64 write_merges;/// Writes merged with other writes
+		qint64 write_sectors;	/// 512 byte sectors written
+		qint64 write_ticks;	/// Time spent writing in ms
+		qint64 in_flight;	/// Requests in flight
+		qint64 io_ticks;	/// Time device was busy in ms
+		qint64 time_in_queue;	/// Weighted time requests spent in queue in ms
+	};
+
+	BlockStats();
+
+	/** Reads queue settings and first snapshot
+	  @param path block device node **/
+	void Start(QString path);
+	void Sample();	/// Reads requests in flight
+	void Stop();	/// Reads last snapshot and computes differences
+
+	bool IsValid() const;		/// Whenever device counters were collected
+	qreal Utilization() const;	/// Share of time device was busy in percent
+	qreal QueueSize() const;	/// Average count of requests in queue
+	qreal InFlight() const;		/// Average of sampled requests in flight
+
+	QString Summary() const;	/// Main numbers in human readable form
+
+	void Write(ResultWriter &writer) const;	/// Writes block stats element
+	void Read(const ResultElement &root);	/// Reads block stats element of benchmark element
+	void erase();	/// Erase collected data
+
+	QString name;			/// Kernel name of block device
+	QString scheduler;		/// Active I/O scheduler
+	qint64 nr_requests;		/// Queue depth of scheduler
+	qint64 rotational;		/// Whenever device is rotational
+	qint64 logical_block_size;	/// Logical block size
+	qint64 read_ahead_kb;	/// Read ahead size in KB
+	Snapshot diff;			/// Counter differences over benchmark, in_flight is maximum
+	qint64 in_flight_sum;	/// Sum of sampled requests in flight
+	qint64 in_flight_samples;	/// Count of samples
+
+private:
+	Snapshot Read();	// read counters of device
+
+	Snapshot first;
+};
@@ -0,0 +1,613 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include <iostream>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStorageInfo>
+
+#include "cli.h"
+#include "comparison.h"
+#include "filerw.h"
+#include "filestructure.h"
+#include "mixedworkload.h"
+#include "readblock.h"
+#include "readcont.h"
+#include "readrnd.h"
+#include "readthreads.h"
+#include "resultstore.h"
+#include "seeker.h"
+#include "smallfiles.h"
+#include "writeblock.h"
+#include "writecont.h"
+#include "writernd.h"
+
+CommandLine::CommandLine(QObject *parent):
+	QObject(parent), exitCode(0), current(-1), direct(false), destroyData(false), store(false) {
+	// benchmarks in order of main window tabs
+	AddBenchmark("readrnd", RAW, new ReadRnd());
+	AddBenchmark("readthreads", RAW, new ReadThreads());
+	AddBenchmark("readcont", RAW, new ReadCont());
+	AddBenchmark("readblock", RAW, new ReadBlock());
+	AddBenchmark("seek", RAW, new Seeker());
+	AddBenchmark("writecont", DESTRUCTIVE, new WriteCont());
+	AddBenchmark("writeblock", DESTRUCTIVE, new WriteBlock());
+	AddBenchmark("writernd", DESTRUCTIVE, new WriteRnd());
+	AddBenchmark("filerw", FILESYSTEM, new FileRW());
+	AddBenchmark("structure", FILESYSTEM, new FileStructure());
+	AddBenchmark("smallfiles", FILESYSTEM, new SmallFiles());
+	AddBenchmark("mixed", MIXED, new MixedWorkload());
+
+	connect(&device, SIGNAL(accessWarning()), this, SLOT(device_accessWarning()));
+	connect(&device, SIGNAL(operationError()), this, SLOT(device_operationError()));
+	connect(&progress_timer, SIGNAL(timeout()), this, SLOT(progress_timer_timeout()));
+}
+
+CommandLine::~CommandLine() {
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		delete benchmarks[i].test;
+	}
+}
+
+void CommandLine::AddBenchmark(QString name, Kind kind, Benchmark *test) {
+	Item benchmark;
+	benchmark.name = name;
+	benchmark.kind = kind;
+	benchmark.test = test;
+	test->SetDevice(&device);
+
+	benchmarks.append(benchmark);
+}
+
+bool CommandLine::Start(const QStringList &arguments) {
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Runs HDDTest benchmarks without graphical interface.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("device", "Block device, partition or mount point to be tested.");
+
+	QCommandLineOption listOption(QStringList() << "l" << "list", "List benchmarks and their modes.");
+	QCommandLineOption benchmarksOption(QStringList() << "b" << "benchmarks",
+			"Comma separated benchmarks to run, all non-destructive benchmarks applicable to device by default.", "names");
+	QCommandLineOption modeOption(QStringList() << "m" << "mode",
+			"Select benchmark mode by its index, can be repeated.", "name=index");
+	QCommandLineOption outputOption(QStringList() << "o" << "output",
+			"Result file, device name with .hddtest suffix by default."
+			" Suffix .jsonl or .csv selects JSON Lines or CSV export.", "file");
+	QCommandLineOption directOption("direct", "Bypass page cache (O_DIRECT) in raw device benchmarks.");
+	QCommandLineOption destroyOption("destroy-data",
+			"Allow write benchmarks to overwrite all data on device that is not mounted.");
+	QCommandLineOption convertOption("convert",
+			"Convert result file to format of output file instead of running benchmarks.", "file");
+	QCommandLineOption seedOption("seed",
+			"Seed of random positions, stored in result file in order to repeat the same run.", "number");
+	QCommandLineOption rangeOption("lba-range",
+			"Limit random positions of raw device benchmarks to logical blocks first to last.", "first-last");
+	QCommandLineOption mixOption("mix",
+			"Workload profile of mixed benchmark instead of its mode,"
+			" for example read=70,pattern=random,zipf=0.99,bs=8K:90/64K:10.", "profile");
+	QCommandLineOption verifyOption("verify",
+			"Stamp written blocks by offset, sequence and CRC32C and check them when read back.");
+	QCommandLineOption patternOption("pattern",
+			"Content of written data: random (default), zeros, compressible:percent or dedupable:percent,"
+			" for one benchmark as name=pattern, can be repeated.", "pattern");
+	QCommandLineOption cacheOption("drop-caches",
+			"Caches emptied before benchmarks: files (benchmark files and device buffers, default),"
+			" cgroup (also page cache of own cgroup) or global (whole system).", "scope");
+	QCommandLineOption storeOption("store", "Add result file to local result store.");
+	QCommandLineOption queryOption("query",
+			"List stored results matching model, serial, firmware or kernel, can be repeated.", "key=value");
+	QCommandLineOption compareOption("compare",
+			"Compare result files given instead of device and results matching --query.");
+	parser.addOption(listOption);
+	parser.addOption(benchmarksOption);
+	parser.addOption(modeOption);
+	parser.addOption(outputOption);
+	parser.addOption(directOption);
+	parser.addOption(destroyOption);
+	parser.addOption(convertOption);
+	parser.addOption(seedOption);
+	parser.addOption(rangeOption);
+	parser.addOption(mixOption);
+	parser.addOption(verifyOption);
+	parser.addOption(patternOption);
+	parser.addOption(cacheOption);
+	parser.addOption(storeOption);
+	parser.addOption(queryOption);
+	parser.addOption(compareOption);
+	parser.process(arguments);
+
+	if(parser.isSet(listOption)) {
+		ListBenchmarks();
+		return false;
+	}
+
+	if(parser.isSet(convertOption)) {
+		if(!parser.isSet(outputOption)) {
+			std::cerr << "Output file has to be given for conversion, see --help." << std::endl;
+			exitCode = 1;
+			return false;
+		}
+		output = parser.value(outputOption);
+		if(!ConvertResultFile(parser.value(convertOption))) {
+			exitCode = 1;
+		}
+		return false;
+	}
+
+	if(parser.isSet(queryOption) || parser.isSet(compareOption)) {
+		QStringList files = parser.positionalArguments();
+		if(parser.isSet(queryOption)) {
+			QList<ResultStore::Entry> entries;
+			if(!QueryStore(parser.values(queryOption), entries)) {
+				exitCode = 1;
+				return false;
+			}
+			for(int i = 0; i < entries.size(); ++i) {
+				std::cout << qPrintable(entries[i].Label()) << std::endl;
+				files.append(entries[i].file);
+			}
+		}
+		if(parser.isSet(compareOption) && !CompareResultFiles(files)) {
+			exitCode = 1;
+		}
+		return false;
+	}
+
+	if(parser.positionalArguments().size() != 1) {
+		std::cerr << "Exactly one device has to be given, see --help." << std::endl;
+		exitCode = 1;
+		return false;
+	}
+
+	direct = parser.isSet(directOption);
+	destroyData = parser.isSet(destroyOption);
+	store = parser.isSet(storeOption);
+
+	// select caches evicted before benchmarks
+	Device::CacheScope scope = Device::CacheScope::FILES;
+	if(parser.isSet(cacheOption) && !Device::ParseCacheScope(parser.value(cacheOption), scope)) {
+		std::cerr << "Invalid cache scope " << qPrintable(parser.value(cacheOption)) << "." << std::endl;
+		exitCode = 1;
+		return false;
+	}
+	device.SetCacheScope(scope);
+
+	// open device
+	QString path = parser.positionalArguments().first();
+	if(!OpenDevice(path)) {
+		std::cerr << "Cannot open device " << qPrintable(path) << "." << std::endl;
+		exitCode = 1;
+		return false;
+	}
+	output = parser.isSet(outputOption)?parser.value(outputOption):QFileInfo(device.path).fileName() + ".hddtest";
+
+	// select benchmarks
+	QStringList names = parser.value(benchmarksOption).split(",", Qt::SkipEmptyParts);
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		QString reason;
+		if(names.isEmpty()) {
+			bool writes = (benchmarks[i].kind == DESTRUCTIVE) || ((benchmarks[i].kind == MIXED) && !device.fs);
+			if(!writes && Applicable(benchmarks[i], reason)) {
+				queue.append(i);
+			}
+		} else if(names.contains(benchmarks[i].name)) {
+			if(!Applicable(benchmarks[i], reason)) {
+				std::cerr << qPrintable(benchmarks[i].name) << " cannot be run: " << qPrintable(reason) << std::endl;
+				exitCode = 1;
+				return false;
+			}
+			queue.append(i);
+			names.removeAll(benchmarks[i].name);
+		}
+	}
+	if(!names.isEmpty()) {
+		std::cerr << "Unknown benchmark " << qPrintable(names.first()) << ", see --list." << std::endl;
+		exitCode = 1;
+		return false;
+	}
+
+	// select modes
+	QStringList modes = parser.values(modeOption);
+	for(int i = 0; i < modes.size(); ++i) {
+		QString name = modes[i].section('=', 0, 0);
+		bool ok = false;
+		int index = modes[i].section('=', 1).toInt(&ok);
+
+		bool found = false;
+		for(int j = 0; j < benchmarks.size(); ++j) {
+			if(benchmarks[j].name == name) {
+				found = ok && benchmarks[j].test->SetMode(index);
+			}
+		}
+		if(!found) {
+			std::cerr << "Invalid mode " << qPrintable(modes[i]) << ", see --list." << std::endl;
+			exitCode = 1;
+			return false;
+		}
+	}
+
+	// select seed and range of random positions
+	quint64 seed = RandomGenerator::DEFAULT_SEED;
+	if(parser.isSet(seedOption)) {
+		bool ok = false;
+		seed = parser.value(seedOption).toULongLong(&ok, 0);
+		if(!ok) {
+			std::cerr << "Invalid seed " << qPrintable(parser.value(seedOption)) << "." << std::endl;
+			exitCode = 1;
+			return false;
+		}
+	}
+	hddsize rangeBegin = 0, rangeEnd = 0;
+	if(parser.isSet(rangeOption)) {
+		bool okFirst = false, okLast = false;
+		hddsize first = parser.value(rangeOption).section('-', 0, 0).toLongLong(&okFirst);
+		hddsize last = parser.value(rangeOption).section('-', 1).toLongLong(&okLast);
+		rangeBegin = first * device.GetBlockSize();
+		rangeEnd = (last + 1) * device.GetBlockSize();
+		if(!okFirst || !okLast || (first < 0) || (last < first) || (rangeEnd > device.GetSize())) {
+			std::cerr << "Invalid LBA range " << qPrintable(parser.value(rangeOption)) << "." << std::endl;
+			exitCode = 1;
+			return false;
+		}
+	}
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		benchmarks[i].test->seed = seed;
+		benchmarks[i].test->SetRange(rangeBegin, rangeEnd);
+		benchmarks[i].test->verify = parser.isSet(verifyOption);
+	}
+
+	// content of written data, pattern without name applies to all benchmarks
+	QStringList patterns = parser.values(patternOption);
+	for(int i = 0; i < patterns.size(); ++i) {
+		QString name = patterns[i].contains('=')?patterns[i].section('=', 0, 0):QString();
+		DataPattern pattern;
+		bool found = DataPattern::Parse(patterns[i].section('=', -1), pattern);
+		bool matched = name.isEmpty();
+		for(int j = 0; found && (j < benchmarks.size()); ++j) {
+			if(name.isEmpty() || (benchmarks[j].name == name)) {
+				benchmarks[j].test->pattern = pattern;
+				matched = true;
+			}
+		}
+		if(!found || !matched) {
+			std::cerr << "Invalid pattern " << qPrintable(patterns[i]) << ", see --help." << std::endl;
+			exitCode = 1;
+			return false;
+		}
+	}
+
+	// custom mixed workload profile
+	if(parser.isSet(mixOption)) {
+		for(int i = 0; i < benchmarks.size(); ++i) {
+			MixedWorkload *mixed = dynamic_cast<MixedWorkload*>(benchmarks[i].test);
+			if(mixed && !mixed->SetProfile(parser.value(mixOption))) {
+				std::cerr << "Invalid workload profile " << qPrintable(parser.value(mixOption)) << "." << std::endl;
+				exitCode = 1;
+				return false;
+			}
+		}
+	}
+
+	// range has to hold the biggest block of every benchmark run at random positions
+	for(int i = 0; parser.isSet(rangeOption) && (i < queue.size()); ++i) {
+		Benchmark *test = benchmarks[queue[i]].test;
+		if((test->GetRandomBlock() > 0) && (test->GetOffsets(test->GetRandomBlock()).Count() == 0)) {
+			std::cerr << "Invalid LBA range " << qPrintable(parser.value(rangeOption)) << " for " <<
+					qPrintable(benchmarks[queue[i]].name) << "." << std::endl;
+			exitCode = 1;
+			return false;
+		}
+	}
+
+	if(queue.isEmpty()) {
+		std::cerr << "No benchmark can be run on " << qPrintable(device.path) << "." << std::endl;
+		exitCode = 1;
+		return false;
+	}
+
+	std::cout << "Device: " << qPrintable(device.path) << " " << qPrintable(device.model) <<
+			" " << qPrintable(Def::FormatSize(device.size)) << std::endl;
+
+	// benchmarks are started once event loop runs
+	QTimer::singleShot(0, this, SLOT(RunNext()));
+	return true;
+}
+
+void CommandLine::ListBenchmarks() {
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		const Item &benchmark = benchmarks[i];
+		std::cout << qPrintable(benchmark.name) << " - " << qPrintable(benchmark.test->testName);
+		if(benchmark.kind == DESTRUCTIVE) {
+			std::cout << " (destroys data)";
+		} else if(benchmark.kind == MIXED) {
+			std::cout << " (destroys data without filesystem)";
+		}
+		std::cout << std::endl;
+
+		QStringList modes = benchmark.test->GetModes();
+		for(int j = 0; j < modes.size(); ++j) {
+			std::cout << "\t" << j << ": " << qPrintable(modes[j]) << std::endl;
+		}
+	}
+}
+
+bool CommandLine::OpenDevice(QString path) {
+	QString canonical = QFileInfo(path).canonicalFilePath();
+	if(canonical.isEmpty()) {
+		return false;
+	}
+
+	// prefer mounted filesystem so filesystem benchmarks are available
+	Device::Item item(Device::Item::Type::DEVICE, canonical);
+	QList<QStorageInfo> volumes = QStorageInfo::mountedVolumes();
+	for(int i = 0; i < volumes.size(); ++i) {
+		if(!volumes[i].isValid() || !volumes[i].isReady()) {
+			continue;
+		}
+
+		if((volumes[i].rootPath() == canonical) ||
+				(QFileInfo(QString::fromLocal8Bit(volumes[i].device())).canonicalFilePath() == canonical)) {
+			item = Device::Item(volumes[i]);
+			break;
+		}
+	}
+
+	device.Open(item, true);
+
+	return device.size > 0;
+}
+
+bool CommandLine::Applicable(const Item &benchmark, QString &reason) {
+	switch(benchmark.kind) {
+	case FILESYSTEM:
+		reason = "no filesystem mounted";
+		return device.fs;
+	case MIXED:
+		if(device.fs) {
+			return true;
+		}
+		// raw device is overwritten
+		[[fallthrough]];
+	case DESTRUCTIVE:
+		if(!destroyData) {
+			reason = "--destroy-data not given";
+			return false;
+		}
+		reason = "device is mounted or used";
+		return !device.fs && !device.IsMounted();
+	default:
+		return true;
+	}
+}
+
+void CommandLine::RunNext() {
+	if(queue.isEmpty()) {
+		Finish();
+		return;
+	}
+
+	current = queue.takeFirst();
+	Item &benchmark = benchmarks[current];
+
+	// device stays open for writing until benchmark finishes
+	bool writes = (benchmark.kind == DESTRUCTIVE) || ((benchmark.kind == MIXED) && !device.fs);
+	benchmark.test->SetDestructive(writes);
+	if(writes && !device.SetWritable(true)) {
+		std::cerr << "Cannot open " << qPrintable(device.path) << " for exclusive writing." << std::endl;
+		exitCode = 1;
+		Finish();
+		return;
+	}
+
+	benchmark.test->directIO = direct && (benchmark.kind != FILESYSTEM);
+	benchmark.test->StartTest();
+
+	progress_timer.start(1000);
+	progress_timer_timeout();
+}
+
+void CommandLine::Finish() {
+	progress_timer.stop();
+	current = -1;
+
+	if(!WriteResultFile()) {
+		std::cerr << "Cannot write results to " << qPrintable(output) << "." << std::endl;
+		exitCode = 1;
+	} else {
+		std::cout << "Results saved to " << qPrintable(output) << std::endl;
+		if(store) {
+			StoreResultFile();
+		}
+	}
+
+	QCoreApplication::exit(exitCode);
+}
+
+bool CommandLine::WriteResultFile() {
+	QFile file(output);
+	if(!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+
+	// results are streamed to file, format is selected by suffix
+	QScopedPointer<ResultWriter> writer(ResultWriter::Create(&file, output));
+	writer->StartDocument();
+
+	// Create base element
+	writer->StartElement("Results");
+	writer->Attribute("timeunit", "ns");
+
+	// save drive info
+	device.WriteInfo(*writer);
+
+	// save tests results
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		benchmarks[i].test->WriteResults(*writer);
+	}
+
+	writer->EndDocument();
+	file.close();
+
+	return file.error() == QFileDevice::NoError;
+}
+
+bool CommandLine::ConvertResultFile(QString input) {
+	ResultFile results;
+	if(!results.Open(input)) {
+		std::cerr << "Cannot read " << qPrintable(input) << ": " << qPrintable(results.Error()) << std::endl;
+		return false;
+	}
+
+	QFile file(output);
+	if(!file.open(QIODevice::WriteOnly)) {
+		std::cerr << "Cannot write results to " << qPrintable(output) << "." << std::endl;
+		return false;
+	}
+
+	// elements are copied as they are, format is selected by suffix
+	QScopedPointer<ResultWriter> writer(ResultWriter::Create(&file, output));
+	writer->StartDocument();
+	results.Write(*writer);
+	writer->EndDocument();
+	file.close();
+
+	return file.error() == QFileDevice::NoError;
+}
+
+bool CommandLine::StoreResultFile() {
+	ResultStore resultStore;
+	if(!resultStore.Open()) {
+		std::cerr << "Cannot open result store " << qPrintable(resultStore.Directory()) << "." << std::endl;
+		return false;
+	}
+
+	QString stored = resultStore.Add(output);
+	if(stored.isEmpty()) {
+		std::cerr << "Cannot add " << qPrintable(output) << " to result store." << std::endl;
+		return false;
+	}
+	std::cout << "Results stored as " << qPrintable(stored) << std::endl;
+
+	return true;
+}
+
+bool CommandLine::QueryStore(const QStringList &query, QList<ResultStore::Entry> &entries) {
+	QString model, serial, firmware, kernel;
+	for(int i = 0; i < query.size(); ++i) {
+		QString key = query[i].section('=', 0, 0);
+		QString value = query[i].section('=', 1);
+		if(key == "model") {
+			model = value;
+		} else if(key == "serial") {
+			serial = value;
+		} else if(key == "firmware") {
+			firmware = value;
+		} else if(key == "kernel") {
+			kernel = value;
+		} else {
+			std::cerr << "Unknown query key " << qPrintable(key) << ", use model, serial, firmware or kernel." << std::endl;
+			return false;
+		}
+	}
+
+	ResultStore resultStore;
+	if(!resultStore.Open()) {
+		std::cerr << "Cannot open result store " << qPrintable(resultStore.Directory()) << "." << std::endl;
+		return false;
+	}
+	entries = resultStore.Find(model, serial, firmware, kernel);
+
+	return true;
+}
+
+bool CommandLine::CompareResultFiles(const QStringList &files) {
+	if(files.size() < 2) {
+		std::cerr << "At least two results have to be given for comparison." << std::endl;
+		return false;
+	}
+
+	Comparison comparison;
+	for(int i = 0; i < files.size(); ++i) {
+		if(!comparison.Add(files[i], QFileInfo(files[i]).fileName())) {
+			std::cerr << "Cannot read " << qPrintable(files[i]) << ", result is skipped." << std::endl;
+		}
+	}
+	std::cout << qPrintable(comparison.Report()) << std::flush;
+
+	return true;
+}
+
+void CommandLine::progress_timer_timeout() {
+	if(current < 0) {
+		return;
+	}
+
+	Item &benchmark = benchmarks[current];
+	std::cout << "\r" << qPrintable(benchmark.test->testName) << ": " <<
+			benchmark.test->GetProgress() << "%" << std::flush;
+
+	// print summary once benchmark thread has finished
+	if(benchmark.test->testState == Benchmark::STOPPED) {
+		std::cout << std::endl << "\t" << qPrintable(benchmark.test->GetSummary().replace("\n", "\n\t")) << std::endl;
+
+		// report when throughput settled
+		const Sampler &sampler = benchmark.test->sampler;
+		int steady = sampler.SteadyState();
+		if(steady >= 0) {
+			std::cout << "\tSteady state after " <<
+					qPrintable(Def::FormatTime((steady > 0)?sampler.samples[steady - 1].time:0)) << std::endl;
+		}
+
+		// report what kernel block layer did meanwhile
+		if(sampler.blockStats.IsValid()) {
+			std::cout << "\tBlock layer " << qPrintable(sampler.blockStats.Summary()) << std::endl;
+		}
+
+		// report integrity of written data, mismatch fails the run
+		const Verifier &verifier = benchmark.test->verifier;
+		if(verifier.IsValid()) {
+			std::cout << "\tVerify " << qPrintable(verifier.Summary().replace("\n", "\n\t")) << std::endl;
+			if(verifier.mismatch_count > 0) {
+				exitCode = 1;
+			}
+		}
+		progress_timer.stop();
+		RunNext();
+	}
+}
+
+void CommandLine::device_accessWarning() {
+	std::cerr << "WARNING: insufficient rights to access device, results may be incorrect." << std::endl;
+}
+
+void CommandLine::device_operationError() {
+	if(current < 0) {
+		return;
+	}
+
+	// stop running benchmark, its summary is printed when it stops
+	std::cerr << std::endl << "I/O operation failed in " << qPrintable(benchmarks[current].test->testName) <<
+			", benchmark is stopped." << std::endl;
+	exitCode = 1;
+	if(benchmarks[current].test->testState == Benchmark::STARTED) {
+		benchmarks[current].test->StopTest();
+	}
+}
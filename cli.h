@@ -0,0 +1,91 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QStringList>
+
+#include "device.h"
+#include "resultstore.h"
+#include "benchmark.h"
+
+/// Runs benchmarks without graphical user interface
+/** CommandLine class drives the same benchmark classes as the main window
+but it is controlled by command line arguments. Benchmarks are run one by one
+on selected device, progress and summary of every benchmark are printed to
+standard output and results are stored to the same result file as the one
+saved by the main window. Only benchmark classes without their widgets are
+used, so the runner works on machines without display. **/
+class CommandLine : public QObject {
+	Q_OBJECT
+
+public:
+	CommandLine(QObject *parent = 0);	/// Creates all benchmarks
+	~CommandLine();
+
+	/** Parse arguments and start selected benchmarks
+	  @param arguments command line arguments
+	  @return false when there is nothing to run, exit code is set in such case **/
+	bool Start(const QStringList &arguments);
+
+	int exitCode;	/// Process exit code, non-zero when some benchmark failed
+
+private:
+	/// Kind of benchmark, determines devices it can be run on
+	enum Kind { RAW, FILESYSTEM, DESTRUCTIVE, MIXED };
+
+	/// One benchmark known to runner
+	struct Item {
+		QString name;		/// Name used on command line
+		Kind kind;			/// Benchmark kind
+		Benchmark *test;	/// Benchmark itself
+	};
+
+	void AddBenchmark(QString name, Kind kind, Benchmark *test);	/// Register benchmark
+	void ListBenchmarks();				/// Print benchmarks and their modes
+	bool OpenDevice(QString path);		/// Open device, partition or device with mount point
+	bool Applicable(const Item &benchmark, QString &reason);	/// Whenever benchmark can run on device
+	void Finish();						/// Write results and quit
+	bool WriteResultFile();				/// Store results of all benchmarks
+	bool ConvertResultFile(QString input);	/// Copy result file to output in other format
+	bool StoreResultFile();				/// Add written result file to result store
+	bool QueryStore(const QStringList &query, QList<ResultStore::Entry> &entries);	/// Find stored results
+	bool CompareResultFiles(const QStringList &files);	/// Print comparison of results
+
+	QList<Item> benchmarks;			// all benchmarks in result file order
+	QList<int> queue;				// benchmarks waiting to be run
+	int current;					// running benchmark or -1
+
+	Device device;
+	QString output;
+	bool direct;
+	bool destroyData;
+	bool store;
+
+	QTimer progress_timer;
+
+private slots:
+	void RunNext();		/// Start next queued benchmark or finish
+	void progress_timer_timeout();
+	void device_accessWarning();
+	void device_operationError();
+};
@@ -0,0 +1,141 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "comparedialog.h"
+#include "comparison.h"
+
+#include <QFileDialog>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+CompareDialog::CompareDialog(QWidget *parent):
+	QDialog(parent) {
+	setWindowTitle("Compare results");
+	resize(900, 600);
+
+	filter = new QLineEdit();
+	filter->setPlaceholderText("Filter by model, serial, firmware or kernel");
+	list = new QListWidget();
+	import = new QPushButton("Import...");
+	reference = new QPushButton("Use as reference");
+	compare = new QPushButton("Compare");
+	report = new QPlainTextEdit();
+	report->setReadOnly(true);
+	report->setLineWrapMode(QPlainTextEdit::NoWrap);
+	report->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+	QHBoxLayout *buttons = new QHBoxLayout();
+	buttons->addWidget(import);
+	buttons->addStretch();
+	buttons->addWidget(reference);
+	buttons->addWidget(compare);
+
+	QWidget *results = new QWidget();
+	QVBoxLayout *resultsLayout = new QVBoxLayout(results);
+	resultsLayout->setContentsMargins(0, 0, 0, 0);
+	resultsLayout->addWidget(filter);
+	resultsLayout->addWidget(list);
+	resultsLayout->addLayout(buttons);
+
+	QSplitter *splitter = new QSplitter(Qt::Vertical);
+	splitter->addWidget(results);
+	splitter->addWidget(report);
+
+	QVBoxLayout *layout = new QVBoxLayout(this);
+	layout->addWidget(splitter);
+
+	connect(filter, SIGNAL(textChanged(QString)), this, SLOT(filter_textChanged(QString)));
+	connect(import, SIGNAL(clicked()), this, SLOT(import_clicked()));
+	connect(reference, SIGNAL(clicked()), this, SLOT(reference_clicked()));
+	connect(compare, SIGNAL(clicked()), this, SLOT(compare_clicked()));
+
+	Refresh();
+}
+
+void CompareDialog::Refresh() {
+	if(!store.Open()) {
+		report->setPlainText("Cannot open result store " + store.Directory());
+	}
+	entries = store.Find();
+
+	list->clear();
+	for(int i = 0; i < entries.size(); ++i) {
+		QListWidgetItem *item = new QListWidgetItem(entries[i].Label(), list);
+		item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+		item->setCheckState(Qt::Unchecked);
+	}
+	filter_textChanged(filter->text());
+}
+
+void CompareDialog::filter_textChanged(QString text) {
+	for(int i = 0; i < list->count(); ++i) {
+		list->item(i)->setHidden(!list->item(i)->text().contains(text, Qt::CaseInsensitive));
+	}
+}
+
+void CompareDialog::import_clicked() {
+	QStringList files = QFileDialog::getOpenFileNames(this, "Import results", "", "Results (*.hddtest *.hddbin)");
+	for(int i = 0; i < files.size(); ++i) {
+		if(store.Add(files[i]).isEmpty()) {
+			QMessageBox::warning(this, "Import results", "Cannot import " + files[i]);
+		}
+	}
+	Refresh();
+}
+
+void CompareDialog::reference_clicked() {
+	// reference is shown in bold and it is always compared
+	for(int i = 0; i < list->count(); ++i) {
+		QFont font = list->item(i)->font();
+		font.setBold(list->item(i) == list->currentItem());
+		list->item(i)->setFont(font);
+		if(list->item(i) == list->currentItem()) {
+			list->item(i)->setCheckState(Qt::Checked);
+		}
+	}
+}
+
+void CompareDialog::compare_clicked() {
+	Comparison comparison;
+	QString failed;
+	for(int i = 0; i < list->count(); ++i) {
+		QListWidgetItem *item = list->item(i);
+		if((item->checkState() != Qt::Checked) || item->isHidden()) {
+			continue;
+		}
+		int index = comparison.Count();
+		if(!comparison.Add(entries[i].file, entries[i].Label())) {
+			failed += "Cannot read " + entries[i].file + "\n";
+			continue;
+		}
+		if(item->font().bold()) {
+			comparison.SetReference(index);
+		}
+	}
+
+	if(comparison.Count() < 2) {
+		report->setPlainText(failed + "Check at least two results to compare.");
+		return;
+	}
+	report->setPlainText(failed + comparison.Report());
+}
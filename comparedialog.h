@@ -0,0 +1,60 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QPushButton>
+
+#include "resultstore.h"
+
+/// Dialog comparing results from result store
+/** CompareDialog lists results kept in ResultStore, the list can be narrowed
+by text matching drive model, serial number, firmware or kernel. Checked
+results are compared by Comparison class and its report is shown in the
+dialog. Current item can be selected as reference of comparison. **/
+class CompareDialog : public QDialog {
+	Q_OBJECT
+
+public:
+	explicit CompareDialog(QWidget *parent = 0);
+
+private:
+	void Refresh();		// reload store and list
+
+	ResultStore store;
+	QList<ResultStore::Entry> entries;
+
+	QLineEdit *filter;
+	QListWidget *list;
+	QPushButton *import;
+	QPushButton *reference;
+	QPushButton *compare;
+	QPlainTextEdit *report;
+
+private slots:
+	void filter_textChanged(QString text);
+	void import_clicked();
+	void reference_clicked();
+	void compare_clicked();
+};
@@ -0,0 +1,200 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "comparison.h"
+#include "resultfile.h"
+#include "statistics.h"
+#include "filerw.h"
+#include "filestructure.h"
+#include "mixedworkload.h"
+#include "readblock.h"
+#include "readcont.h"
+#include "readrnd.h"
+#include "readthreads.h"
+#include "seeker.h"
+#include "smallfiles.h"
+#include "writeblock.h"
+#include "writecont.h"
+#include "writernd.h"
+
+#include <algorithm>
+#include <cmath>
+
+Comparison::Comparison():
+	reference(-1) {
+	// benchmarks in order of main window tabs
+	benchmarks.append(new ReadRnd());
+	benchmarks.append(new ReadThreads());
+	benchmarks.append(new ReadCont());
+	benchmarks.append(new ReadBlock());
+	benchmarks.append(new Seeker());
+	benchmarks.append(new WriteCont());
+	benchmarks.append(new WriteBlock());
+	benchmarks.append(new WriteRnd());
+	benchmarks.append(new FileRW());
+	benchmarks.append(new FileStructure());
+	benchmarks.append(new SmallFiles());
+	benchmarks.append(new MixedWorkload());
+
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		benchmarks[i]->SetDevice(&device);
+	}
+}
+
+Comparison::~Comparison() {
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		delete benchmarks[i];
+	}
+}
+
+bool Comparison::Add(QString filename, QString label) {
+	ResultFile file;
+	if(!file.Open(filename)) {
+		return false;
+	}
+
+	int result = labels.size();
+	labels.append(label);
+	for(int i = 0; i < rows.size(); ++i) {
+		rows[i].values.append(NAN);
+	}
+
+	// restore results one benchmark at a time and keep only their metrics
+	ResultElement root = file.Root();
+	device.ReadInfo(root);
+	for(int i = 0; i < benchmarks.size(); ++i) {
+		benchmarks[i]->EraseResults(Benchmark::RESULTS);
+		benchmarks[i]->RestoreResults(root, Benchmark::RESULTS);
+
+		QList<Benchmark::Metric> metrics = benchmarks[i]->GetMetrics();
+		for(int j = 0; j < metrics.size(); ++j) {
+			int index = FindRow(benchmarks[i]->testName, metrics[j].name);
+			if(index < 0) {
+				Row row;
+				row.benchmark = benchmarks[i]->testName;
+				row.name = metrics[j].name;
+				row.unit = metrics[j].unit;
+				row.higher = metrics[j].higher;
+				row.values.fill(NAN, labels.size());
+				index = rows.size();
+				rows.append(row);
+			}
+			rows[index].values[result] = metrics[j].value;
+		}
+		benchmarks[i]->EraseResults(Benchmark::RESULTS);
+	}
+
+	return true;
+}
+
+void Comparison::SetReference(int index) {
+	reference = index;
+}
+
+int Comparison::Count() const {
+	return labels.size();
+}
+
+QString Comparison::Report(qreal threshold) const {
+	QString report;
+
+	// result legend, table columns use only result numbers
+	for(int i = 0; i < labels.size(); ++i) {
+		report += QString("#%1%2 %3\n").arg(i + 1).arg((i == reference)?"*":" ").arg(labels[i]);
+	}
+	report += (reference < 0)?"Values are relative to median of all results.\n":"Values are relative to result marked by *.\n";
+
+	int regressions = 0;
+	QString benchmark;
+	for(int i = 0; i < rows.size(); ++i) {
+		const Row &row = rows[i];
+		if(row.benchmark != benchmark) {
+			benchmark = row.benchmark;
+			report += "\n" + benchmark + "\n";
+		}
+
+		Statistics stats;
+		for(int j = 0; j < row.values.size(); ++j) {
+			if(!std::isnan(row.values[j])) {
+				stats.Add(row.values[j]);
+			}
+		}
+
+		report += QString("  %1 [%2] mean %3 dev %4 min %5 max %6\n")
+				.arg(row.name).arg(row.unit)
+				.arg(stats.Mean(), 0, 'f', 2).arg(stats.Deviation(), 0, 'f', 2)
+				.arg(stats.Min(), 0, 'f', 2).arg(stats.Max(), 0, 'f', 2);
+
+		// values relative to reference
+		qreal ref = Reference(row);
+		for(int j = 0; j < row.values.size(); ++j) {
+			report += QString("    #%1 ").arg(j + 1, -3);
+			if(std::isnan(row.values[j])) {
+				report += "NO DATA\n";
+				continue;
+			}
+
+			qreal diff = (ref != 0)?(row.values[j] - ref) / ref:0;
+			bool worse = row.higher?(diff < -threshold):(diff > threshold);
+			report += QString("%1 %2%3%").arg(row.values[j], 12, 'f', 2)
+					.arg((diff >= 0)?"+":"").arg(diff * 100, 0, 'f', 1);
+			if(worse) {
+				report += "  REGRESSION";
+				++regressions;
+			}
+			report += "\n";
+		}
+	}
+
+	report += QString("\n%1 values worse than reference by more than %2%.\n").arg(regressions).arg(threshold * 100);
+
+	return report;
+}
+
+int Comparison::FindRow(QString benchmark, QString name) const {
+	for(int i = 0; i < rows.size(); ++i) {
+		if((rows[i].benchmark == benchmark) && (rows[i].name == name)) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+qreal Comparison::Reference(const Row &row) const {
+	if((reference >= 0) && (reference < row.values.size()) && !std::isnan(row.values[reference])) {
+		return row.values[reference];
+	}
+
+	// median of results containing the metric
+	QVector<qreal> values;
+	for(int i = 0; i < row.values.size(); ++i) {
+		if(!std::isnan(row.values[i])) {
+			values.append(row.values[i]);
+		}
+	}
+	if(values.isEmpty()) {
+		return NAN;
+	}
+	std::sort(values.begin(), values.end());
+	int half = values.size() / 2;
+
+	return (values.size() % 2)?values[half]:(values[half - 1] + values[half]) / 2;
+}
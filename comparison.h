@@ -0,0 +1,79 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+
+#include "device.h"
+#include "benchmark.h"
+
+/// Compares main numbers of many results
+/** Comparison loads any count of result files into its own hidden benchmark
+instances and collects metrics reported by their GetMetrics method. Report
+then prints table per benchmark with summary statistics of every metric
+across all results and value of every result relative to the reference,
+which is median of all results unless reference result is selected. Results
+worse than reference by more than given threshold are marked, so regression
+of one drive among drives of the same model is easy to spot. **/
+class Comparison {
+public:
+	Comparison();	/// Creates all benchmarks
+	~Comparison();
+
+	/** Loads metrics of result file
+	  @param filename result file
+	  @param label result name used in report
+	  @return false when file cannot be read **/
+	bool Add(QString filename, QString label);
+
+	/** Selects result all other results are compared to
+	  @param index result index or -1 for median of all results **/
+	void SetReference(int index);
+
+	int Count() const;	/// Count of added results
+
+	/** Builds text report
+	  @param threshold relative difference from reference reported as regression
+	  @return report as fixed width text table **/
+	QString Report(qreal threshold = 0.1) const;
+
+private:
+	/// Values of one metric in all results
+	struct Row {
+		QString benchmark;		/// Benchmark name
+		QString name;			/// Metric name
+		QString unit;			/// Metric unit
+		bool higher;			/// Whenever higher value is better
+		QVector<qreal> values;	/// Value per result, NaN when result does not contain it
+	};
+
+	int FindRow(QString benchmark, QString name) const;
+	qreal Reference(const Row &row) const;	// reference value of row
+
+	Device device;
+	QList<Benchmark*> benchmarks;
+	QStringList labels;
+	QList<Row> rows;	// in benchmark and metric order of first result containing them
+	int reference;
+};
@@ -0,0 +1,134 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "datapattern.h"
+#include "randomgenerator.h"
+
+#include <atomic>
+#include <string.h>
+
+/// Stamps of all writes, shared by devices, their clones and files
+static std::atomic<quint64> stamps(0);
+
+DataPattern::DataPattern(Kind kind, int percent):
+	kind(kind), percent(percent) {}
+
+bool DataPattern::Duplicate(quint64 chunk, quint64 decision) const {
+	// the first chunk is source of copies, decision is drawn from own stream
+	return (kind == DEDUPABLE) && (chunk > 0) && ((int)(decision % 100) < percent);
+}
+
+void DataPattern::Fill(char *buffer, hddsize size) const {
+	if(kind == ZEROS) {
+		memset(buffer, 0, size);
+		return;
+	}
+
+	// random content by whole words
+	RandomGenerator random;
+	quint64 *words = (quint64*)buffer;
+	hddsize count = size / sizeof(quint64);
+	for(hddsize i = 0; i < count; ++i) {
+		words[i] = random.Next();
+	}
+	for(hddsize i = count * sizeof(quint64); i < size; ++i) {
+		buffer[i] = random.Next();
+	}
+
+	if(kind == COMPRESSIBLE) {
+		// zero the end of every chunk
+		hddsize zeros = CHUNK * percent / 100;
+		for(hddsize chunk = 0; chunk < size; chunk += CHUNK) {
+			hddsize end = qMin(chunk + CHUNK, size);
+			hddsize begin = qMax(chunk, end - zeros);
+			memset(buffer + begin, 0, end - begin);
+		}
+	} else if(kind == DEDUPABLE) {
+		RandomGenerator decisions(RandomGenerator::DEFAULT_SEED, 1);
+		for(hddsize chunk = 0; chunk < size; chunk += CHUNK) {
+			if(Duplicate(chunk / CHUNK, decisions.Next())) {
+				memcpy(buffer + chunk, buffer, qMin((hddsize)CHUNK, size - chunk));
+			}
+		}
+	}
+}
+
+void DataPattern::Scramble(char *buffer, hddsize size) const {
+	// zeros and zero parts of chunks stay untouched
+	if((kind == ZEROS) || ((kind == COMPRESSIBLE) && (percent >= 100))) {
+		return;
+	}
+	quint64 stamp = stamps.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	// the first chunk and its copies stay as filled, decisions follow Fill
+	RandomGenerator decisions(RandomGenerator::DEFAULT_SEED, 1);
+	for(hddsize chunk = 0; chunk + (hddsize)sizeof(quint64) <= size; chunk += CHUNK) {
+		quint64 decision = decisions.Next();
+		if((kind != DEDUPABLE) || ((chunk > 0) && !Duplicate(chunk / CHUNK, decision))) {
+			memcpy(buffer + chunk, &stamp, sizeof(quint64));
+		}
+	}
+}
+
+QString DataPattern::Name() const {
+	switch(kind) {
+	case RANDOM:
+		return "random";
+	case ZEROS:
+		return "zeros";
+	case COMPRESSIBLE:
+		return "compressible:" + QString::number(percent);
+	case DEDUPABLE:
+		return "dedupable:" + QString::number(percent);
+	}
+
+	return "";
+}
+
+bool DataPattern::Parse(QString name, DataPattern &pattern) {
+	QString kind = name.section(':', 0, 0);
+	bool ok = true;
+	int percent = name.contains(':')?name.section(':', 1).toInt(&ok):0;
+	if(!ok || (percent < 0) || (percent > 100)) {
+		return false;
+	}
+
+	if((kind == "random") && !name.contains(':')) {
+		pattern = DataPattern(RANDOM);
+	} else if((kind == "zeros") && !name.contains(':')) {
+		pattern = DataPattern(ZEROS);
+	} else if(kind == "compressible") {
+		pattern = DataPattern(COMPRESSIBLE, name.contains(':')?percent:50);
+	} else if(kind == "dedupable") {
+		pattern = DataPattern(DEDUPABLE, name.contains(':')?percent:50);
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+bool DataPattern::operator==(const DataPattern &other) const {
+	return (kind == other.kind) && (percent == other.percent);
+}
+
+bool DataPattern::operator!=(const DataPattern &other) const {
+	return !(*this == other);
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+#include "definitions.h"
+
+using namespace HDDTest;
+
+/// Generates content of written data
+/** Drives and filesystems with compression or deduplication write zeros or
+repeated blocks much faster than real data, so content of benchmark writes
+has to be chosen. DataPattern fills operation buffers once when they are
+allocated, by whole 64 bit words, and Scramble only stamps every chunk
+before each write, so buffer reuse does not turn into duplicates and data
+generation stays out of measured operations. **/
+class DataPattern {
+public:
+	/// Kinds of content
+	enum Kind {
+		RANDOM,			/// Incompressible random data
+		ZEROS,			/// Zero filled data
+		COMPRESSIBLE,	/// Every chunk is random for its part and zeros for percent of it
+		DEDUPABLE		/// Percent of chunks are copies of the first chunk
+	};
+
+	static const hddsize CHUNK = 4 * K;	/// Unit of compression and deduplication
+
+	/** Creates pattern
+	  @param kind kind of content
+	  @param percent compressible share of chunk or share of duplicate chunks **/
+	DataPattern(Kind kind = RANDOM, int percent = 0);
+
+	/** Fill buffer with pattern, done once when buffer is allocated
+	  @param buffer buffer aligned to 8 bytes
+	  @param size buffer size **/
+	void Fill(char *buffer, hddsize size) const;
+
+	/** Make chunks of filled buffer unique before write, every call stamps
+	  chunks by value unique for all buffers of the process
+	  @param buffer buffer filled by Fill
+	  @param size size of write **/
+	void Scramble(char *buffer, hddsize size) const;
+
+	QString Name() const;	/// Pattern name stored with results, the same as Parse accepts
+
+	/** Parse pattern name: random, zeros, compressible:percent or dedupable:percent
+	  @param name pattern name
+	  @param pattern receives parsed pattern
+	  @return false when name is not valid **/
+	static bool Parse(QString name, DataPattern &pattern);
+
+	bool operator==(const DataPattern &other) const;
+	bool operator!=(const DataPattern &other) const;
+
+	Kind kind;		/// Kind of content
+	int percent;	/// Compressible share of chunk or share of duplicate chunks
+
+private:
+	bool Duplicate(quint64 chunk, quint64 decision) const;	// whenever chunk is copy of the first one
+};
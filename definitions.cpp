@@ -19,6 +19,7 @@
 ********************************************************************************/
 
 #include "definitions.h"
+#include "resultfile.h"
 
 using namespace HDDTest;
 
@@ -89,3 +90,47 @@ QString Def::FormatSpeed(hddsize size) {
 
 	return value + unit;
 }
+
+/// Time interval to human readable format convertor
+QString Def::FormatTime(hddtime time) {
+	QString value;
+	QString unit;
+
+	// get string representation of value
+	if((time >= ms) && (time < s)) {
+		// return time in miliseconds
+		value = QString::number((qreal)time / ms);
+		unit = "ms";
+	} else if(time >= s) {
+		// return time in seconds
+		value = QString::number((qreal)time / s);
+		unit = "s";
+	} else if(time >= us) {
+		// return time in microseconds
+		value = QString::number((qreal)time / us);
+		unit = "us";
+	} else {
+		// default return time in nanoseconds
+		value = QString::number((qreal)time / ns);
+		unit = "ns";
+	}
+
+	// trim to 2 digits
+	int dotpos = value.lastIndexOf(".");
+	if(dotpos > 0) {
+		value.truncate(dotpos + 3);
+	}
+
+	return value + unit;
+}
+
+/// Unit of times stored in results file
+hddtime Def::StoredTimeUnit(const ResultElement &element) {
+	QString unit = element.Root().Attribute("timeunit", "us");
+	if(unit == "ns") {
+		return ns;
+	}
+
+	// older files stored microseconds
+	return us;
+}
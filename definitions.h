@@ -27,10 +27,11 @@
  * and random number generator called RandomGenerator. Basic primitives used by benchmarks were
  *  also moved to separated classes for file and device access called File and Device.
  *
- * Every benchmark has its own class which covers both benchmarks GUI and benchmark
- *  process itself. Benchmark classes are based on a class common to all benchmarks.
- *  The class is called TestWidget. It handles GUI elements that are common to all benchmarks,
- *  graph drawing and benchmark state changes.
+ * Every benchmark has its own class which covers benchmark process and its results and
+ *  a widget class which shows them. Benchmark classes are based on a class common to all
+ *  benchmarks called Benchmark. It handles benchmark state changes and runs the test thread.
+ *  Widgets are based on TestWidget class. It handles GUI elements that are common to all
+ *  benchmarks and graph drawing. Command line application uses benchmark classes only.
  *
  * There are more helper classes described in generated Doxygen documentation that are not
  *  important to understand basic principles of the application.
@@ -59,24 +60,26 @@
  *  could also help when low-level access code needs to be changed because of bugs. Also the
  *  benchmark functions are much more simple when not including time measurement calls.
  *
- * \subsection testwidgetclass TestWidget class
- * TestWidget class implements common code from all benchmarks and graph drawing code.
- * This class has three basic functions. The first one is to provide callback to benchmark GUI elements.
- *  The second one is to start and stop the test in separate thread. The third is to provide graph drawing.
+ * \subsection testwidgetclass Benchmark and TestWidget classes
+ * Benchmark class implements common code from all benchmarks. It starts and stops the test
+ *  in separate thread and keeps benchmark settings. TestWidget class owns one benchmark,
+ *  provides callback to benchmark GUI elements and provides graph drawing.
  *
- * The actual benchmarks are classes derived from TestWidget class which implement a few methods
+ * The actual benchmarks are classes derived from Benchmark class which implement a few methods
  *  specific to them. When benchmark is started a benchmark specific method containing benchmarking
- *  code is run in separate thread and another benchmark specific method is called periodically
+ *  code is run in separate thread and widget specific method is called periodically
  *  to redraw the results in graph. The graph drawing method uses basic graph parts provided by base
  *  TestWiget class such as Bar graph, Line Graph and more support elements.
  *
  * \subsection benchmarkspecificclasses Benchmark specific classes
- * Every benchmark has its own class that contains its GUI handling and benchmark function.
+ * Every benchmark has its own class that contains its benchmark function.
  *  Benchmark class also defines class that holds results in benchmark specific way. This class is
- *  based on TestWidget class. Benchmark class implements several virtual methods defined by TestWidget.
+ *  based on Benchmark class and implements several virtual methods defined by it.
  *  These methods define benchmark specific behaviour. Every benchmark defines TestLoop method which
- *  contains benchmark code. InitScene, UpdateScene and GetProgress methods that handles GUI specific things.
+ *  contains benchmark code, GetProgress and GetSummary methods that report its state.
  *  And WriteResults, RestoreResults and EraseResults to handle results in benchmark specific way.
+ *  Widget of every benchmark is based on TestWidget class and defines InitScene and UpdateScene
+ *  methods that handle GUI specific things.
  *
  * \section building Building
  *
@@ -89,10 +92,12 @@
 
 #include<QtCore>
 
+class ResultElement;
+
 namespace HDDTest {
 	class Def;
 
-	typedef qint64 hddtime; /// time interval in microseconds
+	typedef qint64 hddtime; /// time interval in nanoseconds
 	typedef qint64 hddsize; /// size on drive in bytes
 
 	// size units
@@ -102,7 +107,8 @@ namespace HDDTest {
 	static const hddsize G = 1024 * M;
 
 	// time units
-	static const hddtime us = 1;
+	static const hddtime ns = 1;
+	static const hddtime us = 1000 * ns;
 	static const hddtime ms = 1000 * us;
 	static const hddtime s	= 1000 * ms;
 
@@ -111,5 +117,11 @@ namespace HDDTest {
 	public:
 		static QString FormatSize(hddsize size);	/// Size to human readable format convertor
 		static QString FormatSpeed(hddsize size);	/// Speed to human readable format convertor
+		static QString FormatTime(hddtime time);	/// Time interval to human readable format convertor
+
+		/** Gets unit of times stored in results file
+		  @param element any element of results document
+		  @return ns for current files, us for files saved before timeunit attribute existed **/
+		static hddtime StoredTimeUnit(const ResultElement &element);
 	};
 }
@@ -19,7 +19,9 @@
 ********************************************************************************/
 
 #include "device.h"
+#include "verifier.h"
 
+#include <errno.h>
 #include <iostream>
 #include <stdio.h>
 #include <iostream>
@@ -30,16 +32,29 @@ Device::Device() {
 	size = -1;
 	fs = false;
 	fd = 0;
+	direct = false;
+	writable = false;
+	cacheScope = CacheScope::FILES;
+	verifier = NULL;
+	transferred = 0;
+	block_size = DEFAULT_BLOCK_SIZE;
+	buffer = NULL;
+	buffer_size = 0;
+	write_buffer = NULL;
+	write_buffer_size = 0;
 }
 
 Device::~Device() {
 	Close();
+	ReleaseBuffer();
 }
 
 void Device::Close() {
 	// close device file
 	if(fd > 0)
 		close(fd);
+	direct = false;
+	writable = false;
 }
 
 QList<Device::Item> Device::GetDevices() {
@@ -54,6 +69,21 @@ QList<Device::Item> Device::GetDevices() {
         list.append(info);
 	}
 
+	// add block devices without filesystem mounted, only these can be written by raw tests
+	QStringList disks = QDir("/sys/block").entryList(QDir::NoDotAndDotDot | QDir::AllEntries);
+	for(int i = 0; i < disks.size(); ++i) {
+		// skip virtual devices with no media
+		QFile sizeFile("/sys/block/" + disks[i] + "/size");
+		if(!sizeFile.open(QFile::ReadOnly) || (sizeFile.readAll().trimmed().toLongLong() == 0)) {
+			continue;
+		}
+
+		QString path = "/dev/" + disks[i];
+		if(QFile::exists(path) && !IsMounted(path)) {
+			list.append(Item(Item::Type::DEVICE, path, path + " (not mounted)"));
+		}
+	}
+
 	return list;
 }
 
@@ -85,6 +115,15 @@ void Device::Open(Item item, bool close) {
 		ReportWarning();
 	}
 
+	// get logical block size used to align direct access
+	int lbs = 0;
+	if((ioctl(fd, BLKSSZGET, &lbs) < 0) || (lbs <= 0)) {
+		lbs = DEFAULT_BLOCK_SIZE;
+	}
+	block_size = lbs;
+	direct = false;
+	writable = false;
+
 	DropCaches();
 
 	// get drive size
@@ -96,30 +135,288 @@ void Device::Open(Item item, bool close) {
 	DriveInfo();
 }
 
+Device* Device::Clone() {
+	Device *clone = new Device();
+
+	// operations of clone are sampled with the benchmark
+	clone->timer.SetCounters(timer.GetCounters());
+
+	// copy device identification and geometry
+	clone->info = info;
+	clone->path = path;
+	clone->size = size;
+	clone->device_size = device_size;
+	clone->block_size = block_size;
+	clone->cacheScope = cacheScope;
+	clone->pattern = pattern;
+
+	// filesystem operations of clone use the same mount
+	clone->fs = fs;
+	clone->mountpoint = mountpoint;
+	clone->fstype = fstype;
+
+	// errors in clone are errors of this device
+	connect(clone, SIGNAL(operationError()), this, SIGNAL(operationError()));
+
+	// open own descriptor in the same access mode
+	clone->fd = open(path.toUtf8(), O_RDONLY | O_LARGEFILE | O_SYNC);
+	if(clone->fd < 0) {
+		// filesystem operations do not need raw device access
+		if(fs) {
+			ReportWarning();
+		} else {
+			ReportError();
+		}
+	} else {
+		clone->SetDirect(direct);
+	}
+
+	return clone;
+}
+
+bool Device::SetWritable(bool writable) {
+	if(writable == this->writable) {
+		return true;
+	}
+
+	// kernel refuses exclusive open of mounted or otherwise used block device
+	int flags = writable ? (O_RDWR | O_EXCL) : O_RDONLY;
+	int newfd = open(path.toUtf8(), flags | O_LARGEFILE | O_SYNC);
+	if(newfd < 0) {
+		std::cerr << "Cannot open device for writing" << std::endl;
+		return false;
+	}
+
+	// replace descriptor keeping access mode
+	bool wasDirect = direct;
+	close(fd);
+	fd = newfd;
+	direct = false;
+	if(wasDirect) {
+		SetDirect(true);
+	}
+	this->writable = writable;
+
+	SetPos(0);
+
+	return true;
+}
+
+bool Device::IsMounted() {
+	return IsMounted(path);
+}
+
+bool Device::IsMounted(QString path) {
+	QString device = QFileInfo(path).canonicalFilePath();
+	QString name = QFileInfo(device).fileName();
+	if(name.isEmpty()) {
+		return false;
+	}
+
+	// device used by device mapper, md raid and similar
+	if(!QDir("/sys/class/block/" + name + "/holders").entryList(QDir::NoDotAndDotDot | QDir::AllEntries).isEmpty()) {
+		return true;
+	}
+
+	// look for device or its partitions in mounts and swaps
+	QStringList tables;
+	tables << "/proc/mounts" << "/proc/swaps";
+	for(int i = 0; i < tables.size(); ++i) {
+		QFile table(tables[i]);
+		if(!table.open(QFile::ReadOnly | QIODevice::Text)) {
+			continue;
+		}
+
+		while(true) {
+			QString line = table.readLine();
+			if(line.length() == 0)
+				break;
+
+			QString source = line.section(' ', 0, 0);
+			if(!source.startsWith("/dev/")) {
+				continue;
+			}
+
+			QString used = QFileInfo(source).canonicalFilePath();
+			if(!used.compare(device) || QFile::exists("/sys/block/" + name + "/" + QFileInfo(used).fileName())) {
+				return true;
+			}
+		}
+		table.close();
+	}
+
+	return false;
+}
+
 void Device::DropCaches() {
-	// give advice to disable caching
+	// write back and evict pages of device, buffers of block device too
+	fdatasync(fd);
 	int ret = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
 	if(ret)
 		ReportWarning();
 
-	// empty caches
-	QFile caches("/proc/sys/vm/drop_caches");
-	caches.open(QIODevice::WriteOnly);
-	if(caches.isOpen()) {
-		caches.putChar('3');
-		caches.close();
-	} else {
+	struct stat64 st;
+	if((fstat64(fd, &st) == 0) && S_ISBLK(st.st_mode)) {
+		if(ioctl(fd, BLKFLSBUF, 0) < 0) {
+			ReportWarning();
+		}
+	}
+
+	// files benchmarks touched live in temp
+	if(fs) {
+		EvictFiles(mountpoint + "/hddtest.temp.dir");
+	}
+
+	switch(cacheScope) {
+	case CacheScope::FILES:
+		break;
+	case CacheScope::CGROUP:
+		ReclaimCgroup();
+		break;
+	case CacheScope::GLOBAL: {
+		// empty caches of all processes
+		QFile caches("/proc/sys/vm/drop_caches");
+		caches.open(QIODevice::WriteOnly);
+		if(caches.isOpen()) {
+			caches.putChar('3');
+			caches.close();
+		} else {
+			ReportWarning();
+		}
+		break;
+	}
+	}
+}
+
+void Device::EvictFiles(QString dir) {
+	QDirIterator it(dir, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+	while(it.hasNext()) {
+		int file = open(it.next().toUtf8(), O_RDONLY | O_LARGEFILE);
+		if(file < 0) {
+			continue;
+		}
+
+		// dirty pages cannot be dropped
+		fdatasync(file);
+		posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+		close(file);
+	}
+}
+
+void Device::ReclaimCgroup() {
+	// locate own cgroup v2 directory
+	QFile cgroups("/proc/self/cgroup");
+	QString group;
+	if(cgroups.open(QFile::ReadOnly | QIODevice::Text)) {
+		while(true) {
+			QString line = cgroups.readLine();
+			if(line.length() == 0)
+				break;
+
+			if(line.startsWith("0::")) {
+				group = "/sys/fs/cgroup" + line.mid(3).trimmed();
+				break;
+			}
+		}
+	}
+	if(group.isEmpty()) {
+		ReportWarning();
+		return;
+	}
+
+	// reclaim page cache and reclaimable slab charged to the cgroup
+	QFile stat(group + "/memory.stat");
+	qint64 amount = 0;
+	if(stat.open(QFile::ReadOnly | QIODevice::Text)) {
+		while(true) {
+			QString line = stat.readLine();
+			if(line.length() == 0)
+				break;
+
+			QString key = line.section(' ', 0, 0);
+			if((key == "file") || (key == "slab_reclaimable")) {
+				amount += line.section(' ', 1).trimmed().toLongLong();
+			}
+		}
+	}
+	if(amount <= 0) {
+		return;
+	}
+
+	int reclaim = open(QString(group + "/memory.reclaim").toUtf8(), O_WRONLY);
+	if(reclaim < 0) {
 		ReportWarning();
+		return;
 	}
+
+	// prefer not swapping out anonymous memory, older kernels do not know the key
+	QByteArray request = QByteArray::number(amount) + " swappiness=0";
+	if((write(reclaim, request.data(), request.size()) < 0) && (errno == EINVAL)) {
+		request = QByteArray::number(amount);
+		if((write(reclaim, request.data(), request.size()) < 0) && (errno != EAGAIN)) {
+			ReportWarning();
+		}
+	}
+	// EAGAIN only means less than requested was reclaimed
+
+	close(reclaim);
+}
+
+void Device::SetCacheScope(CacheScope scope) {
+	cacheScope = scope;
+}
+
+QString Device::CacheScopeName(CacheScope scope) {
+	switch(scope) {
+	case CacheScope::FILES:
+		return "files";
+	case CacheScope::CGROUP:
+		return "cgroup";
+	case CacheScope::GLOBAL:
+		return "global";
+	}
+
+	return "";
+}
+
+bool Device::ParseCacheScope(QString name, CacheScope &scope) {
+	for(CacheScope candidate: {CacheScope::FILES, CacheScope::CGROUP, CacheScope::GLOBAL}) {
+		if(CacheScopeName(candidate) == name) {
+			scope = candidate;
+			return true;
+		}
+	}
+
+	return false;
 }
 
 hddtime Device::Sync() {
+	// sync is not latency of benchmark operation
+	Histogram *histogram = timer.GetHistogram();
+	Counters *counters = timer.GetCounters();
+	timer.SetHistogram(NULL);
+	timer.SetCounters(NULL);
+
+	// flush tested filesystem only, raw device has just its own dirty pages
+	int target = fs?open(mountpoint.toUtf8(), O_RDONLY | O_DIRECTORY):fd;
+	if(target < 0) {
+		ReportWarning();
+	}
+
 	timer.MarkStart();
 
 	// sync
-	sync();
+	if((target >= 0) && ((fs?syncfs(target):fdatasync(target)) < 0)) {
+		ReportWarning();
+	}
 
 	timer.MarkEnd();
+	timer.SetHistogram(histogram);
+	timer.SetCounters(counters);
+
+	if(fs && (target >= 0)) {
+		close(target);
+	}
 
 	return timer.GetFinalOffset();
 }
@@ -142,6 +439,11 @@ void Device::ReportError() {
 }
 
 void Device::SetPos(hddsize pos) {
+	// direct access requires block aligned position
+	if(direct) {
+		pos = AlignDown(pos);
+	}
+
 	// set position
 	if(lseek64(fd, pos, SEEK_SET) < 0) {
 		ReportError();
@@ -149,16 +451,22 @@ void Device::SetPos(hddsize pos) {
 }
 
 hddtime Device::SeekTo(hddsize pos) {
-	char c;
+	// direct access cannot read single byte, read one aligned block instead
+	hddsize size = sizeof(char);
+	if(direct) {
+		pos = AlignDown(pos);
+		size = block_size;
+	}
+	char *buffer = Buffer(size);
 
 	timer.MarkStart();
 
 	// seek to new position
 	SetPos(pos);
-		if(read(fd, &c, sizeof(char)) < 0)
+	if(read(fd, buffer, size) < 0)
 		ReportError();
 
-	timer.MarkEnd();
+	timer.MarkEnd(size);
 
 	return timer.GetFinalOffset();
 }
@@ -168,44 +476,355 @@ hddsize Device::GetSize() {
 	return device_size;
 }
 
+hddsize Device::GetTransferred() {
+	return transferred;
+}
+
 hddtime Device::ReadAt(hddsize size, hddsize pos) {
-	char *buffer = new char[size];
+	// direct access requires block aligned position and size
+	if(direct) {
+		pos = AlignDown(pos);
+		size = AlignUp(size);
+	}
+	char *buffer = Buffer(size);
 
 	timer.MarkStart();
 
 	// Seek to new position
 	SetPos(pos);
-	if(read(fd, buffer, sizeof(char) * size) <= 0)
+	ssize_t done = read(fd, buffer, sizeof(char) * size);
+	if(done <= 0)
 	{
 		std::cerr << "Read failed" << std::endl;
 		ReportError();
 	}
+	transferred = qMax(done, (ssize_t)0);
 
-	timer.MarkEnd();
+	timer.MarkEnd(transferred);
 
-	delete [] buffer;
+	// check stamps of written blocks outside of measured time
+	if(verifier) {
+		verifier->Check(buffer, transferred, pos);
+	}
 
 	return timer.GetFinalOffset();
 }
 
 hddtime Device::Read(hddsize size) {
-	char *buffer = new char[size];
+	// direct access requires block aligned size
+	if(direct) {
+		size = AlignUp(size);
+	}
+	char *buffer = Buffer(size);
+	hddsize pos = verifier?lseek64(fd, 0, SEEK_CUR):0;
 
 	timer.MarkStart();
 
 	// Read data
-	if(read(fd, buffer, sizeof(char) * size) <= 0) {
+	ssize_t done = read(fd, buffer, sizeof(char) * size);
+	if(done <= 0) {
 		std::cerr << "Read failed" << std::endl;
 		ReportError();
 	}
+	transferred = qMax(done, (ssize_t)0);
+
+	timer.MarkEnd(transferred);
+
+	// check stamps of written blocks outside of measured time
+	if(verifier) {
+		verifier->Check(buffer, transferred, pos);
+	}
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::WriteAt(hddsize size, hddsize pos) {
+	// direct access requires block aligned position and size
+	if(direct) {
+		pos = AlignDown(pos);
+		size = AlignUp(size);
+	}
+	char *buffer = WriteBuffer(size);
+	pattern.Scramble(buffer, size);
+	if(verifier) {
+		verifier->Stamp(buffer, size, pos);
+	}
+
+	timer.MarkStart();
+
+	// Seek to new position
+	SetPos(pos);
+	ssize_t done = write(fd, buffer, sizeof(char) * size);
+	if(done <= 0)
+	{
+		std::cerr << "Write failed" << std::endl;
+		ReportError();
+	}
+	transferred = qMax(done, (ssize_t)0);
+
+	timer.MarkEnd(transferred);
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::Write(hddsize size) {
+	// direct access requires block aligned size
+	if(direct) {
+		size = AlignUp(size);
+	}
+	char *buffer = WriteBuffer(size);
+	pattern.Scramble(buffer, size);
+	if(verifier) {
+		verifier->Stamp(buffer, size, lseek64(fd, 0, SEEK_CUR));
+	}
+
+	timer.MarkStart();
+
+	// Write data
+	ssize_t done = write(fd, buffer, sizeof(char) * size);
+	if(done <= 0) {
+		std::cerr << "Write failed" << std::endl;
+		ReportError();
+	}
+	transferred = qMax(done, (ssize_t)0);
+
+	timer.MarkEnd(transferred);
+
+	return timer.GetFinalOffset();
+}
+
+AsyncIO* Device::CreateQueue(int depth) {
+	AsyncIO *engine = AsyncIO::Create(fd, depth);
+	if(engine == NULL) {
+		std::cerr << "No asynchronous I/O interface available" << std::endl;
+		ReportError();
+		return NULL;
+	}
+	asyncEngine = engine->Name();
+
+	return engine;
+}
+
+hddtime Device::ReadAtQueued(AsyncIO *engine, hddsize size, const QVector<hddsize> &positions, bool drain) {
+	// direct access requires block aligned size
+	if(direct) {
+		size = AlignUp(size);
+	}
+
+	// every slot has its own part of the buffer
+	char *buffer = Buffer(size * engine->GetDepth());
+	QVector<int> done_slots(engine->GetDepth());
+	QVector<qint64> done_results(engine->GetDepth());
+
+	// batch time is not latency, record latency of every request instead
+	Histogram *histogram = timer.GetHistogram();
+	Counters *counters = timer.GetCounters();
+	timer.SetHistogram(NULL);
+	timer.SetCounters(NULL);
+	for(int i = 0; i < engine->timers.size(); ++i) {
+		engine->timers[i].SetHistogram(histogram);
+		engine->timers[i].SetCounters(counters);
+	}
+
+	int next = 0;
+	transferred = 0;
+
+	timer.MarkStart();
+
+	// requests of previous batch stay in flight, queue is refilled as they complete
+	while((next < positions.size()) || (drain && (engine->InFlight() > 0))) {
+		// fill queue up to depth
+		int slot;
+		while((next < positions.size()) && ((slot = engine->TakeSlot()) >= 0)) {
+			hddsize pos = direct?AlignDown(positions[next]):positions[next];
+			engine->timers[slot].MarkStart();
+			if(!engine->Queue(slot, buffer + slot * size, size, pos)) {
+				std::cerr << "Read request cannot be queued" << std::endl;
+				engine->ReleaseSlot(slot);
+				ReportError();
+				next = positions.size();
+				drain = true;
+				break;
+			}
+			++next;
+		}
+
+		if(!engine->Submit()) {
+			ReportError();
+			break;
+		}
+
+		// nothing is left to wait for after failed queueing
+		if(engine->InFlight() == 0) {
+			break;
+		}
+
+		// wait for at least one request and reuse its slot
+		int count = engine->Complete(1, done_slots.data(), done_results.data());
+		if(count < 0) {
+			ReportError();
+			break;
+		}
+		for(int i = 0; i < count; ++i) {
+			// failed request is no latency of read
+			if(done_results[i] > 0) {
+				engine->timers[done_slots[i]].MarkEnd(done_results[i]);
+				transferred += done_results[i];
+			}
+			engine->ReleaseSlot(done_slots[i]);
+		}
+	}
 
 	timer.MarkEnd();
+	timer.SetHistogram(histogram);
+	timer.SetCounters(counters);
 
-	delete [] buffer;
+	if(engine->errors > 0) {
+		std::cerr << "Read failed" << std::endl;
+		ReportError();
+		engine->errors = 0;
+	}
 
 	return timer.GetFinalOffset();
 }
 
+void Device::SetDirect(bool direct) {
+	// toggle O_DIRECT on already open descriptor, position is kept
+	int flags = fcntl(fd, F_GETFL);
+	if(flags < 0) {
+		ReportWarning();
+		return;
+	}
+
+	flags = direct ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+	if(fcntl(fd, F_SETFL, flags) < 0) {
+		ReportWarning();
+		return;
+	}
+
+	this->direct = direct;
+}
+
+bool Device::IsDirect() {
+	return direct;
+}
+
+hddsize Device::GetBlockSize() {
+	return block_size;
+}
+
+void Device::PrepareBuffer(hddsize size) {
+	Buffer(size);
+}
+
+void Device::PrepareWriteBuffer(hddsize size) {
+	WriteBuffer(size);
+}
+
+void Device::SetPattern(const DataPattern &pattern) {
+	if(this->pattern != pattern) {
+		this->pattern = pattern;
+		ReleaseBuffer();
+	}
+}
+
+DataPattern Device::GetPattern() {
+	return pattern;
+}
+
+void Device::SetVerifier(Verifier *verifier) {
+	this->verifier = verifier;
+}
+
+Verifier* Device::GetVerifier() {
+	return verifier;
+}
+
+hddtime Device::VerifyWritten() {
+	if(!verifier) {
+		return 0;
+	}
+
+	// read back from drive, not from page cache
+	DropCaches();
+
+	// ReadAt checks blocks read, so every range is read once
+	hddtime time = 0;
+	hddsize pos, size;
+	while(!verifier->stopping && verifier->NextRange(Verifier::READ_BACK_SIZE, pos, size)) {
+		time += ReadAt(size, pos);
+
+		// blocks behind failed or short read are lost, forget them so read back goes on
+		if(transferred < size) {
+			verifier->Fail(size, pos, "read");
+		}
+	}
+	verifier->read_time += time;
+
+	return time;
+}
+
+void Device::ReleaseBuffer() {
+	free(buffer);
+	buffer = NULL;
+	buffer_size = 0;
+	free(write_buffer);
+	write_buffer = NULL;
+	write_buffer_size = 0;
+}
+
+bool Device::Reserve(char *&memory, hddsize &memory_size, hddsize size) {
+	// reuse memory when it is big enough
+	if(size <= memory_size) {
+		return true;
+	}
+
+	free(memory);
+	memory = NULL;
+	memory_size = 0;
+
+	// allocate memory aligned for direct access
+	hddsize alignment = qMax(block_size, BUFFER_ALIGNMENT);
+	void *aligned = NULL;
+	if(posix_memalign(&aligned, alignment, AlignUp(size))) {
+		std::cerr << "Buffer allocation failed" << std::endl;
+		ReportError();
+		return false;
+	}
+
+	memory = (char*)aligned;
+	memory_size = AlignUp(size);
+
+	return true;
+}
+
+char* Device::Buffer(hddsize size) {
+	return Reserve(buffer, buffer_size, size)?buffer:NULL;
+}
+
+char* Device::WriteBuffer(hddsize size) {
+	hddsize old_size = write_buffer_size;
+	if(!Reserve(write_buffer, write_buffer_size, size)) {
+		return NULL;
+	}
+
+	// fill with selected content, random by default so writes cannot be compressed or deduplicated by drive,
+	// reads never use this buffer so the content stays as selected
+	if(write_buffer_size != old_size) {
+		pattern.Fill(write_buffer, write_buffer_size);
+	}
+
+	return write_buffer;
+}
+
+hddsize Device::AlignDown(hddsize value) {
+	return value - value % block_size;
+}
+
+hddsize Device::AlignUp(hddsize value) {
+	return AlignDown(value + block_size - 1);
+}
+
 void Device::EraseDriveInfo() {
 	size = -1;
 
@@ -224,10 +843,15 @@ void Device::EraseDriveInfo() {
 void Device::DriveInfo() {
 	EraseDriveInfo();
 
-    size = info.bytesTotal();
-    fs = true;
-    fstype = info.fileSystemType();
-    mountpoint = info.rootPath();
+	// device without mounted filesystem provides raw size only
+	if(!info.isValid()) {
+		size = device_size;
+	} else {
+		size = info.bytesTotal();
+		fs = true;
+		fstype = info.fileSystemType();
+		mountpoint = info.rootPath();
+	}
 
 	// Old way reading only for filesystem mount options
 	QFile mounts("/proc/mounts");
@@ -293,6 +917,8 @@ hddtime Device::MkDir(QString path) {
 
 hddtime Device::MkFile(QString path, hddsize size) {
 	QFile file(path);
+	char *data = WriteBuffer(size);
+	pattern.Scramble(data, size);
 
 	timer.MarkStart();
 
@@ -302,16 +928,14 @@ hddtime Device::MkFile(QString path, hddsize size) {
 	} else {
 		// if size should be more then zero write data to file
 		if(size > 0) {
-			char *data = new char[size];
 			if(file.write(data, size) != size)
 				ReportError();
-			delete [] data;
 		}
 
 		file.close();
 	}
 
-	timer.MarkEnd();
+	timer.MarkEnd(size);
 
 	return timer.GetFinalOffset();
 }
@@ -367,68 +991,190 @@ hddtime Device::ReadFile(QString path) {
 	return timer.GetFinalOffset();
 }
 
-QDomElement Device::WriteInfo(QDomDocument &doc) {
+hddtime Device::StatFile(QString path) {
+	QByteArray name = path.toUtf8();
+	struct stat buf;
+
+	timer.MarkStart();
+
+	// read attributes
+	if(lstat(name, &buf) < 0) {
+		ReportError();
+	}
+
+	timer.MarkEnd();
+
+	return timer.GetFinalOffset();
+}
+
+int Device::OpenDirAt(int dirfd, const char *name) {
+	return openat(dirfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+}
+
+hddtime Device::MkDirAt(int dirfd, const char *name) {
+	timer.MarkStart();
+
+	if(mkdirat(dirfd, name, 0777) < 0) {
+		ReportError();
+	}
+
+	timer.MarkEnd();
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::MkFileAt(int dirfd, const char *name, hddsize size) {
+	// file content is taken from write buffer
+	char *data = WriteBuffer(qMin(size, FILE_BUFFER_SIZE));
+	pattern.Scramble(data, qMin(size, FILE_BUFFER_SIZE));
+
+	timer.MarkStart();
+
+	int file = openat(dirfd, name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+	if(file < 0) {
+		ReportError();
+	} else {
+		for(hddsize done = 0; done < size; ) {
+			ssize_t ret = write(file, data, qMin(size - done, FILE_BUFFER_SIZE));
+			if(ret <= 0) {
+				ReportError();
+				break;
+			}
+			done += ret;
+		}
+		close(file);
+	}
+
+	timer.MarkEnd(size);
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::ReadFileAt(int dirfd, const char *name) {
+	char *data = Buffer(FILE_BUFFER_SIZE);
+
+	timer.MarkStart();
+
+	int file = openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+	if(file < 0) {
+		ReportError();
+	} else {
+		// read until end of file
+		ssize_t ret;
+		do {
+			ret = read(file, data, FILE_BUFFER_SIZE);
+		} while(ret > 0);
+		if(ret < 0) {
+			ReportError();
+		}
+		close(file);
+	}
+
+	timer.MarkEnd();
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::StatAt(int dirfd, const char *name) {
+	struct stat buf;
+
+	timer.MarkStart();
+
+	if(fstatat(dirfd, name, &buf, AT_SYMLINK_NOFOLLOW) < 0) {
+		ReportError();
+	}
+
+	timer.MarkEnd();
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::DelFileAt(int dirfd, const char *name) {
+	timer.MarkStart();
+
+	if(unlinkat(dirfd, name, 0) < 0) {
+		ReportError();
+	}
+
+	timer.MarkEnd();
+
+	return timer.GetFinalOffset();
+}
+
+hddtime Device::DelDirAt(int dirfd, const char *name) {
+	timer.MarkStart();
+
+	if(unlinkat(dirfd, name, AT_REMOVEDIR) < 0) {
+		ReportError();
+	}
+
+	timer.MarkEnd();
+
+	return timer.GetFinalOffset();
+}
+
+void Device::WriteInfo(ResultWriter &writer) {
 	// create main info element
-	QDomElement master = doc.createElement("Info");
-	doc.appendChild(master);
+	writer.StartElement("Info");
 
 	// add fs info
-	QDomElement fsi = doc.createElement("FS");
-	fsi.setAttribute("fs", fs);
-	fsi.setAttribute("mountpoint", mountpoint);
-	fsi.setAttribute("fstype", fstype);
-	fsi.setAttribute("fsversion", fsversion);
-	fsi.setAttribute("fsoptions", fsoptions);
-	master.appendChild(fsi);
+	writer.StartElement("FS");
+	writer.Attribute("fs", fs);
+	writer.Attribute("mountpoint", mountpoint);
+	writer.Attribute("fstype", fstype);
+	writer.Attribute("fsversion", fsversion);
+	writer.Attribute("fsoptions", fsoptions);
+	writer.EndElement();
 
 	// add device info
-	QDomElement dev = doc.createElement("Device");
-	dev.setAttribute("path", path);
-	dev.setAttribute("model", model);
-	dev.setAttribute("serial", serial);
-	dev.setAttribute("firmware", firmware);
-	dev.setAttribute("size", size);
-	master.appendChild(dev);
+	writer.StartElement("Device");
+	writer.Attribute("path", path);
+	writer.Attribute("model", model);
+	writer.Attribute("serial", serial);
+	writer.Attribute("firmware", firmware);
+	writer.Attribute("size", size);
+	writer.EndElement();
 
 	// add kernel info
-	QDomElement ker = doc.createElement("Kernel");
-	ker.setAttribute("kernel", kernel);
-	master.appendChild(ker);	
+	writer.StartElement("Kernel");
+	writer.Attribute("kernel", kernel);
+	writer.Attribute("cache", CacheScopeName(cacheScope));
+	writer.EndElement();
 
-	return master;
+	writer.EndElement();
 }
 
-void Device::ReadInfo(QDomElement &root) {
+void Device::ReadInfo(const ResultElement &root) {
 	// Locate main seek element
-	QDomElement info = root.firstChildElement("Info");
+	ResultElement info = root.Child("Info");
 
 	// add fs info
-	QDomElement fsi = info.firstChildElement("FS");
-	if(fsi.isNull()) {
+	ResultElement fsi = info.Child("FS");
+	if(fsi.IsNull()) {
 		return;
 	}
-	fs = fsi.attribute("fs", "NO DATA").compare("1") == 0;
-	mountpoint = fsi.attribute("mountpoint", "NO DATA");
-	fstype = fsi.attribute("fstype", "NO DATA");
-	fsversion = fsi.attribute("fsversion", "NO DATA");
-	fsoptions = fsi.attribute("fsoptions", "NO DATA");
+	fs = fsi.Attribute("fs", "NO DATA").compare("1") == 0;
+	mountpoint = fsi.Attribute("mountpoint", "NO DATA");
+	fstype = fsi.Attribute("fstype", "NO DATA");
+	fsversion = fsi.Attribute("fsversion", "NO DATA");
+	fsoptions = fsi.Attribute("fsoptions", "NO DATA");
 
 	// add device info
-	QDomElement dev = info.firstChildElement("Device");
-	if(dev.isNull()) {
+	ResultElement dev = info.Child("Device");
+	if(dev.IsNull()) {
 		return;
 	}
-	path = dev.attribute("path", "NO DATA");
-	model = dev.attribute("model", "NO DATA");
-	serial = dev.attribute("serial", "NO DATA");
-	firmware = dev.attribute("firmware", "NO DATA");
-	size = dev.attribute("size", "NO DATA").toLongLong();
+	path = dev.Attribute("path", "NO DATA");
+	model = dev.Attribute("model", "NO DATA");
+	serial = dev.Attribute("serial", "NO DATA");
+	firmware = dev.Attribute("firmware", "NO DATA");
+	size = dev.Integer("size");
 
 	// add kernel info
-	QDomElement ker = info.firstChildElement("Kernel");
-	if(ker.isNull())
+	ResultElement ker = info.Child("Kernel");
+	if(ker.IsNull())
 		return;
-	kernel = ker.attribute("kernel", "NO DATA");
+	kernel = ker.Attribute("kernel", "NO DATA");
 }
 
 Device::Item Device::Item::None() {
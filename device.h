@@ -35,17 +35,24 @@
 
 #include <fcntl.h>
 #include <linux/hdreg.h>
+#include <linux/fs.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <mntent.h>
 #include <unistd.h>
 #include <sys/utsname.h>
 
 #include <QtCore>
-#include <QMessageBox>
 #include <QtXml>
 
 #include "definitions.h"
 #include "timer.h"
+#include "asyncio.h"
+#include "datapattern.h"
+
+class Verifier;
+#include "resultwriter.h"
+#include "resultfile.h"
 
 using namespace HDDTest;
 
@@ -82,6 +89,16 @@ public:
         QStorageInfo info {};  /// Qt storage info
     };
 
+	/// Caches emptied by DropCaches
+	enum class CacheScope {
+		FILES,	/// Benchmark files and buffers of tested device only
+		CGROUP,	/// Benchmark files, device and page cache of own cgroup v2
+		GLOBAL	/// Page, dentry and inode caches of the whole system
+	};
+
+	static const hddsize BUFFER_ALIGNMENT = 4 * K;	/// Minimal memory alignment of operation buffer
+	static const hddsize DEFAULT_BLOCK_SIZE = 512 * B;	/// Block size used when device does not report one
+
 	Device();									/// Device constructor
 	~Device();									/// Device destructor - close device file descriptor
 
@@ -91,18 +108,55 @@ public:
 	// device access operations
     void Open(Item device, bool close);		/// Opens device specified by path
 	void Close();								/// Close device file descriptor
-	void DropCaches();							/// Disables some caches for device
-	hddtime Sync();								/// Sync filesystem
+	Device* Clone();							/// Open device again with own descriptor, buffer and timer for parallel access
+	bool SetWritable(bool writable);			/// Reopen device for exclusive writing or back to read only, false on failure
+	bool IsMounted();							/// Whenever device or any of its partitions is mounted or used
+	static bool IsMounted(QString path);		/// Whenever device on path or any of its partitions is mounted or used
+	void DropCaches();							/// Evicts cached data of device in scope selected
+	void SetCacheScope(CacheScope scope);		/// Select caches emptied by DropCaches
+	static QString CacheScopeName(CacheScope scope);	/// Name of cache scope
+	static bool ParseCacheScope(QString name, CacheScope &scope);	/// Cache scope by name, false when unknown
+	hddtime Sync();								/// Flush tested filesystem (or device) and return flush time
 	void Warmup();								/// Make device redy for operation
 	void DriveInfo();							/// Read driveinfo from device
 	void EraseDriveInfo();						/// Erase drive info to default values
 
 	// raw disk operations
-	void SetPos(hddsize pos);					/// Set actual position
+	void SetPos(hddsize pos);					/// Set actual position, aligned down to block in direct mode
 	hddtime SeekTo(hddsize pos);				/// Seek to position returns operation time
 	hddtime Read(hddsize size);					/// Read data at current position and return operation time
 	hddtime ReadAt(hddsize size, hddsize pos);	/// Read data at position return operation time
+	hddtime Write(hddsize size);				/// Write data at current position and return operation time
+	hddtime WriteAt(hddsize size, hddsize pos);	/// Write data at position return operation time
 	hddsize GetSize();							/// Get size of drive
+	hddsize GetTransferred();					/// Bytes really transferred by last read or write, aligned size in direct mode
+
+	/** Creates asynchronous engine for queued reads, reports error when none is available
+	  @param depth queue depth (count of requests in flight)
+	  @return engine owned by caller or NULL **/
+	AsyncIO* CreateQueue(int depth);
+
+	/** Read blocks at positions keeping the queue of engine full. Bytes read by requests
+	completed during the batch are returned by GetTransferred.
+	  @param engine engine created by CreateQueue, keeps requests in flight between calls
+	  @param size size of every block
+	  @param positions positions to read from
+	  @param drain whenever to wait for all requests in flight before return
+	  @return time of the batch **/
+	hddtime ReadAtQueued(AsyncIO *engine, hddsize size, const QVector<hddsize> &positions, bool drain);
+
+	// direct access
+	void SetDirect(bool direct);				/// Switch between cached and direct (O_DIRECT) access
+	bool IsDirect();							/// Whenever direct access is active
+	hddsize GetBlockSize();						/// Get logical block size used for direct access alignment
+	void PrepareBuffer(hddsize size);			/// Allocate aligned read buffer for operations up to size
+	void PrepareWriteBuffer(hddsize size);		/// Allocate aligned pattern filled write buffer for operations up to size
+	void SetPattern(const DataPattern &pattern);	/// Select content of written data, write buffer is filled again
+	DataPattern GetPattern();					/// Content of written data
+	void SetVerifier(Verifier *verifier);		/// Stamp written and check read blocks, NULL disables verification
+	Verifier* GetVerifier();					/// Verifier of written data or NULL
+	hddtime VerifyWritten();					/// Read back and check blocks written and not read yet, returns read time
+	void ReleaseBuffer();						/// Free read and write buffers
 
 	// fs operations
 	hddtime MkDir(QString path);				/// Makes new directory in temp and returns operation time
@@ -110,6 +164,18 @@ public:
 	hddtime DelFile(QString path);				/// Delete file from temp and return operation time
 	hddtime DelDir(QString path);				/// Delete dir from tmp path and return operation time
 	hddtime ReadFile(QString path);				/// Reads file and return operation time
+	hddtime StatFile(QString path);				/// Reads file or dir attributes and return operation time
+
+	// directory descriptor relative fs operations, names are relative to dirfd (or absolute with AT_FDCWD)
+	static const hddsize FILE_BUFFER_SIZE = 64 * K;	/// Chunk by which files are read and written
+
+	int OpenDirAt(int dirfd, const char *name);				/// Opens directory for relative operations, not timed, -1 on failure
+	hddtime MkDirAt(int dirfd, const char *name);				/// Makes directory and returns operation time
+	hddtime MkFileAt(int dirfd, const char *name, hddsize size);	/// Makes file of size and returns operation time
+	hddtime ReadFileAt(int dirfd, const char *name);			/// Reads whole file and returns operation time
+	hddtime StatAt(int dirfd, const char *name);				/// Reads attributes and returns operation time
+	hddtime DelFileAt(int dirfd, const char *name);			/// Deletes file and returns operation time
+	hddtime DelDirAt(int dirfd, const char *name);				/// Deletes empty directory and returns operation time
 
 	Timer timer;								/// Timer for device operation measuring
 
@@ -134,13 +200,22 @@ public:
 
 	// kernel info
 	QString kernel;		/// Kernel identification string
+	QString asyncEngine;	/// Asynchronous engine used by last queued read
 
-	QDomElement WriteInfo(QDomDocument &doc);	/// Store information to XML element
-	void ReadInfo(QDomElement &root);			/// Read information from XML element
+	void WriteInfo(ResultWriter &writer);	/// Store information to result file
+	void ReadInfo(const ResultElement &root);	/// Read information from result file element
 
 private:
 	void ReportWarning();						/// Reports a problem with accessing device
 	void ReportError();							/// Reports error in test
+	void EvictFiles(QString dir);				/// Writes back and evicts cached pages of files in directory tree
+	void ReclaimCgroup();						/// Asks kernel to reclaim page cache of own cgroup
+
+	bool Reserve(char *&memory, hddsize &memory_size, hddsize size);	/// Grows aligned memory to at least size, false on failure
+	char* Buffer(hddsize size);					/// Returns aligned read buffer of at least size, grows it when needed
+	char* WriteBuffer(hddsize size);			/// Returns aligned pattern filled write buffer of at least size
+	hddsize AlignDown(hddsize value);			/// Aligns value down to logical block size
+	hddsize AlignUp(hddsize value);				/// Aligns value up to logical block size
 
 	// Device's file destriptor
 	int fd;
@@ -148,6 +223,28 @@ private:
 	hddsize device_size;
 	// Whenever device access problem was reported
 	bool problemReported;
+	// Whenever device is accessed with O_DIRECT
+	bool direct;
+	// Whenever device is open for writing
+	bool writable;
+	// Caches emptied by DropCaches
+	CacheScope cacheScope;
+	// Logical block size of device
+	hddsize block_size;
+	// Aligned buffer reused by read operations
+	char *buffer;
+	// Size of the aligned buffer
+	hddsize buffer_size;
+	// Aligned pattern filled buffer reused by write operations, never read into
+	char *write_buffer;
+	// Size of the write buffer
+	hddsize write_buffer_size;
+	// Content of written data
+	DataPattern pattern;
+	// Verifier of written data
+	Verifier *verifier;
+	// Bytes transferred by last read or write
+	hddsize transferred;
 
 	// UDisks2 DBus connection
 //	QDBusInterface *udisks;
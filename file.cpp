@@ -19,29 +19,85 @@
 ********************************************************************************/
 
 #include "file.h"
+#include "verifier.h"
+
+#include <errno.h>
+
+File::File(QString path, Device *device, OpenMode mode, QObject *parent) :
+	QObject(parent), path(path), mode(mode), buffer(NULL), buffer_size(0),
+	write_buffer(NULL), write_buffer_size(0), transferred(0) {
+	// direct access needs buffers aligned to logical block size
+	alignment = qMax(device->GetBlockSize(), (hddsize)Device::BUFFER_ALIGNMENT);
+	pattern = device->GetPattern();
+	verifier = device->GetVerifier();
 
-File::File(QString path, Device *device, QObject *parent) :
-	QObject(parent), path(path) {
 	// connect operation error signal to matchong signal in backlaying device
 	connect(this, SIGNAL(operationError()), device, SIGNAL(operationError()));
 
+	// file operations are sampled with the benchmark
+	timer.SetCounters(device->timer.GetCounters());
+
 	fdopen();	// open file
 }
 
 File::~File() {
 	Close();
+	free(buffer);
+	free(write_buffer);
+}
+
+QString File::OpenModeName(OpenMode mode) {
+	switch(mode) {
+	case OPEN_SYNC:
+		return "O_SYNC";
+	case OPEN_BUFFERED:
+		return "Buffered";
+	case OPEN_DSYNC:
+		return "O_DSYNC";
+	case OPEN_DIRECT:
+		return "O_DIRECT";
+	default:
+		return "";
+	}
 }
 
 void File::Close() {
-	close(fd);
+	if(fd >= 0) {
+		close(fd);
+		fd = -1;
+	}
+}
+
+bool File::IsOpen() {
+	return fd >= 0;
 }
 
 void File::fdopen() {
+	int flags = O_CREAT | O_RDWR | O_LARGEFILE;
+	switch(mode) {
+	case OPEN_SYNC:
+		flags |= O_SYNC;
+		break;
+	case OPEN_DSYNC:
+		flags |= O_DSYNC;
+		break;
+	case OPEN_DIRECT:
+		flags |= O_DIRECT;
+		break;
+	default:
+		break;
+	}
+
 	// open file
-	fd = open(path.toUtf8(), O_CREAT | O_RDWR | O_SYNC | O_LARGEFILE, S_IRWXU);
+	fd = open(path.toUtf8(), flags, S_IRWXU);
 	if(fd < 0) {
+		// filesystem without direct access support is not an error of test
+		if((mode == OPEN_DIRECT) && (errno == EINVAL)) {
+			return;
+		}
 		std::cout << "Error opening file" << std::endl;
 		ReportError();
+		return;
 	}
 
 	// advice system not to cache file data
@@ -52,10 +108,55 @@ void File::fdopen() {
 }
 
 void File::Reopen() {
-	close(fd);
+	Close();
 	fdopen();
 }
 
+hddtime File::Sync() {
+	// flush is not latency of benchmark operation
+	Histogram *histogram = timer.GetHistogram();
+	Counters *counters = timer.GetCounters();
+	timer.SetHistogram(NULL);
+	timer.SetCounters(NULL);
+
+	timer.MarkStart();
+
+	// flush file data only
+	if(fdatasync(fd) < 0)
+		ReportError();
+
+	timer.MarkEnd();
+	timer.SetHistogram(histogram);
+	timer.SetCounters(counters);
+
+	return timer.GetFinalOffset();
+}
+
+hddtime File::VerifyWritten() {
+	if(!verifier) {
+		return 0;
+	}
+
+	// read back from drive, not from page cache
+	Sync();
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+	// ReadAt checks blocks read, so every range is read once
+	hddtime time = 0;
+	hddsize pos, size;
+	while(!verifier->stopping && verifier->NextRange(Verifier::READ_BACK_SIZE, pos, size)) {
+		time += ReadAt(size, pos);
+
+		// blocks behind failed or short read are lost, forget them so read back goes on
+		if(transferred < size) {
+			verifier->Fail(size, pos, "read");
+		}
+	}
+	verifier->read_time += time;
+
+	return time;
+}
+
 void File::SetPos(hddsize pos) {
 	// set position
 	if(lseek64(fd, pos, SEEK_SET) < 0)
@@ -63,25 +164,35 @@ void File::SetPos(hddsize pos) {
 }
 
 hddtime File::Read(hddsize size) {
-	char *buffer = new char[size];
+	char *buffer = Buffer(size);
+	hddsize pos = verifier?lseek64(fd, 0, SEEK_CUR):0;
 
 	timer.MarkStart();
 
 	// read data
-	if(read(fd, buffer, sizeof(char) * size) <= 0) {
+	ssize_t done = read(fd, buffer, sizeof(char) * size);
+	if(done <= 0) {
 		std::cerr << "Read failed" << std::endl;
 		ReportError();
 	}
+	transferred = qMax(done, (ssize_t)0);
 
-	timer.MarkEnd();
+	timer.MarkEnd(transferred);
 
-	delete [] buffer;
+	// check stamps of written blocks outside of measured time
+	if(verifier) {
+		verifier->Check(buffer, transferred, pos);
+	}
 
 	return timer.GetFinalOffset();
 }
 
 hddtime File::Write(hddsize size) {
-	char *buffer = new char[size];
+	char *buffer = WriteBuffer(size);
+	pattern.Scramble(buffer, size);
+	if(verifier) {
+		verifier->Stamp(buffer, size, lseek64(fd, 0, SEEK_CUR));
+	}
 
 	timer.MarkStart();
 
@@ -91,13 +202,101 @@ hddtime File::Write(hddsize size) {
 		ReportError();
 	}
 
-	timer.MarkEnd();
+	timer.MarkEnd(size);
 
-	delete [] buffer;
+	return timer.GetFinalOffset();
+}
+
+hddtime File::ReadAt(hddsize size, hddsize pos) {
+	char *buffer = Buffer(size);
+
+	timer.MarkStart();
+
+	// read data without moving file position
+	ssize_t done = pread64(fd, buffer, sizeof(char) * size, pos);
+	if(done <= 0) {
+		std::cerr << "Read failed" << std::endl;
+		ReportError();
+	}
+	transferred = qMax(done, (ssize_t)0);
+
+	timer.MarkEnd(transferred);
+
+	// check stamps of written blocks outside of measured time
+	if(verifier) {
+		verifier->Check(buffer, transferred, pos);
+	}
+
+	return timer.GetFinalOffset();
+}
+
+hddsize File::GetTransferred() {
+	return transferred;
+}
+
+hddtime File::WriteAt(hddsize size, hddsize pos) {
+	char *buffer = WriteBuffer(size);
+	pattern.Scramble(buffer, size);
+	if(verifier) {
+		verifier->Stamp(buffer, size, pos);
+	}
+
+	timer.MarkStart();
+
+	// write data without moving file position
+	if(pwrite64(fd, buffer, sizeof(char) * size, pos) <= 0) {
+		std::cerr << "Write failed" << std::endl;
+		ReportError();
+	}
+
+	timer.MarkEnd(size);
 
 	return timer.GetFinalOffset();
 }
 
+bool File::Reserve(char *&memory, hddsize &memory_size, hddsize size) {
+	// reuse memory when it is big enough
+	if(size <= memory_size) {
+		return true;
+	}
+
+	free(memory);
+	memory = NULL;
+	memory_size = 0;
+
+	// allocate memory aligned for direct access
+	hddsize aligned = (size + alignment - 1) / alignment * alignment;
+	void *allocated = NULL;
+	if(posix_memalign(&allocated, alignment, aligned)) {
+		std::cerr << "Buffer allocation failed" << std::endl;
+		ReportError();
+		return false;
+	}
+
+	memory = (char*)allocated;
+	memory_size = aligned;
+
+	return true;
+}
+
+char* File::Buffer(hddsize size) {
+	return Reserve(buffer, buffer_size, size)?buffer:NULL;
+}
+
+char* File::WriteBuffer(hddsize size) {
+	hddsize old_size = write_buffer_size;
+	if(!Reserve(write_buffer, write_buffer_size, size)) {
+		return NULL;
+	}
+
+	// fill with content selected for device, reads never use this buffer
+	if(write_buffer_size != old_size) {
+		pattern.Fill(write_buffer, write_buffer_size);
+	}
+
+	return write_buffer;
+}
+
 void File::ReportError() {
     emit operationError();
 }
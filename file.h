@@ -38,14 +38,21 @@ using namespace HDDTest;
 class File : public QObject {
     Q_OBJECT
 public:
+	/// Open modes, each one makes writes durable in different way
+	enum OpenMode { OPEN_SYNC, OPEN_BUFFERED, OPEN_DSYNC, OPEN_DIRECT, OPEN_COUNT };
+
 	/** File constructor prepares file for reading and wtitting into/from it.
 	  @param path to the file
-	  @param device device the file resides on as pointer to Device class instance **/
-	explicit File(QString path, Device *device, QObject *parent = 0);
+	  @param device device the file resides on as pointer to Device class instance
+	  @param mode open mode of the file **/
+	explicit File(QString path, Device *device, OpenMode mode = OPEN_SYNC, QObject *parent = 0);
 
 	~File(); /// File destructor - closes open file
 
+	static QString OpenModeName(OpenMode mode);	/// Name of open mode used in summary and results
+
 	void Close(); /// Closes file
+	bool IsOpen(); /// Whenever file is open, direct mode is not supported by every filesystem
 
 	/** Set current position in file
 	  @param pos the position **/
@@ -53,6 +60,14 @@ public:
 
 	void Reopen(); /// Reopens file to clear caches
 
+	/** Flush data of file to device
+	  @return flush time **/
+	hddtime Sync();
+
+	/** Read back and check blocks written in verify mode and not read yet
+	  @return read time **/
+	hddtime VerifyWritten();
+
 	/** Write at current position in file
 	  @param size to be written
 	  @return operation time **/
@@ -63,14 +78,41 @@ public:
 	  @return operation time **/
 	hddtime Read(hddsize size);
 
+	/** Write at position in file
+	  @param size to be written
+	  @param pos position in file
+	  @return operation time **/
+	hddtime WriteAt(hddsize size, hddsize pos);
+
+	/** Read at position in file
+	  @param size to be read
+	  @param pos position in file
+	  @return operation time **/
+	hddtime ReadAt(hddsize size, hddsize pos);
+
+	hddsize GetTransferred(); /// Bytes really read by last read
+
 	Timer timer; /// Timer used for opeartion time measuring
 
 private:
 	void ReportError();	// reports error in test
 	int fd;			// file`s file descriptor
 	QString path;	// path to file
+	OpenMode mode;	// flags file is opened with
 	void fdopen();	// open file by path stored internally
 
+	bool Reserve(char *&memory, hddsize &memory_size, hddsize size);	// grows aligned memory to at least size
+	char* Buffer(hddsize size);			// aligned read buffer of at least size
+	char* WriteBuffer(hddsize size);	// aligned pattern filled write buffer of at least size
+	char *buffer;				// read buffer reused by all reads
+	hddsize buffer_size;		// size of read buffer
+	char *write_buffer;			// pattern filled buffer reused by all writes, never read into
+	hddsize write_buffer_size;	// size of write buffer
+	hddsize alignment;		// alignment of buffer required by direct access
+	DataPattern pattern;	// content of written data taken from device
+	Verifier *verifier;		// verifier of written data taken from device
+	hddsize transferred;	// bytes read by last read
+
 signals:
 	void operationError();	/// Emited when error occures
 };
@@ -20,26 +20,8 @@
 
 #include "filerw.h"
 
-FileRW::FileRW(QWidget *parent) :
-	TestWidget(parent) {
-	// Add two line graph components (reading + writting)
-	__read_graph = addLineGraph("MB/s", QColor(255, 192, 192));
-	__write_graph = addLineGraph("MB/s", QColor(255, 0, 0));
-
-	// Add two line graph components (reference reading + reference writting)
-	__read_reference_graph = addLineGraph("MB/s", QColor(192, 192, 255));
-	__write_reference_graph = addLineGraph("MB/s", QColor(0, 0, 255));
-
-	// Add background net
-	__net = addNet("MB/s", "File position", "Speed");
-
-	// Add legend
-	__legend = addLegend();
-	__legend->AddItem("Read", QColor(255, 192, 192));
-	__legend->AddItem("Write", QColor(255, 0, 0));
-	__legend->AddItem("Read", QColor(192, 192, 255));
-	__legend->AddItem("Write", QColor(0, 0, 255));
-
+FileRW::FileRW(QObject *parent) :
+	Benchmark(parent) {
 	testName = "File write and read";
 	testDescription = "R/W File test writes " + Def::FormatSize(FILERW_SIZE) +
 			" to file on mounted device. Then whole file is read again." +
@@ -47,19 +29,30 @@ FileRW::FileRW(QWidget *parent) :
 			Def::FormatSize(FILERW_BLOCK) + "." +
 			" Process is shown in graph where darker color shows write speed" +
 			" and lighter read speed depending on file position." +
-			" This test is not aviable(grayed start button) when device is not mounted.";
+			" This test is not aviable(grayed start button) when device is not mounted." +
+			" Matrix mode writes and reads file opened buffered, with O_DSYNC, O_SYNC and O_DIRECT" +
+			" by blocks of " + Def::FormatSize(FileRWMatrix::BlockSize(0)) + " to " +
+			Def::FormatSize(FileRWMatrix::BlockSize(FileRWMatrix::SIZES - 1)) +
+			", every combination for up to " + Def::FormatSize(MATRIX_CELL_SIZE) + " or " +
+			Def::FormatTime(MATRIX_CELL_TIME) + "." +
+			" Lines show speed of every open mode by block size, write speed includes final flush.";
+
+	AddMode("O_SYNC, " + Def::FormatSize(FILERW_BLOCK) + " blocks");
+	AddMode("Open modes by block sizes");
 }
 
 FileRW::~FileRW() {}
 
 void FileRW::TestLoop() {
-	// erase old results
-	results_write.erase();
-	results_read.erase();
-
 	// prepare test file
 	QString filename = device->GetSafeTemp() + "/" + "hddtestfile";
 
+	if(mode == MODE_MATRIX) {
+		MatrixLoop(filename);
+		device->ClearSafeTemp();
+		return;
+	}
+
 	File file(filename, device);
 
 	// get block count	
@@ -67,96 +60,183 @@ void FileRW::TestLoop() {
 	results_read.blocks = FILERW_SIZE / FILERW_BLOCK;
 	results_write.blocks_done = 0;
 	results_read.blocks_done = 0;
+	results_write.results.reserve(results_write.blocks);
+	results_read.results.reserve(results_read.blocks);
 
 	// write blocks until enough data is written
+	file.timer.SetHistogram(&results_write.histogram);
 	file.SetPos(0);
 	for(results_write.blocks_done = 1; results_write.blocks_done <= results_write.blocks; ++results_write.blocks_done) {
 		hddtime time = file.Write(FILERW_BLOCK);
-		results_write.AddResult((qreal)FILERW_BLOCK / time);
+		results_write.AddResult((qreal)FILERW_BLOCK * us / time);
 		if(testState == STOPPING)
 			break;
 	}
 
-	// sync filesystem and drop caches
+	// flush file and drop caches
+	file.Sync();
 	file.Reopen();
-	device->Sync();
 	device->DropCaches();
 
 	// read block until enough data is read
+	file.timer.SetHistogram(&results_read.histogram);
 	file.SetPos(0);
 	for(results_read.blocks_done = 1; results_read.blocks_done <= results_read.blocks; ++results_read.blocks_done) {
 		hddtime time = file.Read(FILERW_BLOCK);
-		results_read.AddResult((qreal)FILERW_BLOCK / time);
+		results_read.AddResult((qreal)FILERW_BLOCK * us / time);
 		if(testState == STOPPING)
 			break;
 	}	
 
+	// check blocks not read back when stopped
+	file.VerifyWritten();
+
 	// close and delete file
 	file.Close();
 	device->DelFile(filename);
 	device->ClearSafeTemp();
 }
 
-void FileRW::InitScene() {
-	// reset first value
-	__first = true;
+void FileRW::MatrixLoop(QString filename) {
+	for(int m = 0; (m < File::OPEN_COUNT) && (testState != STOPPING); ++m) {
+		for(int b = 0; (b < FileRWMatrix::SIZES) && (testState != STOPPING); ++b) {
+			hddsize block = FileRWMatrix::BlockSize(b);
+			File file(filename, device, (File::OpenMode)m);
+			if(!file.IsOpen()) {
+				matrix.write[m][b] = -1;
+				matrix.read[m][b] = -1;
+				++matrix.cells_done;
+				continue;
+			}
+
+			// write until cell size or time is used up, flush is part of write
+			Timer timer;
+			hddsize written = 0;
+			timer.MarkStart();
+			while((written < MATRIX_CELL_SIZE) && (timer.GetCurrentOffset() < MATRIX_CELL_TIME) &&
+					(testState != STOPPING)) {
+				file.WriteAt(block, written);
+				written += block;
+			}
+			file.Sync();
+			timer.MarkEnd();
+			matrix.write[m][b] = (qreal)written * us / timer.GetFinalOffset();
+
+			// read the same data from device
+			file.Reopen();
+			device->DropCaches();
+			hddsize read = 0;
+			timer.MarkStart();
+			while((read < written) && (timer.GetCurrentOffset() < MATRIX_CELL_TIME) && (testState != STOPPING)) {
+				file.ReadAt(block, read);
+				read += block;
+			}
+			timer.MarkEnd();
+			matrix.read[m][b] = (qreal)read * us / timer.GetFinalOffset();
+
+			// check blocks not read in time
+			file.VerifyWritten();
+			file.Close();
+			device->DelFile(filename);
+
+			if(testState != STOPPING) {
+				++matrix.cells_done;
+			}
+		}
+	}
+}
 
-	// erase graphs and results
-	__read_graph->erase();
-	__write_graph->erase();
+void FileRW::InitResults() {
+	// erase results
 	results_read.erase();
 	results_write.erase();
+	matrix.erase();
 }
 
-void FileRW::UpdateScene() {
-	// set graph size
-	__write_graph->SetSize(results_write.blocks);
-	__read_graph->SetSize(results_read.blocks);
-	__write_reference_graph->SetSize(reference_write.blocks);
-	__read_reference_graph->SetSize(reference_read.blocks);
-
-	// add new values to write graph
-	while(!results_write.new_results.empty()) {
-		qreal data = results_write.new_results.dequeue();
-		__write_graph->AddValue(data);
+int FileRW::GetProgress() {
+	if(mode == MODE_MATRIX) {
+		return (100 * matrix.cells_done) / (File::OPEN_COUNT * FileRWMatrix::SIZES);
 	}
 
-	// add new values to read graph
-	while(!results_read.new_results.empty()) {
-		qreal data = results_read.new_results.dequeue();
-		__read_graph->AddValue(data);
+	int done = results_read.blocks_done + results_write.blocks_done;
+	int blocks = results_write.blocks + results_read.blocks;
+	if(blocks) {
+		return (100 * done) / blocks;
+	} else {
+		return 0;
+	}
+}
+
+QString FileRW::GetSummary() {
+	if(mode == MODE_MATRIX) {
+		// one line of write/read speeds per open mode
+		QString summary;
+		for(int m = 0; m < File::OPEN_COUNT; ++m) {
+			summary += File::OpenModeName((File::OpenMode)m) + " write/read MB/s:";
+			int done = qBound(0, matrix.cells_done - m * FileRWMatrix::SIZES, FileRWMatrix::SIZES);
+			for(int b = 0; b < done; ++b) {
+				summary += " " + Def::FormatSize(FileRWMatrix::BlockSize(b)) + " ";
+				summary += (matrix.write[m][b] < 0)?QString("unsupported"):
+						QString::number(matrix.write[m][b], 'f', 1) + "/" + QString::number(matrix.read[m][b], 'f', 1);
+			}
+			summary += "\n";
+		}
+
+		return summary.trimmed();
 	}
 
-	// add new values to reference write graph
-	while(!reference_write.new_results.empty()) {
-		qreal data = reference_write.new_results.dequeue();
-		__write_reference_graph->AddValue(data);
+	return "Write speed: " + results_write.stats.Summary("MB/s") + "\n" +
+			"Block write time: " + results_write.histogram.Summary() + "\n" +
+			"Read speed: " + results_read.stats.Summary("MB/s") + "\n" +
+			"Block read time: " + results_read.histogram.Summary();
+}
+
+QList<Benchmark::Metric> FileRW::GetMetrics() {
+	QList<Metric> metrics;
+	if(results_write.stats.Count() > 0) {
+		metrics.append(Metric("Write speed", results_write.stats.Mean(), "MB/s", true));
+	}
+	if(results_read.stats.Count() > 0) {
+		metrics.append(Metric("Read speed", results_read.stats.Mean(), "MB/s", true));
 	}
 
-	// add new values to reference read graph
-	while(!reference_read.new_results.empty())
-	{
-		qreal data = reference_read.new_results.dequeue();
-		__read_reference_graph->AddValue(data);
+	// every cell of complete matrix
+	if(matrix.cells_done == File::OPEN_COUNT * FileRWMatrix::SIZES) {
+		for(int m = 0; m < File::OPEN_COUNT; ++m) {
+			for(int b = 0; b < FileRWMatrix::SIZES; ++b) {
+				if(matrix.write[m][b] < 0) {
+					continue;
+				}
+				QString name = File::OpenModeName((File::OpenMode)m) + " " + Def::FormatSize(FileRWMatrix::BlockSize(b));
+				metrics.append(Metric(name + " write", matrix.write[m][b], "MB/s", true));
+				metrics.append(Metric(name + " read", matrix.read[m][b], "MB/s", true));
+			}
+		}
 	}
 
-	// rescale graph
-	Rescale();
+	return metrics;
 }
 
-int FileRW::GetProgress() {
-	int done = results_read.blocks_done + results_write.blocks_done;
-	int blocks = results_write.blocks + results_read.blocks;
-	if(blocks) {
-		return (100 * done) / blocks;
-	} else {
-		return 0;
-	}
+FileRWMatrix::FileRWMatrix() {
+	erase();
 }
 
-FileRWResults::FileRWResults() {
-	avg = 0;
+hddsize FileRWMatrix::BlockSize(int index) {
+	return (4 * K) << index;
+}
+
+void FileRWMatrix::erase() {
+	for(int m = 0; m < File::OPEN_COUNT; ++m) {
+		for(int b = 0; b < SIZES; ++b) {
+			write[m][b] = 0;
+			read[m][b] = 0;
+		}
+	}
+	cells_done = 0;
+}
 
+FileRWResults::FileRWResults():
+		new_results(RING_SIZE) {
 	// zero block count
 	blocks = 0;
 	blocks_done = 0;
@@ -165,24 +245,21 @@ FileRWResults::FileRWResults() {
 void FileRWResults::AddResult(qreal result) {
 	// add to results
 	results.push_back(result);
-	// add to results to draw
-	new_results.enqueue(result);
+	// add to results to draw, never blocks measuring thread
+	new_results.Push(result);
 
-	// calc sum
-	qreal sum = 0;
-	for(int i = 0; i < results.size(); ++i) {
-		sum += results[i];
-	}
-	avg = sum / results.size();
+	// update statistics
+	stats.Add(result);
 }
 
 void FileRWResults::erase() {
 	// celar results
 	results.clear();
-	new_results.clear();
+	new_results.Clear();
 
 	// reset statistics
-	avg = 0;
+	stats.erase();
+	histogram.erase();
 
 	// zero block count
 	blocks = 0;
@@ -190,96 +267,151 @@ void FileRWResults::erase() {
 }
 
 
-QDomElement FileRW::WriteResults(QDomDocument &doc) {
+void FileRW::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("File_Read_Write");
-	master.setAttribute("valid", (GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("File_Read_Write");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("pattern", pattern.Name());
 
 	//// add write element
-	QDomElement write = doc.createElement("Write_data");
-	master.appendChild(write);
+	writer.StartElement("Write_data");
 
 	// add values to write element
 	if(GetProgress() == 100) for(int i = 0; i < results_write.results.size(); ++i) {
-		QDomElement value = doc.createElement("Write");
-		value.setAttribute("speed", results_write.results[i]);
-		write.appendChild(value);
+		writer.StartElement("Write");
+		writer.Attribute("speed", results_write.results[i]);
+		writer.EndElement();
+	}
+	if(GetProgress() == 100) {
+		results_write.histogram.Write(writer);
 	}
+	writer.EndElement();
 
 	// add read element
-	QDomElement read = doc.createElement("Read_data");
-	master.appendChild(read);
+	writer.StartElement("Read_data");
 
 	// add values to read element
 	if(GetProgress() == 100) for(int i = 0; i < results_read.results.size(); ++i) {
-		QDomElement value = doc.createElement("Read");
-		value.setAttribute("speed", results_read.results[i]);
-		read.appendChild(value);
+		writer.StartElement("Read");
+		writer.Attribute("speed", results_read.results[i]);
+		writer.EndElement();
 	}
+	if(GetProgress() == 100) {
+		results_read.histogram.Write(writer);
+	}
+	writer.EndElement();
+
+	// add matrix element
+	if(matrix.cells_done == File::OPEN_COUNT * FileRWMatrix::SIZES) {
+		writer.StartElement("Matrix");
+		for(int m = 0; m < File::OPEN_COUNT; ++m) {
+			for(int b = 0; b < FileRWMatrix::SIZES; ++b) {
+				writer.StartElement("Cell");
+				writer.Attribute("mode", File::OpenModeName((File::OpenMode)m));
+				writer.Attribute("block", FileRWMatrix::BlockSize(b));
+				writer.Attribute("write", matrix.write[m][b]);
+				writer.Attribute("read", matrix.read[m][b]);
+				writer.EndElement();
+			}
+		}
+		writer.EndElement();
+	}
+
+	sampler.Write(writer);
+	verifier.Write(writer);
 
-	return master;
+	writer.EndElement();
 }
 
-void FileRW::RestoreResults(QDomElement &results, DataSet dataset) {
+void FileRW::RestoreResults(const ResultElement &results, DataSet dataset) {
 	FileRWResults *res_write = (dataset == REFERENCE)?&reference_write:&results_write;
 	FileRWResults *res_read = (dataset == REFERENCE)?&reference_read:&results_read;
 
 	// Locate main fileRW element
-	QDomElement main = results.firstChildElement("File_Read_Write");
-	if(!main.attribute("valid", "no").compare("no"))
+	ResultElement main = results.Child("File_Read_Write");
+
+	// throughput samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+		verifier.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no"))
 		return;
 
 	// erase old results
 	res_write->erase();
 	res_read->erase();
-	(dataset == REFERENCE)?__write_reference_graph->erase():__write_graph->erase();
-	(dataset == REFERENCE)?__read_reference_graph->erase():__read_graph->erase();
+
+	// get Matrix
+	ResultElement xmlmatrix = main.Child("Matrix");
+	if(!xmlmatrix.IsNull()) {
+		FileRWMatrix &res_matrix = (dataset == REFERENCE)?reference_matrix:matrix;
+		res_matrix.erase();
+		ResultList cells = xmlmatrix.Children("Cell");
+		ResultColumn cell_modes = cells.Column("mode");
+		ResultColumn blocks = cells.Column("block");
+		ResultColumn cell_writes = cells.Column("write");
+		ResultColumn cell_reads = cells.Column("read");
+		for(int i = 0; i < cells.Size(); ++i) {
+			int m = 0;
+			while((m < File::OPEN_COUNT) && (File::OpenModeName((File::OpenMode)m) != cell_modes.Text(i))) {
+				++m;
+			}
+			int b = 0;
+			while((b < FileRWMatrix::SIZES) && (FileRWMatrix::BlockSize(b) != blocks.Integer(i))) {
+				++b;
+			}
+			if((m < File::OPEN_COUNT) && (b < FileRWMatrix::SIZES)) {
+				res_matrix.write[m][b] = cell_writes.Number(i);
+				res_matrix.read[m][b] = cell_reads.Number(i);
+			}
+		}
+		res_matrix.cells_done = File::OPEN_COUNT * FileRWMatrix::SIZES;
+	}
 
 	//// get Write
-	QDomElement write = main.firstChildElement("Write_data");
-	if(write.isNull())
+	ResultElement write = main.Child("Write_data");
+	if(write.IsNull())
 		return;
 	// get list of writes
-	QDomNodeList writes = write.elementsByTagName("Write");
-	res_write->blocks = writes.size();
+	ResultList writes = write.Children("Write");
+	ResultColumn write_speeds = writes.Column("speed");
+	res_write->blocks = writes.Size();
 	// read write result data
-	for(int i = 0; i < writes.size(); ++i)
-		res_write->AddResult(writes.at(i).toElement().attribute("speed", "0").toDouble());
+	for(int i = 0; i < writes.Size(); ++i)
+		res_write->AddResult(write_speeds.Number(i));
+	res_write->histogram.Read(write);
 
 	// get Read
-	QDomElement read = main.firstChildElement("Read_data");
-	if(write.isNull())
+	ResultElement read = main.Child("Read_data");
+	if(read.IsNull())
 		return;
 	// get list of reads
-	QDomNodeList reads = read.elementsByTagName("Read");
-	res_read->blocks = reads.size();
+	ResultList reads = read.Children("Read");
+	ResultColumn read_speeds = reads.Column("speed");
+	res_read->blocks = reads.Size();
 	// read result data
-	for(int i = 0; i < reads.size(); ++i)
-		res_read->AddResult(reads.item(i).toElement().attribute("speed", "0").toDouble());
+	for(int i = 0; i < reads.Size(); ++i)
+		res_read->AddResult(read_speeds.Number(i));
+	res_read->histogram.Read(read);
 
-	// set progress and update scene
+	// set progress
 	res_write->blocks_done = res_write->blocks;
 	res_read->blocks_done = res_read->blocks;
-	UpdateScene();
 }
 
 void FileRW::EraseResults(DataSet dataset) {
 	// erase data
 	if(dataset == RESULTS) {
+		sampler.erase();
+		verifier.erase();
 		results_read.erase();
 		results_write.erase();
-
-		__write_graph->erase();
-		__read_graph->erase();
+		matrix.erase();
 	} else {
 		reference_read.erase();
 		reference_write.erase();
-
-		__write_reference_graph->erase();
-		__read_reference_graph->erase();
+		reference_matrix.erase();
 	}
-
-	// resfresh view
-	UpdateScene();
 }
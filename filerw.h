@@ -21,8 +21,10 @@
 #pragma once
 
 #include "definitions.h"
-#include "testwidget.h"
+#include "benchmark.h"
 #include "file.h"
+#include "ring.h"
+#include "statistics.h"
 
 /// Stores FileRW benchmark resutls
 /** The FileRWResults class encapsules FileRW benchmark results.
@@ -31,11 +33,14 @@ class FileRWResults {
 public:
 	FileRWResults();	/// The constructor
 
+	static const int RING_SIZE = 1024;	/// capacity of new results ring
+
 	QList<qreal> results;		/// all colected results
-	QQueue<qreal> new_results;	/// new results to be drawn to graph
+	Ring<qreal> new_results;	/// new results to be drawn to graph
 	int blocks;					/// total blocks count
-	qreal avg;					/// average speed
+	Statistics stats;			/// speed statistics
 	int blocks_done;			/// blocks already done
+	Histogram histogram;		/// block latencies
 
 	/** Add new results
 	  @param result value to be added **/
@@ -43,14 +48,34 @@ public:
 	void erase();
 };
 
+/// Stores FileRW open mode by block size matrix
+/** FileRWMatrix keeps write and read speed of every open mode and block size
+measured in matrix mode. Speed of unsupported open mode is negative.
+  @see FileRW class **/
+class FileRWMatrix {
+public:
+	FileRWMatrix();	/// The constructor
+
+	static const int SIZES = 15;	/// Count of block sizes, 4 KiB to 64 MiB by powers of two
+
+	static hddsize BlockSize(int index);	/// Block size of size index
+
+	qreal write[File::OPEN_COUNT][SIZES];	/// Write speed in MB/s including final flush
+	qreal read[File::OPEN_COUNT][SIZES];	/// Read speed in MB/s
+	int cells_done;		/// Count of measured cells, modes run one after another
+
+	void erase();	/// Erase results
+};
+
 /// FileRW benchmark main class
 /** This class implemets file read - write test. The test writes
-file to safe temp an then reads it again. Both operations are
-visualised by line graph showing the speed.
-@see FileRWResults **/
-class FileRW : public TestWidget {
+file to safe temp an then reads it again. Speed of every block
+of both operations is kept.
+@see FileRWResults
+@see FileRWWidget **/
+class FileRW : public Benchmark {
 public:
-	FileRW(QWidget *parent = 0);	/// The constructor
+	FileRW(QObject *parent = 0);	/// The constructor
 	~FileRW();	/// The destructor
 
 	/// Count of bytes written and read to/from file.
@@ -59,34 +84,33 @@ public:
 	/// Block size by which file is written/read
 	static const hddsize FILERW_BLOCK = 4 * M;
 
+	/// Maximal count of bytes written and read by one matrix cell
+	static const hddsize MATRIX_CELL_SIZE = 256 * M;
+
+	/// Maximal time of writing or reading one matrix cell
+	static const hddtime MATRIX_CELL_TIME = 3 * s;
+
+	/// Benchmark modes
+	enum Mode { MODE_CLASSIC, MODE_MATRIX };
+
 	// members from Test
+	void InitResults();	/// Erases results before benchmark begins
 	void TestLoop();	/// Main benchmark code
-	void InitScene();	/// Initializes scene before benchmark begins
-	void UpdateScene();	/// Updates scene
 	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
 
 	FileRWResults results_write;	/// Results of write test
 	FileRWResults results_read;		/// Results of read test
 	FileRWResults reference_write;	/// Reference results for write test
 	FileRWResults reference_read;	/// Reference results for read test
+	FileRWMatrix matrix;			/// Results of matrix mode
+	FileRWMatrix reference_matrix;	/// Reference results of matrix mode
 
-	QDomElement WriteResults(QDomDocument &doc); /// Writes results of test to XML
-	void RestoreResults(QDomElement &root, DataSet dataset); /// Reads results from XML document
+	void WriteResults(ResultWriter &writer); /// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset); /// Reads results from result file
 	void EraseResults(DataSet dataset);	/// Erases selected results
 
 private:
-	bool __first;
-	qreal __last;
-
-	LineGraph *__read_graph;
-	LineGraph *__write_graph;
-	LineGraph *__read_reference_graph;
-	LineGraph *__write_reference_graph;
-
-	Net *__net;
-
-	Line *__avg_line;
-	Line *__max_line;
-
-	Legend *__legend;
+	void MatrixLoop(QString filename);	/// Runs matrix mode
 };
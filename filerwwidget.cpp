@@ -0,0 +1,148 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "filerwwidget.h"
+
+FileRWWidget::FileRWWidget(QWidget *parent) :
+	TestWidget(new FileRW(), parent), test(static_cast<FileRW*>(benchmark)) {
+	// Add two line graph components (reading + writting)
+	__read_graph = addLineGraph("MB/s", QColor(255, 192, 192));
+	__write_graph = addLineGraph("MB/s", QColor(255, 0, 0));
+
+	// Add two line graph components (reference reading + reference writting)
+	__read_reference_graph = addLineGraph("MB/s", QColor(192, 192, 255));
+	__write_reference_graph = addLineGraph("MB/s", QColor(0, 0, 255));
+
+	// Add block latency percentiles shown as block speed
+	__write_percentiles = addPercentiles("MB/s", QColor(255, 96, 0), true);
+	__read_percentiles = addPercentiles("MB/s", QColor(255, 160, 96), true);
+
+	// Add matrix graphs, one line per open mode over block sizes
+	const QColor write_colors[File::OPEN_COUNT] = {
+			QColor(255, 0, 0), QColor(255, 128, 0), QColor(192, 0, 128), QColor(128, 64, 0)};
+	const QColor reference_colors[File::OPEN_COUNT] = {
+			QColor(0, 0, 255), QColor(0, 128, 255), QColor(128, 0, 192), QColor(0, 64, 128)};
+	for(int i = 0; i < File::OPEN_COUNT; ++i) {
+		__matrix_read[i] = addLineGraph("MB/s", write_colors[i].lighter(160));
+		__matrix_write[i] = addLineGraph("MB/s", write_colors[i]);
+		__matrix_reference_read[i] = addLineGraph("MB/s", reference_colors[i].lighter(160));
+		__matrix_reference_write[i] = addLineGraph("MB/s", reference_colors[i]);
+	}
+
+	// Add background net
+	__net = addNet("MB/s", "File position", "Speed");
+
+	// Add legend
+	__legend = addLegend();
+	__legend->AddItem("Read", QColor(255, 192, 192));
+	__legend->AddItem("Write", QColor(255, 0, 0));
+	__legend->AddItem("Read", QColor(192, 192, 255));
+	__legend->AddItem("Write", QColor(0, 0, 255));
+	for(int i = 0; i < File::OPEN_COUNT; ++i) {
+		__legend->AddItem(File::OpenModeName((File::OpenMode)i), write_colors[i]);
+	}
+}
+
+void FileRWWidget::InitScene() {
+	// reset first value
+	__first = true;
+
+	// erase graphs
+	__read_graph->erase();
+	__write_graph->erase();
+}
+
+void FileRWWidget::UpdateScene() {
+	// set graph size
+	__write_graph->SetSize(test->results_write.blocks);
+	__read_graph->SetSize(test->results_read.blocks);
+	__write_reference_graph->SetSize(test->reference_write.blocks);
+	__read_reference_graph->SetSize(test->reference_read.blocks);
+
+	// add new values to write graph
+	qreal data;
+	while(test->results_write.new_results.Pop(data)) {
+		__write_graph->AddValue(data);
+	}
+
+	// add new values to read graph
+	while(test->results_read.new_results.Pop(data)) {
+		__read_graph->AddValue(data);
+	}
+
+	// add new values to reference write graph
+	while(test->reference_write.new_results.Pop(data)) {
+		__write_reference_graph->AddValue(data);
+	}
+
+	// add new values to reference read graph
+	while(test->reference_read.new_results.Pop(data)) {
+		__read_reference_graph->AddValue(data);
+	}
+
+	// matrix graphs are rebuilt from stored speeds
+	UpdateMatrix(test->matrix, __matrix_write, __matrix_read);
+	UpdateMatrix(test->reference_matrix, __matrix_reference_write, __matrix_reference_read);
+
+	// update percentiles
+	__write_percentiles->Set(Settled(test->results_write.histogram, Benchmark::RESULTS), FileRW::FILERW_BLOCK * us);
+	__read_percentiles->Set(Settled(test->results_read.histogram, Benchmark::RESULTS), FileRW::FILERW_BLOCK * us);
+
+	// rescale graph
+	Rescale();
+}
+
+void FileRWWidget::UpdateMatrix(const FileRWMatrix &data, LineGraph **write, LineGraph **read) {
+	for(int m = 0; m < File::OPEN_COUNT; ++m) {
+		write[m]->erase();
+		read[m]->erase();
+		write[m]->SetSize(FileRWMatrix::SIZES - 1);
+		read[m]->SetSize(FileRWMatrix::SIZES - 1);
+
+		// cells of mode are measured one after another
+		int done = qBound(0, data.cells_done - m * FileRWMatrix::SIZES, FileRWMatrix::SIZES);
+		for(int b = 0; b < done; ++b) {
+			qreal position = (qreal)b / (FileRWMatrix::SIZES - 1);
+			if(data.write[m][b] >= 0) {
+				write[m]->AddValue(data.write[m][b], position);
+				read[m]->AddValue(data.read[m][b], position);
+			}
+		}
+	}
+}
+
+void FileRWWidget::EraseResults(Benchmark::DataSet dataset) {
+	if(dataset == Benchmark::RESULTS) {
+		__write_graph->erase();
+		__read_graph->erase();
+	} else {
+		__write_reference_graph->erase();
+		__read_reference_graph->erase();
+	}
+
+	TestWidget::EraseResults(dataset);
+}
+
+void FileRWWidget::RestoreResults(const ResultElement &root, Benchmark::DataSet dataset) {
+	// restored values are added to empty graphs
+	(dataset == Benchmark::REFERENCE)?__write_reference_graph->erase():__write_graph->erase();
+	(dataset == Benchmark::REFERENCE)?__read_reference_graph->erase():__read_graph->erase();
+	TestWidget::RestoreResults(root, dataset);
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "filerw.h"
+
+/// FileRW benchmark widget
+/** Shows results of FileRW benchmark. Both write and read operations
+are visualised by line graph showing the speed, in matrix mode speed
+of every open mode by block size is drawn instead.
+@see FileRW class **/
+class FileRWWidget : public TestWidget {
+public:
+	FileRWWidget(QWidget *parent = 0);	/// The constructor
+
+	void InitScene();	/// Initializes scene before benchmark begins
+	void UpdateScene();	/// Updates scene
+	void EraseResults(Benchmark::DataSet dataset);	/// Erases selected results and their graphs
+	void RestoreResults(const ResultElement &root, Benchmark::DataSet dataset);	/// Reads results and redraws their graphs
+
+	FileRW *test;	/// Benchmark shown by widget
+
+private:
+	void UpdateMatrix(const FileRWMatrix &data, LineGraph **write, LineGraph **read);	/// Fills matrix graphs
+
+	bool __first;
+	qreal __last;
+
+	LineGraph *__read_graph;
+	LineGraph *__write_graph;
+	LineGraph *__read_reference_graph;
+	LineGraph *__write_reference_graph;
+
+	// matrix graphs of every open mode, speed by block size
+	LineGraph *__matrix_write[File::OPEN_COUNT];
+	LineGraph *__matrix_read[File::OPEN_COUNT];
+	LineGraph *__matrix_reference_write[File::OPEN_COUNT];
+	LineGraph *__matrix_reference_read[File::OPEN_COUNT];
+
+	Net *__net;
+
+	Line *__avg_line;
+	Line *__max_line;
+
+	Percentiles *__write_percentiles;
+	Percentiles *__read_percentiles;
+
+	Legend *__legend;
+};
@@ -20,53 +20,49 @@
 
 #include "filestructure.h"
 
-FileStructure::FileStructure(QWidget *parent):
-	TestWidget(parent) {
-	build_bar = this->addBar(				"s", "Structure build",		QColor(255,	0,	0),		0.1, 0.16);
-	build_reference_bar = this->addBar(		"s", "Structure build",		QColor(0,	0,	255),	0.31, 0.16);
-	destroy_bar = this->addBar(				"s", "Structure destroy",	QColor(255,	64,	0),		0.53, 0.16);
-	destroy_reference_bar = this->addBar(	"s", "Structure destroy",	QColor(0,	64,	255),	0.74, 0.16);
-
+FileStructure::FileStructure(QObject *parent):
+	Benchmark(parent), parallel(this, FILESTRUCTURE_SIZE, FILESTRUCTURE_SIZE, 0, 0) {
 	testName = "File structure";
 	testDescription = "File structure test creates random directory structure containing " +
 			QString::number(FILESTRUCTURE_SIZE) + " files and " + QString::number(FILESTRUCTURE_SIZE) +
 			" directories. Then this structure si deleted." +
 			" Construct and delete oprations times are shown in bar graph." +
-			" This test can only be performed on mounted filesystem.";
+			" This test can only be performed on mounted filesystem." +
+			" Operations are made by system calls relative to open parent directory," +
+			" legacy path mode uses absolute paths and Qt file operations instead.";
+	testDescription += parallel.Description();
+
+	AddMode("Sequential");
+	AddMode("Parallel");
+	AddMode("Sequential, legacy path");
 }
 
 void FileStructure::TestLoop() {
+	if(mode == MODE_PARALLEL) {
+		parallel.TestLoop();
+		return;
+	}
+
 	// init random
-	RandomGenerator random;
+	RandomGenerator random(seed);
 
-	// list of nodes in test
-	int counter = 1;
-	QList<QString> files;
-	QList<QString> nodes;
-	nodes.push_back(device->GetSafeTemp());	//	add initial node
+	// tree of nodes in test, node 0 is temp directory in which is test running
+	results.legacy = (mode == MODE_LEGACY);
+	FileTree tree(device, device->GetSafeTemp(), results.legacy);
 
 	// create structure
 	device->DropCaches();
 	results.phase = FileStructureResults::PHASE_BUILD;
+	device->timer.SetHistogram(&results.build_histogram);
 	while((results.build_files < FILESTRUCTURE_SIZE) || (results.build_dirs < FILESTRUCTURE_SIZE)) {
 		if((!(results.build_files < FILESTRUCTURE_SIZE)) || (random.Get32() % 2 == 0)) {
-			// construct new node name and path
-			QString name = QString::number(counter++);
-			QString path = nodes.at(random.Get64() % nodes.size());
-			nodes.push_back(path + "/" + name);
-
-			// create node
-			results.build += device->MkDir(path + "/" + name);
+			// create node in random directory
+			results.build += tree.MkDir(random.Below(tree.Dirs()));
 
 			++results.build_dirs;
 		} else {
-			// construct file name and path
-			QString name = QString::number(counter++);
-			QString path = nodes.at(random.Get64() % nodes.size());
-			files.push_back(path + "/" + name);
-
-			// create file
-			results.build += device->MkFile(path + "/" + name, 0);
+			// create file in random directory
+			results.build += tree.MkFile(random.Below(tree.Dirs()), 0);
 
 			++results.build_files;
 		}
@@ -75,79 +71,79 @@ void FileStructure::TestLoop() {
 			break;
 		}
 	}
-	results.build += device->Sync();
+	results.build_flush += device->Sync();
 
 	// make sure structure is not cached
 	device->DropCaches();
 	results.phase = FileStructureResults::PHASE_DESTROY;
+	device->timer.SetHistogram(&results.destroy_histogram);
 
 	// delete files
-	for(int i = 0; i < files.size(); ++i) {
-		results.destroy += device->DelFile(files[i]);
+	for(int i = 0; i < tree.Files(); ++i) {
+		results.destroy += tree.DelFile(i);
 		++results.destroyed;
 	}
-	results.destroy += device->Sync();
+	results.destroy_flush += device->Sync();
 
 	// delete dirs
 	// node 0 is temp directory in which is test running
-	for(int i = nodes.size() - 1; i > 0 ; --i) {
-		results.destroy += device->DelDir(nodes[i]);
+	for(int i = tree.Dirs() - 1; i > 0 ; --i) {
+		results.destroy += tree.DelDir(i);
 		++results.destroyed;
 	}
-	results.destroy += device->Sync();
+	results.destroy_flush += device->Sync();
 	results.done = true;
 	results.phase = FileStructureResults::PHASE_DONE;
+	device->timer.SetHistogram(NULL);
 
 	device->ClearSafeTemp();
 }
 
-void FileStructure::InitScene() {
-	results.erase();
+void FileStructure::InitResults() {
+	if(mode == MODE_PARALLEL) {
+		parallel.EraseResults(RESULTS);
+	} else {
+		results.erase();
+	}
 }
 
-void FileStructure::UpdateScene() {
-	// get result progress
-	hddtime build = results.build;
-	hddtime destroy = results.destroy;
-
-	// add current operation progress
-	if(device) {
-		if(results.phase == FileStructureResults::PHASE_BUILD) {
-			build += device->timer.GetCurrentOffset();
-		} else if (results.phase == FileStructureResults::PHASE_DESTROY) {
-			destroy += device->timer.GetCurrentOffset();
-		}
+int FileStructure::GetProgress() {
+	if(mode == MODE_PARALLEL) {
+		return parallel.GetProgress();
 	}
 
-	// update result bars
-	build_bar->Set(
-			(100 * (results.build_dirs + results.build_files)) / (2 * FILESTRUCTURE_SIZE),
-			(qreal) build / s);
-
-	destroy_bar->Set(
-			100 * results.destroyed / (2 * FILESTRUCTURE_SIZE),
-			(qreal)destroy / s) ;
-
-	// update reference bars
-	build_reference_bar->Set(
-			(100 * (reference.build_dirs + reference.build_files)) / (2 * FILESTRUCTURE_SIZE),
-			(qreal)reference.build / s);
-
-	destroy_reference_bar->Set(
-			100 * reference.destroyed / (2 * FILESTRUCTURE_SIZE),
-			(qreal)reference.destroy / s) ;
-
-	// rescale
-	Rescale();
+	return GetSequentialProgress();
 }
 
-int FileStructure::GetProgress() {
+int FileStructure::GetSequentialProgress() {
 	// do not show 100% until done
 	int state = results.build_files + results.build_dirs + results.destroyed + results.done;
 	int target = 4 * FILESTRUCTURE_SIZE;
 	return (100 * state) / target;
 }
 
+QString FileStructure::GetSummary() {
+	if(mode == MODE_PARALLEL) {
+		return parallel.GetSummary();
+	}
+
+	return QString("Path: ") + (results.legacy?"legacy":"syscall") + "\n" +
+			"Structure build: " + Def::FormatTime(results.build) + ", " + results.build_histogram.Summary() + "\n" +
+			"Structure destroy: " + Def::FormatTime(results.destroy) + ", " + results.destroy_histogram.Summary() + "\n" +
+			"Flush: " + Def::FormatTime(results.build_flush + results.destroy_flush);
+}
+
+QList<Benchmark::Metric> FileStructure::GetMetrics() {
+	QList<Metric> metrics;
+	if(GetSequentialProgress() == 100) {
+		metrics.append(Metric("Structure build", (qreal)results.build / s, "s", false));
+		metrics.append(Metric("Structure destroy", (qreal)results.destroy / s, "s", false));
+		metrics.append(Metric("Flush", (qreal)(results.build_flush + results.destroy_flush) / s, "s", false));
+	}
+
+	return metrics + parallel.GetMetrics();
+}
+
 FileStructureResults::FileStructureResults() {
 	erase();
 }
@@ -159,70 +155,101 @@ void FileStructureResults::erase() {
 
 	destroy = 0.0f;
 	build = 0.0f;
+	build_flush = 0;
+	destroy_flush = 0;
+
+	build_histogram.erase();
+	destroy_histogram.erase();
 
 	done = false;
+	legacy = false;
 	phase = PHASE_NONE;
 }
 
-QDomElement FileStructure::WriteResults(QDomDocument &doc) {
+void FileStructure::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("File_Structure");
-	master.setAttribute("valid", (GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("File_Structure");
+	writer.Attribute("valid", (GetSequentialProgress() == 100)?"yes":"no");
+	writer.Attribute("path", results.legacy?"legacy":"syscall");
+	writer.Attribute("seed", seed);
 
 	// add build element
-	QDomElement build = doc.createElement("Build");
-	build.setAttribute("time", results.build);
-	master.appendChild(build);
+	writer.StartElement("Build");
+	writer.Attribute("time", results.build);
+	writer.Attribute("flush", results.build_flush);
+	results.build_histogram.Write(writer);
+	writer.EndElement();
 
 	// add destroy element
-	QDomElement destroy = doc.createElement("Destroy");
-	destroy.setAttribute("time", results.destroy);
-	master.appendChild(destroy);
+	writer.StartElement("Destroy");
+	writer.Attribute("time", results.destroy);
+	writer.Attribute("flush", results.destroy_flush);
+	results.destroy_histogram.Write(writer);
+	writer.EndElement();
+
+	// add parallel mode results
+	parallel.WriteResults(writer);
+
+	sampler.Write(writer);
 
-	return master;
+	writer.EndElement();
 }
 
-void FileStructure::RestoreResults(QDomElement &results, DataSet dataset) {
+void FileStructure::RestoreResults(const ResultElement &results, DataSet dataset) {
 	FileStructureResults *res = (dataset == REFERENCE)?&this->reference:&this->results;
 
 	// Locate main seek element
-	QDomElement main = results.firstChildElement("File_Structure");
-	if(!main.attribute("valid", "no").compare("no")) {
+	ResultElement main = results.Child("File_Structure");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+	}
+
+	// parallel mode results are valid on their own
+	parallel.RestoreResults(main, dataset);
+
+	if(!main.Attribute("valid", "no").compare("no")) {
 		return;
 	}
 
-	// init scene and remove results
+	// remove results
 	res->erase();
+	hddtime unit = Def::StoredTimeUnit(main);
+
+	// results without path were measured by legacy path
+	res->legacy = (main.Attribute("path", "legacy") == "legacy");
 
 	//// get Build
-	QDomElement build = main.firstChildElement("Build");
-	if(build.isNull()) {
+	ResultElement build = main.Child("Build");
+	if(build.IsNull()) {
 		return;
 	}
-	res->build = build.attribute("time", "0").toDouble();
+	res->build = build.Number("time") * unit;
+	res->build_flush = build.Number("flush") * unit;
+	res->build_histogram.Read(build);
 
 	//// get Destroy
-	QDomElement destroy = main.firstChildElement("Destroy");
-	if(destroy.isNull()) {
+	ResultElement destroy = main.Child("Destroy");
+	if(destroy.IsNull()) {
 		return;
 	}
-	res->destroy = destroy.attribute("time", "0").toDouble();
+	res->destroy = destroy.Number("time") * unit;
+	res->destroy_flush = destroy.Number("flush") * unit;
+	res->destroy_histogram.Read(destroy);
 
-	// set progress and update scene
+	// set progress
 	res->build_dirs = FILESTRUCTURE_SIZE;
 	res->build_files = FILESTRUCTURE_SIZE;
 	res->destroyed = FILESTRUCTURE_SIZE * 2;
-
-	UpdateScene();
 }
 
 void FileStructure::EraseResults(DataSet dataset) {
 	if(dataset == RESULTS) {
+		sampler.erase();
 		results.erase();
 	} else {
 		reference.erase();
 	}
-
-	UpdateScene();
+	parallel.EraseResults(dataset);
 }
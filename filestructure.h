@@ -20,8 +20,10 @@
 
 #pragma once
 
-#include "testwidget.h"
+#include "benchmark.h"
 #include "randomgenerator.h"
+#include "parallelmetadata.h"
+#include "filetree.h"
 
 /// Stores FileRW benchmark results
 /** FileStructureResults class encapsulates Structure benchmark results
@@ -39,37 +41,48 @@ public:
 	int destroyed;		/// Count of deleted files and directories
 	Phase phase;		/// Phase of the benchmark
 	bool done;			/// Whenever the benchmark has finished
+	bool legacy;		/// Whenever absolute path Qt operations were used
 
 	hddtime build;		/// Time needed to create files and directories
 	hddtime destroy;	/// Time
+	hddtime build_flush;	/// Filesystem flush time after build
+	hddtime destroy_flush;	/// Filesystem flush time after destroy
+
+	Histogram build_histogram;		/// File and directory create latencies
+	Histogram destroy_histogram;	/// File and directory delete latencies
 };
 
 /// FileRW benchmark main class
 /** This class implements File Structure test. The test build dirs
-and files in a huge structure and draw bar graphs with operation times.
-@see FileStructureResults class **/
-class FileStructure : public TestWidget {
+and files in a huge structure and measures operation times.
+In parallel mode the structure is split between several threads instead.
+@see FileStructureResults class
+@see ParallelMetadata class
+@see FileStructureWidget class **/
+class FileStructure : public Benchmark {
 public:
-	FileStructure(QWidget *parent = 0);	/// The constructore
+	FileStructure(QObject *parent = 0);	/// The constructore
 
 	/// Size of the structure used for benchmarking
 	static const hddsize FILESTRUCTURE_SIZE = 1000;
 
+	/// Benchmark modes
+	enum Mode { MODE_SEQUENTIAL, MODE_PARALLEL, MODE_LEGACY };
+
+	void InitResults();	/// Erases results before benchmark begins
 	void TestLoop();	/// Main benchmark code
-	void InitScene();	/// Initializes scene before benchmark begins
-	void UpdateScene();	/// Updates scene
 	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
 
 	FileStructureResults results;	/// Primary results
 	FileStructureResults reference;	/// reference results
+	ParallelMetadata parallel;		/// Parallel mode results
 
-	QDomElement WriteResults(QDomDocument &doc);				/// Writes results of test to XML
-	void RestoreResults(QDomElement &root, DataSet dataset);	/// Reads results from XML document
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
 	void EraseResults(DataSet dataset);							/// Erases selected results
 
 private:
-	Bar *build_bar;
-	Bar *destroy_bar;
-	Bar *build_reference_bar;
-	Bar *destroy_reference_bar;
+	int GetSequentialProgress();	/// Returns sequential mode progress
 };
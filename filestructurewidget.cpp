@@ -0,0 +1,82 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "filestructurewidget.h"
+
+FileStructureWidget::FileStructureWidget(QWidget *parent):
+	TestWidget(new FileStructure(), parent), test(static_cast<FileStructure*>(benchmark)),
+	parallel(this, &test->parallel) {
+	build_bar = this->addBar(				"s", "Structure build",		QColor(255,	0,	0),		0.1, 0.16);
+	build_reference_bar = this->addBar(		"s", "Structure build",		QColor(0,	0,	255),	0.31, 0.16);
+	destroy_bar = this->addBar(				"s", "Structure destroy",	QColor(255,	64,	0),		0.53, 0.16);
+	destroy_reference_bar = this->addBar(	"s", "Structure destroy",	QColor(0,	64,	255),	0.74, 0.16);
+}
+
+void FileStructureWidget::InitScene() {}
+
+void FileStructureWidget::UpdateScene() {
+	// get result progress
+	hddtime build = test->results.build;
+	hddtime destroy = test->results.destroy;
+
+	// add current operation progress
+	if(test->device) {
+		if(test->results.phase == FileStructureResults::PHASE_BUILD) {
+			build += test->device->timer.GetCurrentOffset();
+		} else if (test->results.phase == FileStructureResults::PHASE_DESTROY) {
+			destroy += test->device->timer.GetCurrentOffset();
+		}
+	}
+
+	// sequential bars are hidden in parallel mode
+	bool sequential = (test->mode != FileStructure::MODE_PARALLEL);
+	build_bar->SetVisible(sequential);
+	destroy_bar->SetVisible(sequential);
+	build_reference_bar->SetVisible(sequential);
+	destroy_reference_bar->SetVisible(sequential);
+	parallel.UpdateScene(!sequential);
+
+	// update result bars
+	build_bar->Set(
+			(100 * (test->results.build_dirs + test->results.build_files)) / (2 * FileStructure::FILESTRUCTURE_SIZE),
+			(qreal) build / s);
+
+	destroy_bar->Set(
+			100 * test->results.destroyed / (2 * FileStructure::FILESTRUCTURE_SIZE),
+			(qreal)destroy / s) ;
+
+	// update reference bars
+	build_reference_bar->Set(
+			(100 * (test->reference.build_dirs + test->reference.build_files)) / (2 * FileStructure::FILESTRUCTURE_SIZE),
+			(qreal)test->reference.build / s);
+
+	destroy_reference_bar->Set(
+			100 * test->reference.destroyed / (2 * FileStructure::FILESTRUCTURE_SIZE),
+			(qreal)test->reference.destroy / s) ;
+
+	// show p99 operation latency with phase name
+	build_bar->SetName("Structure build\np99 " + Def::FormatTime(Settled(test->results.build_histogram, Benchmark::RESULTS).Percentile(99)));
+	destroy_bar->SetName("Structure destroy\np99 " + Def::FormatTime(Settled(test->results.destroy_histogram, Benchmark::RESULTS).Percentile(99)));
+	build_reference_bar->SetName("Structure build\np99 " + Def::FormatTime(Settled(test->reference.build_histogram, Benchmark::REFERENCE).Percentile(99)));
+	destroy_reference_bar->SetName("Structure destroy\np99 " + Def::FormatTime(Settled(test->reference.destroy_histogram, Benchmark::REFERENCE).Percentile(99)));
+
+	// rescale
+	Rescale();
+}
@@ -0,0 +1,174 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "filetree.h"
+
+#include <sys/resource.h>
+
+FileTree::FileTree(Device *device, QString root, bool legacy):
+	device(device), legacy(legacy), counter(1) {
+	// every directory is kept open, use all descriptors process can get
+	rlimit limit;
+	if(!legacy && !getrlimit(RLIMIT_NOFILE, &limit) && (limit.rlim_cur < limit.rlim_max)) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	// root is directory 0
+	Node node;
+	node.parent = -1;
+	node.path = root.toUtf8();
+	node.name = node.path;
+	node.fd = legacy?-1:device->OpenDirAt(AT_FDCWD, node.path.constData());
+	dirs.push_back(node);
+
+	// file data buffer is allocated before timed operations
+	device->PrepareBuffer(Device::FILE_BUFFER_SIZE);
+	device->PrepareWriteBuffer(Device::FILE_BUFFER_SIZE);
+}
+
+FileTree::~FileTree() {
+	for(int i = 0; i < dirs.size(); ++i) {
+		if(dirs[i].fd >= 0) {
+			close(dirs[i].fd);
+		}
+	}
+}
+
+int FileTree::Dirs() {
+	return dirs.size();
+}
+
+int FileTree::Files() {
+	return files.size();
+}
+
+int FileTree::DirFd(const Node &node, const char **name) {
+	// relative to open parent, absolute path otherwise
+	const Node &parent = dirs[node.parent];
+	if(parent.fd >= 0) {
+		*name = node.name.constData();
+		return parent.fd;
+	}
+
+	*name = node.path.constData();
+	return AT_FDCWD;
+}
+
+hddtime FileTree::MkDir(int parent) {
+	Node node;
+	node.parent = parent;
+	node.name = QByteArray::number(counter++);
+	node.path = dirs[parent].path + "/" + node.name;
+	node.fd = -1;
+
+	hddtime time;
+	if(legacy) {
+		time = device->MkDir(QString::fromUtf8(node.path));
+	} else {
+		const char *name;
+		int fd = DirFd(node, &name);
+		time = device->MkDirAt(fd, name);
+
+		// keep new directory open for its entries, not part of operation time
+		node.fd = device->OpenDirAt(fd, name);
+	}
+
+	dirs.push_back(node);
+	return time;
+}
+
+hddtime FileTree::MkFile(int parent, hddsize size) {
+	Node node;
+	node.parent = parent;
+	node.name = QByteArray::number(counter++);
+	node.path = dirs[parent].path + "/" + node.name;
+	node.fd = -1;
+
+	hddtime time;
+	if(legacy) {
+		time = device->MkFile(QString::fromUtf8(node.path), size);
+	} else {
+		const char *name;
+		int fd = DirFd(node, &name);
+		time = device->MkFileAt(fd, name, size);
+	}
+
+	files.push_back(node);
+	return time;
+}
+
+hddtime FileTree::StatDir(int index) {
+	if(legacy) {
+		return device->StatFile(QString::fromUtf8(dirs[index].path));
+	}
+
+	const char *name;
+	int fd = DirFd(dirs[index], &name);
+	return device->StatAt(fd, name);
+}
+
+hddtime FileTree::StatFile(int index) {
+	if(legacy) {
+		return device->StatFile(QString::fromUtf8(files[index].path));
+	}
+
+	const char *name;
+	int fd = DirFd(files[index], &name);
+	return device->StatAt(fd, name);
+}
+
+hddtime FileTree::ReadFile(int index) {
+	if(legacy) {
+		return device->ReadFile(QString::fromUtf8(files[index].path));
+	}
+
+	const char *name;
+	int fd = DirFd(files[index], &name);
+	return device->ReadFileAt(fd, name);
+}
+
+hddtime FileTree::DelFile(int index) {
+	if(legacy) {
+		return device->DelFile(QString::fromUtf8(files[index].path));
+	}
+
+	const char *name;
+	int fd = DirFd(files[index], &name);
+	return device->DelFileAt(fd, name);
+}
+
+hddtime FileTree::DelDir(int index) {
+	Node &node = dirs[index];
+
+	// directory is not used any more
+	if(node.fd >= 0) {
+		close(node.fd);
+		node.fd = -1;
+	}
+
+	if(legacy) {
+		return device->DelDir(QString::fromUtf8(node.path));
+	}
+
+	const char *name;
+	int fd = DirFd(node, &name);
+	return device->DelDirAt(fd, name);
+}
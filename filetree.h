@@ -0,0 +1,84 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+
+#include "device.h"
+
+/// Directory tree used by filesystem benchmarks
+/** FileTree creates, stats, reads and deletes directories and files of random
+tree built in existing root directory. Entries are identified by index, the
+root is directory 0. Names are numbers formatted when entry is created, so
+the timed operation is just the system call.
+
+By default directories are kept open and operations use openat, mkdirat,
+fstatat and unlinkat relative to the parent directory descriptor. Directories
+that cannot be kept open (descriptor limit) are accessed by absolute path.
+Legacy tree uses the original absolute path Qt operations of Device instead,
+so both costs can be compared. **/
+class FileTree {
+public:
+	/** Prepares empty tree
+	  @param device device used for timed operations
+	  @param root existing root directory
+	  @param legacy whenever absolute path Qt operations are used **/
+	FileTree(Device *device, QString root, bool legacy);
+	~FileTree();	/// Closes directory descriptors
+
+	int Dirs();		/// Count of directories including root
+	int Files();	/// Count of files
+
+	/** Create directory
+	  @param parent index of parent directory
+	  @return operation time **/
+	hddtime MkDir(int parent);
+
+	/** Create file
+	  @param parent index of parent directory
+	  @param size file size
+	  @return operation time **/
+	hddtime MkFile(int parent, hddsize size);
+
+	hddtime StatDir(int index);		/// Read directory attributes and return operation time
+	hddtime StatFile(int index);	/// Read file attributes and return operation time
+	hddtime ReadFile(int index);	/// Read whole file and return operation time
+	hddtime DelFile(int index);		/// Delete file and return operation time
+	hddtime DelDir(int index);		/// Delete empty directory and return operation time
+
+private:
+	struct Node {
+		int parent;			// index of parent directory
+		QByteArray name;	// name in parent directory
+		QByteArray path;	// absolute path
+		int fd;				// directory descriptor or -1
+	};
+
+	int DirFd(const Node &node, const char **name);	// descriptor and name used for relative operation
+
+	Device *device;
+	bool legacy;
+	int counter;
+	QVector<Node> dirs;
+	QVector<Node> files;
+};
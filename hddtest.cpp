@@ -24,8 +24,9 @@
 #include "hddtest.h"
 #include "ui_hddtest.h"
 
+#include "comparedialog.h"
 #include "testwidget.h"
-#include "seeker.h"
+#include "seekerwidget.h"
 
 
 HDDTestWidget::HDDTestWidget(QWidget *parent) :
@@ -49,8 +50,13 @@ HDDTestWidget::HDDTestWidget(QWidget *parent) :
 	ui->readblockwidget->SetDevice(&device);
 	ui->readcontwidget->SetDevice(&device);
 	ui->readrndwidget->SetDevice(&device);
+	ui->readthreadswidget->SetDevice(&device);
 	ui->seekwidget->SetDevice(&device);
+	ui->mixedwidget->SetDevice(&device);
 	ui->smallfileswidget->SetDevice(&device);
+	ui->writeblockwidget->SetDevice(&device);
+	ui->writecontwidget->SetDevice(&device);
+	ui->writerndwidget->SetDevice(&device);
 
 	// set icons to buttons
 	ui->open->setIcon(QIcon::fromTheme("document-open", QIcon("icon:/icon/document-open.png")));
@@ -67,15 +73,15 @@ void HDDTestWidget::on_drive_currentIndexChanged(QString) {
 
 	switch(data.value<Device::Item>().type) {
     case Device::Item::Type::DEVICE:
-		EraseResults(TestWidget::RESULTS);
+		EraseResults(Benchmark::RESULTS);
         device.Open(data.value<Device::Item>(), true);
 		ReloadTests(false);
 		break;
 
     case Device::Item::Type::RESULT:
         device.Open(data.value<Device::Item>(), true);
-		EraseResults(TestWidget::RESULTS);
-		OpenResultFile(data.value<Device::Item>().path, TestWidget::RESULTS);
+		EraseResults(Benchmark::RESULTS);
+		OpenResultFile(data.value<Device::Item>().path, Benchmark::RESULTS);
 		ReloadTests(true);
 		break;
 
@@ -92,14 +98,14 @@ void HDDTestWidget::on_reference_currentIndexChanged(QString ) {
 	switch(data.value<Device::Item>().type) {
     case Device::Item::Type::RESULT:
         refDevice.Open(data.value<Device::Item>(), true);
-		EraseResults(TestWidget::REFERENCE);
-		OpenResultFile(data.value<Device::Item>().path, TestWidget::REFERENCE);
-		UpdateInfo(TestWidget::REFERENCE);
+		EraseResults(Benchmark::REFERENCE);
+		OpenResultFile(data.value<Device::Item>().path, Benchmark::REFERENCE);
+		UpdateInfo(Benchmark::REFERENCE);
 		break;
 
     case Device::Item::Type::NOTHING:
-		EraseResults(TestWidget::REFERENCE);
-		UpdateInfo(TestWidget::REFERENCE);
+		EraseResults(Benchmark::REFERENCE);
+		UpdateInfo(Benchmark::REFERENCE);
 		break;
 
 	default:
@@ -130,34 +136,54 @@ void HDDTestWidget::device_accessWarning() {
 
 void HDDTestWidget::device_operationError() {
 	bool running = false;
-	if(ui->filerwwidget->testState == TestWidget::STARTED) {
+	if(ui->filerwwidget->benchmark->testState == Benchmark::STARTED) {
 		ui->filerwwidget->StopTest();
 		running = true;
 	}
-	if(ui->filestructurewidget->testState == TestWidget::STARTED) {
+	if(ui->filestructurewidget->benchmark->testState == Benchmark::STARTED) {
 		ui->filestructurewidget->StopTest();
 		running = true;
 	}
-	if(ui->readblockwidget->testState == TestWidget::STARTED) {
+	if(ui->readblockwidget->benchmark->testState == Benchmark::STARTED) {
 		ui->readblockwidget->StopTest();
 		running = true;
 	}
-	if(ui->readcontwidget->testState == TestWidget::STARTED) {
+	if(ui->readcontwidget->benchmark->testState == Benchmark::STARTED) {
 		ui->readcontwidget->StopTest();
 		running = true;
 	}
-	if(ui->readrndwidget->testState == TestWidget::STARTED) {
+	if(ui->readrndwidget->benchmark->testState == Benchmark::STARTED) {
 		ui->readrndwidget->StopTest();
 		running = true;
 	}
-	if(ui->seekwidget->testState == TestWidget::STARTED) {
+	if(ui->readthreadswidget->benchmark->testState == Benchmark::STARTED) {
+		ui->readthreadswidget->StopTest();
+		running = true;
+	}
+	if(ui->seekwidget->benchmark->testState == Benchmark::STARTED) {
 		ui->seekwidget->StopTest();
 		running = true;
 	}
-	if(ui->smallfileswidget->testState == TestWidget::STARTED) {
+	if(ui->smallfileswidget->benchmark->testState == Benchmark::STARTED) {
 		ui->smallfileswidget->StopTest();
 		running = true;
 	}
+	if(ui->mixedwidget->benchmark->testState == Benchmark::STARTED) {
+		ui->mixedwidget->StopTest();
+		running = true;
+	}
+	if(ui->writeblockwidget->benchmark->testState == Benchmark::STARTED) {
+		ui->writeblockwidget->StopTest();
+		running = true;
+	}
+	if(ui->writecontwidget->benchmark->testState == Benchmark::STARTED) {
+		ui->writecontwidget->StopTest();
+		running = true;
+	}
+	if(ui->writerndwidget->benchmark->testState == Benchmark::STARTED) {
+		ui->writerndwidget->StopTest();
+		running = true;
+	}
 
 	if(running) {
 		QMessageBox box;
@@ -176,8 +202,8 @@ void HDDTestWidget::device_operationError() {
 
 void HDDTestWidget::refDevice_accessWarning() {}
 
-void HDDTestWidget::UpdateInfo(TestWidget::DataSet dataset) {
-	if(dataset == TestWidget::RESULTS) {
+void HDDTestWidget::UpdateInfo(Benchmark::DataSet dataset) {
+	if(dataset == Benchmark::RESULTS) {
 		// update info tab - tested device
 		ui->model->setText(device.model);
 		ui->serial->setText(device.serial);
@@ -187,7 +213,7 @@ void HDDTestWidget::UpdateInfo(TestWidget::DataSet dataset) {
 		ui->fstype->setText(device.fstype);
 		ui->fsoptions->setText(device.fsoptions);
 		ui->kernel->setText(device.kernel);
-	} else if(dataset == TestWidget::REFERENCE) {
+	} else if(dataset == Benchmark::REFERENCE) {
 		// update info tab - reference devices
 		ui->reference_model->setText(refDevice.model);
 		ui->reference_serial->setText(refDevice.serial);
@@ -207,22 +233,32 @@ void HDDTestWidget::ReloadTests(bool loaded) {
 	bool fs = device.fs;
 	bool valid = device.size > 0;
 
-	UpdateInfo(TestWidget::RESULTS);
+	UpdateInfo(Benchmark::RESULTS);
 
 	// Raw device test
 	ui->readblockwidget->SetStartEnabled(!loaded && valid);
 	ui->readcontwidget->SetStartEnabled(!loaded && valid);
 	ui->readrndwidget->SetStartEnabled(!loaded && valid);
+	ui->readthreadswidget->SetStartEnabled(!loaded && valid);
 	ui->seekwidget->SetStartEnabled(!loaded && valid);
 
 	// Filesystem tests
 	ui->smallfileswidget->SetStartEnabled(!loaded && fs);
 	ui->filerwwidget->SetStartEnabled(!loaded && fs);
 	ui->filestructurewidget->SetStartEnabled(!loaded && fs);
+
+	// Destructive raw device tests, only for devices without filesystem mounted
+	ui->writeblockwidget->SetStartEnabled(!loaded && valid && !fs);
+	ui->writecontwidget->SetStartEnabled(!loaded && valid && !fs);
+	ui->writerndwidget->SetStartEnabled(!loaded && valid && !fs);
+
+	// Mixed workload uses file on filesystem and overwrites raw device otherwise
+	ui->mixedwidget->benchmark->SetDestructive(!fs);
+	ui->mixedwidget->SetStartEnabled(!loaded && valid);
 }
 
-void HDDTestWidget::EraseResults(TestWidget::DataSet dataset) {
-	if(dataset == TestWidget::RESULTS) {
+void HDDTestWidget::EraseResults(Benchmark::DataSet dataset) {
+	if(dataset == Benchmark::RESULTS) {
 		device.EraseDriveInfo();
 	} else {
 		refDevice.EraseDriveInfo();
@@ -231,39 +267,52 @@ void HDDTestWidget::EraseResults(TestWidget::DataSet dataset) {
 	ui->readblockwidget->EraseResults(dataset);
 	ui->readcontwidget->EraseResults(dataset);
 	ui->readrndwidget->EraseResults(dataset);
+	ui->readthreadswidget->EraseResults(dataset);
 	ui->seekwidget->EraseResults(dataset);
 	ui->smallfileswidget->EraseResults(dataset);
+	ui->mixedwidget->EraseResults(dataset);
 	ui->filerwwidget->EraseResults(dataset);
 	ui->filestructurewidget->EraseResults(dataset);
+	ui->writeblockwidget->EraseResults(dataset);
+	ui->writecontwidget->EraseResults(dataset);
+	ui->writerndwidget->EraseResults(dataset);
 }
 
 void HDDTestWidget::on_save_clicked() {
-	QString filename = QFileDialog::getSaveFileName(this, tr("Save results"), "", tr("Results (*.hddtest)"));
+	QString filename = QFileDialog::getSaveFileName(this, tr("Save results"), "", ResultWriter::Filter());
 	if(filename.length() > 0) {
-		// Create base document for tests results
-		QDomDocument doc("HddTest");
+		QFile file(filename);
+		if(!file.open(QIODevice::WriteOnly)) {
+			std::cerr << "Cannot open results file" << std::endl;
+			return;
+		}
+
+		// results are streamed to file, format is selected by suffix
+		QScopedPointer<ResultWriter> writer(ResultWriter::Create(&file, filename));
+		writer->StartDocument();
 
 		// Create base element
-		QDomElement results = doc.createElement("Results");
-		doc.appendChild(results);
+		writer->StartElement("Results");
+		writer->Attribute("timeunit", "ns");
 
 		// save drive info
-		results.appendChild(device.WriteInfo(doc));
+		device.WriteInfo(*writer);
 
 		// save tests results
-		results.appendChild(ui->filerwwidget->WriteResults(doc));
-		results.appendChild(ui->filestructurewidget->WriteResults(doc));
-		results.appendChild(ui->readblockwidget->WriteResults(doc));
-		results.appendChild(ui->readcontwidget->WriteResults(doc));
-		results.appendChild(ui->readrndwidget->WriteResults(doc));
-		results.appendChild(ui->seekwidget->WriteResults(doc));
-		results.appendChild(ui->smallfileswidget->WriteResults(doc));
-
-		// write document to file
-		QFile file(filename);
-		file.open(QIODevice::WriteOnly);
-		QTextStream stream(&file);
-		stream << doc.toString();
+		ui->filerwwidget->WriteResults(*writer);
+		ui->filestructurewidget->WriteResults(*writer);
+		ui->readblockwidget->WriteResults(*writer);
+		ui->readcontwidget->WriteResults(*writer);
+		ui->readrndwidget->WriteResults(*writer);
+		ui->readthreadswidget->WriteResults(*writer);
+		ui->seekwidget->WriteResults(*writer);
+		ui->smallfileswidget->WriteResults(*writer);
+		ui->mixedwidget->WriteResults(*writer);
+		ui->writeblockwidget->WriteResults(*writer);
+		ui->writecontwidget->WriteResults(*writer);
+		ui->writerndwidget->WriteResults(*writer);
+
+		writer->EndDocument();
 		file.close();
 	}
 }
@@ -273,7 +322,7 @@ void HDDTestWidget::on_open_clicked() {
 				this,
 				tr("Open Saved results"),
 				"",
-				tr("Results (*.hddtest)"));
+				tr("Results (*.hddtest *.hddbin)"));
 
 	if(!filename.isNull()) {
 		// add open result to drive selection
@@ -296,60 +345,68 @@ void HDDTestWidget::on_about_clicked() {
 	about.exec();
 }
 
-void HDDTestWidget::OpenResultFile(QString filename, TestWidget::DataSet dataset) {
+void HDDTestWidget::on_compare_clicked() {
+	CompareDialog compare(this);
+	compare.exec();
+}
+
+void HDDTestWidget::OpenResultFile(QString filename, Benchmark::DataSet dataset) {
 	if(filename.length() == 0) {
 		std::cerr << "WARNING: no filename given for results file" << std::endl;
 		return;
 	}
 
-	// open file
-	QFile file(filename);
-	if(!file.open(QIODevice::ReadOnly)) {
-		std::cerr << "Cannot open results file" << std::endl;
-		file.close();
-		return;
-	}
-
-	// Open document
-	QDomDocument doc("HddTest");
-	QString err;
-	int row,col;
-	if(!doc.setContent(&file, &err, &row, &col)) {
-		file.close();
-		std::cerr << "Cannot set XML document context to file" << std::endl;
+	// open file, binary results are mapped and XML results converted
+	ResultFile file;
+	if(!file.Open(filename)) {
+		std::cerr << "Cannot open results file: " << qPrintable(file.Error()) << std::endl;
 		return;
 	}
-	file.close();
-	QDomElement root = doc.documentElement();
+	ResultElement root = file.Root();
 
 	// restore device info
-	(dataset == TestWidget::REFERENCE)?refDevice.ReadInfo(root):device.ReadInfo(root);
+	(dataset == Benchmark::REFERENCE)?refDevice.ReadInfo(root):device.ReadInfo(root);
 	// restore tests result
 	ui->seekwidget->RestoreResults(root, dataset);
 	ui->filerwwidget->RestoreResults(root, dataset);
 	ui->filestructurewidget->RestoreResults(root, dataset);
 	ui->smallfileswidget->RestoreResults(root, dataset);
+	ui->mixedwidget->RestoreResults(root, dataset);
 	ui->readblockwidget->RestoreResults(root, dataset);
 	ui->readrndwidget->RestoreResults(root, dataset);
+	ui->readthreadswidget->RestoreResults(root, dataset);
 	ui->readcontwidget->RestoreResults(root, dataset);
+	ui->writeblockwidget->RestoreResults(root, dataset);
+	ui->writecontwidget->RestoreResults(root, dataset);
+	ui->writerndwidget->RestoreResults(root, dataset);
 }
 
 void HDDTestWidget::closeEvent(QCloseEvent *ev) {
 	// Check whenever something is in progress
 	bool running = false;
-	if(ui->filerwwidget->testState == TestWidget::STARTED)
+	if(ui->filerwwidget->benchmark->testState == Benchmark::STARTED)
+		running = true;
+	if(ui->filestructurewidget->benchmark->testState == Benchmark::STARTED)
+		running = true;
+	if(ui->readblockwidget->benchmark->testState == Benchmark::STARTED)
+		running = true;
+	if(ui->readcontwidget->benchmark->testState == Benchmark::STARTED)
+		running = true;
+	if(ui->readrndwidget->benchmark->testState == Benchmark::STARTED)
+		running = true;
+	if(ui->readthreadswidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
-	if(ui->filestructurewidget->testState == TestWidget::STARTED)
+	if(ui->seekwidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
-	if(ui->readblockwidget->testState == TestWidget::STARTED)
+	if(ui->smallfileswidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
-	if(ui->readcontwidget->testState == TestWidget::STARTED)
+	if(ui->mixedwidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
-	if(ui->readrndwidget->testState == TestWidget::STARTED)
+	if(ui->writeblockwidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
-	if(ui->seekwidget->testState == TestWidget::STARTED)
+	if(ui->writecontwidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
-	if(ui->smallfileswidget->testState == TestWidget::STARTED)
+	if(ui->writerndwidget->benchmark->testState == Benchmark::STARTED)
 		running = true;
 
 	if(running) {
@@ -390,7 +447,7 @@ void HDDTestWidget::device_list_refresh() {
 	ui->reference->insertSeparator(ui->reference->count());
 
 	// Add saved resutls for both combo boxes
-	QFileInfoList savedList = QDir(":reference/reference").entryInfoList(QStringList("*.hddtest"), QDir::Files);
+	QFileInfoList savedList = QDir(":reference/reference").entryInfoList(QStringList() << "*.hddtest" << "*.hddbin", QDir::Files);
 	for(int i = 0; i < savedList.size(); ++i) {
 		QString label = savedList[i].fileName();
 		QString path = savedList[i].absoluteFilePath();
@@ -31,13 +31,18 @@
 #include <QMutex>
 
 #include "about.h"
-#include "seeker.h"
-#include "readrnd.h"
-#include "readcont.h"
-#include "readblock.h"
-#include "filerw.h"
-#include "filestructure.h"
-#include "smallfiles.h"
+#include "seekerwidget.h"
+#include "readrndwidget.h"
+#include "readthreadswidget.h"
+#include "readcontwidget.h"
+#include "readblockwidget.h"
+#include "filerwwidget.h"
+#include "filestructurewidget.h"
+#include "smallfileswidget.h"
+#include "mixedworkloadwidget.h"
+#include "writeblockwidget.h"
+#include "writecontwidget.h"
+#include "writerndwidget.h"
 
 /// User interface classes
 /** This namespace contains user interface classses **/
@@ -60,16 +65,16 @@ public:
 
 	/** Erases results elected by dataset from all benchmarks
 	  @param dataset selected results type **/
-	void EraseResults(TestWidget::DataSet dataset);
+	void EraseResults(Benchmark::DataSet dataset);
 
 	/** Updates information about slected device
 	  @param dataset which device's information should be updated **/
-	void UpdateInfo(TestWidget::DataSet dataset);
+	void UpdateInfo(Benchmark::DataSet dataset);
 
 	/** Open results stored in file
 	  @param filename of the file with results (can be full path)
 	  @param dataset target dataset for stored results **/
-	void OpenResultFile(QString filename, TestWidget::DataSet = TestWidget::RESULTS);
+	void OpenResultFile(QString filename, Benchmark::DataSet = Benchmark::RESULTS);
 
 private:
 	Ui::HDDTestWidget *ui;
@@ -91,5 +96,6 @@ private slots:
 	void refDevice_accessWarning();
 	void device_list_refresh();
 	void on_about_clicked();
+	void on_compare_clicked();
 	void on_open_clicked();
 };
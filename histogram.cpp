@@ -0,0 +1,197 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "histogram.h"
+
+// buckets for all positive 63 bit values
+static const int BUCKET_COUNT = (62 - Histogram::SUB_BUCKET_BITS) * Histogram::SUB_BUCKETS + 2 * Histogram::SUB_BUCKETS;
+
+Histogram::Histogram():
+	buckets(BUCKET_COUNT, 0) {
+	erase();
+}
+
+int Histogram::Index(hddtime value) {
+	if(value < 0) {
+		value = 0;
+	}
+
+	// small values have bucket each
+	if(value < 2 * SUB_BUCKETS) {
+		return value;
+	}
+
+	// shift value so it fits to sub buckets
+	int shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+	return shift * SUB_BUCKETS + (value >> shift);
+}
+
+hddtime Histogram::Highest(int index) {
+	if(index < 2 * SUB_BUCKETS) {
+		return index;
+	}
+
+	int shift = index / SUB_BUCKETS - 1;
+	hddtime sub = index - shift * SUB_BUCKETS;
+	return ((sub + 1) << shift) - 1;
+}
+
+void Histogram::Add(hddtime value) {
+	++buckets[Index(value)];
+
+	// update statistics
+	if((count == 0) || (value < min)) {
+		min = value;
+	}
+	if(value > max) {
+		max = value;
+	}
+	sum += value;
+	++count;
+}
+
+void Histogram::Merge(const Histogram &other) {
+	if(other.count == 0) {
+		return;
+	}
+
+	for(int i = 0; i < buckets.size(); ++i) {
+		buckets[i] += other.buckets[i];
+	}
+
+	if((count == 0) || (other.min < min)) {
+		min = other.min;
+	}
+	if(other.max > max) {
+		max = other.max;
+	}
+	sum += other.sum;
+	count += other.count;
+}
+
+hddtime Histogram::Percentile(qreal percentile) const {
+	if(count == 0) {
+		return 0;
+	}
+
+	// count of values at or below percentile
+	hddsize target = ceil(percentile * count / 100);
+	if(target < 1) {
+		target = 1;
+	}
+
+	// find bucket containing target value
+	hddsize seen = 0;
+	for(int i = 0; i < buckets.size(); ++i) {
+		seen += buckets[i];
+		if(seen >= target) {
+			return qMin(Highest(i), max);
+		}
+	}
+
+	return max;
+}
+
+hddsize Histogram::Count() const {
+	return count;
+}
+
+hddtime Histogram::Min() const {
+	return min;
+}
+
+hddtime Histogram::Max() const {
+	return max;
+}
+
+qreal Histogram::Mean() const {
+	return (count > 0)?(qreal)sum / count:0;
+}
+
+QString Histogram::Summary() const {
+	if(count == 0) {
+		return "no data";
+	}
+
+	return "p50 " + Def::FormatTime(Percentile(50)) +
+			", p99 " + Def::FormatTime(Percentile(99)) +
+			", p99.9 " + Def::FormatTime(Percentile(99.9)) +
+			", max " + Def::FormatTime(max);
+}
+
+void Histogram::erase() {
+	buckets.fill(0);
+	count = 0;
+	min = 0;
+	max = 0;
+	sum = 0;
+}
+
+void Histogram::Write(ResultWriter &writer) const {
+	writer.StartElement("Histogram");
+
+	// statistics and main percentiles for readers of the file
+	writer.Attribute("count", count);
+	writer.Attribute("min", min);
+	writer.Attribute("max", max);
+	writer.Attribute("sum", sum);
+	writer.Attribute("p50", Percentile(50));
+	writer.Attribute("p99", Percentile(99));
+	writer.Attribute("p999", Percentile(99.9));
+
+	// non-empty buckets as "index:count" list
+	QStringList list;
+	for(int i = 0; i < buckets.size(); ++i) {
+		if(buckets[i] > 0) {
+			list.append(QString::number(i) + ":" + QString::number(buckets[i]));
+		}
+	}
+	writer.Attribute("buckets", list.join(","));
+
+	writer.EndElement();
+}
+
+void Histogram::Read(const ResultElement &root) {
+	erase();
+
+	ResultElement master = root.Child("Histogram");
+	if(master.IsNull()) {
+		return;
+	}
+
+	// values stored in other unit are converted to current one
+	hddtime unit = Def::StoredTimeUnit(master);
+
+	count = master.Integer("count");
+	min = master.Integer("min") * unit;
+	max = master.Integer("max") * unit;
+	sum = master.Integer("sum") * unit;
+
+	QStringList list = master.Attribute("buckets").split(",", Qt::SkipEmptyParts);
+	for(int i = 0; i < list.size(); ++i) {
+		QStringList bucket = list[i].split(":");
+		int index = bucket[0].toInt();
+		if((bucket.size() == 2) && (index >= 0) && (index < buckets.size())) {
+			// scaled values move to other bucket
+			int target = (unit == ns)?index:Index(Highest(index) * unit);
+			buckets[target] += bucket[1].toLongLong();
+		}
+	}
+}
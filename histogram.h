@@ -0,0 +1,85 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QtXml>
+
+#include "definitions.h"
+#include "resultwriter.h"
+#include "resultfile.h"
+
+using namespace HDDTest;
+
+/// Log-bucketed latency histogram
+/** Histogram class records operation times into logarithmic buckets divided
+into SUB_BUCKETS linear sub-buckets (HDR histogram layout). Every value is kept
+with relative error below 1 / SUB_BUCKETS while memory stays constant regardless
+of the count of recorded values. Percentiles are reported as the highest value
+of the bucket containing them, limited by the maximal recorded value.
+Histograms can be merged and stored in result files. **/
+class Histogram {
+public:
+	Histogram();	/// Creates empty histogram
+
+	static const int SUB_BUCKET_BITS = 5;					/// Precision of buckets in bits
+	static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;	/// Linear sub-buckets per power of two
+
+	/** Record one value
+	  @param value operation time **/
+	void Add(hddtime value);
+
+	/** Add all values from another histogram
+	  @param other histogram to be merged **/
+	void Merge(const Histogram &other);
+
+	/** Get value at percentile
+	  @param percentile in range from 0 to 100
+	  @return highest value of bucket containing percentile, 0 when empty **/
+	hddtime Percentile(qreal percentile) const;
+
+	hddsize Count() const;	/// Count of recorded values
+	hddtime Min() const;	/// Minimal recorded value
+	hddtime Max() const;	/// Maximal recorded value
+	qreal Mean() const;		/// Average recorded value
+
+	QString Summary() const;	/// Main percentiles in human readable form
+
+	void erase();	/// Erase all values
+
+	/** Store histogram to result file
+	  @param writer writer receiving element with non-empty buckets and main percentiles **/
+	void Write(ResultWriter &writer) const;
+
+	/** Restore histogram from element created by Write
+	  @param root element containing Histogram element **/
+	void Read(const ResultElement &root);
+
+private:
+	static int Index(hddtime value);		// bucket index of value
+	static hddtime Highest(int index);		// highest value stored in bucket
+
+	QVector<hddsize> buckets;
+	hddsize count;
+	hddtime min;
+	hddtime max;
+	hddtime sum;
+};
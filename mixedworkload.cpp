@@ -0,0 +1,463 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "mixedworkload.h"
+#include "file.h"
+
+/// Parses size with K, M or G suffix
+static bool ParseSize(QString text, hddsize &size) {
+	hddsize unit = B;
+	if(text.endsWith('K', Qt::CaseInsensitive)) {
+		unit = K;
+	} else if(text.endsWith('M', Qt::CaseInsensitive)) {
+		unit = M;
+	} else if(text.endsWith('G', Qt::CaseInsensitive)) {
+		unit = G;
+	}
+	if(unit != B) {
+		text.chop(1);
+	}
+
+	bool ok = false;
+	size = text.toLongLong(&ok) * unit;
+
+	return ok && (size > 0);
+}
+
+/// Formats size with K, M or G suffix
+static QString SpecSize(hddsize size) {
+	if(size % G == 0) {
+		return QString::number(size / G) + "G";
+	} else if(size % M == 0) {
+		return QString::number(size / M) + "M";
+	} else if(size % K == 0) {
+		return QString::number(size / K) + "K";
+	}
+
+	return QString::number(size);
+}
+
+MixedWorkload::MixedWorkload(QObject *parent):
+	Benchmark(parent), use_custom(false) {
+	// workload presets selected by mode
+	Profile oltp;
+	oltp.Parse("read=70,pattern=random,zipf=0.99,bs=8K:90/64K:10");
+	presets.append(oltp);
+	AddMode("OLTP: 70 % read, 8K/64K, Zipfian hot set");
+
+	Profile random;
+	random.Parse("read=50,pattern=random,zipf=0,bs=4K:100");
+	presets.append(random);
+	AddMode("Random: 50 % read, 4K, uniform");
+
+	Profile mostly;
+	mostly.Parse("read=90,pattern=random,zipf=0,bs=4K:50/16K:30/128K:20");
+	presets.append(mostly);
+	AddMode("Read mostly: 90 % read, 4K-128K, uniform");
+
+	Profile sequential;
+	sequential.Parse("read=70,pattern=sequential,zipf=0,bs=128K:100");
+	presets.append(sequential);
+	AddMode("Sequential: 70 % read, 128K");
+
+	testName = "Mixed workload";
+	testDescription = "Mixed workload test runs mix of reads and writes for " + Def::FormatTime(MIXED_TIME) +
+			". Share of reads, random or sequential access, block sizes and skew of random positions" +
+			" are given by selected profile, Zipfian skew makes small hot set of blocks receive most" +
+			" of the operations. The test uses " + Def::FormatSize(MIXED_FILE_SIZE) +
+			" file when filesystem is mounted." +
+			" WARNING: otherwise it runs on raw device and all data on the device are destroyed." +
+			" Graph shows throughput over time, IOPS and latencies are in summary.";
+}
+
+void MixedWorkload::TestLoop() {
+	const Profile profile = ActiveProfile();
+	results.profile = profile.Spec();
+
+	// initialize random number generator
+	RandomGenerator gen(seed);
+
+	// positions are aligned to the smallest block, range leaves space for the biggest one
+	const hddsize logical = qMax(device->GetBlockSize(), (hddsize)1);
+	const hddsize align = (profile.MinBlock() + logical - 1) / logical * logical;
+
+	// prepare target, file is filled so reads access real data
+	File *file = NULL;
+	QString filename;
+	RandomOffset offsets(0, 0, 1, 1);
+	if(device->fs) {
+		results.target = "file";
+		filename = device->GetSafeTemp() + "/" + "hddtestmixed";
+		file = new File(filename, device);
+		for(hddsize pos = 0; (pos < MIXED_FILE_SIZE) && (testState != STOPPING); pos += MIXED_FILL_BLOCK) {
+			file->WriteAt(MIXED_FILL_BLOCK, pos);
+		}
+		file->Reopen();
+		offsets = RandomOffset(0, MIXED_FILE_SIZE, profile.MaxBlock(), align);
+	} else {
+		results.target = "device";
+		device->PrepareBuffer(profile.MaxBlock());
+		device->PrepareWriteBuffer(profile.MaxBlock());
+		offsets = GetOffsets(profile.MaxBlock(), 0, 0, align);
+		if(offsets.Count() == 0) {
+			return;
+		}
+	}
+	device->Sync();
+	device->DropCaches();
+
+	Zipfian zipf(offsets.Count(), profile.zipf);
+	int weights = 0;
+	for(int i = 0; i < profile.blocks.size(); ++i) {
+		weights += profile.blocks[i].second;
+	}
+
+	// run workload, interval results are computed from operation counters
+	Timer timer;
+	timer.MarkStart();
+	hddtime interval_start = 0;
+	hddsize interval_ops = 0;
+	hddsize interval_bytes = 0;
+	hddsize cursor = offsets.At(0);
+	while((results.time < MIXED_TIME) && (testState != STOPPING)) {
+		// draw operation
+		bool write = (int)gen.Below(100) >= profile.read;
+		int weight = gen.Below(weights);
+		hddsize size = profile.blocks.last().first;
+		for(int i = 0; i < profile.blocks.size(); ++i) {
+			if(weight < profile.blocks[i].second) {
+				size = profile.blocks[i].first;
+				break;
+			}
+			weight -= profile.blocks[i].second;
+		}
+
+		hddsize pos;
+		if(profile.random) {
+			pos = offsets.At((profile.zipf > 0)?zipf.Get(gen):gen.Below(offsets.Count()));
+		} else {
+			// start again at the beginning when the biggest block does not fit
+			if(cursor > offsets.At(offsets.Count() - 1)) {
+				cursor = offsets.At(0);
+			}
+			pos = cursor;
+			cursor += (size + align - 1) / align * align;
+		}
+
+		// run it
+		Histogram *histogram = write?&results.write_histogram:&results.read_histogram;
+		if(file) {
+			file->timer.SetHistogram(histogram);
+			write?file->WriteAt(size, pos):file->ReadAt(size, pos);
+		} else {
+			device->timer.SetHistogram(histogram);
+			write?device->WriteAt(size, pos):device->ReadAt(size, pos);
+		}
+		if(write) {
+			++results.writes;
+			results.bytes_written += size;
+		} else {
+			++results.reads;
+			results.bytes_read += size;
+		}
+		++interval_ops;
+		interval_bytes += size;
+
+		// close interval
+		hddtime now = timer.GetCurrentOffset();
+		if(now - interval_start >= MIXED_INTERVAL) {
+			hddtime length = now - interval_start;
+			results.AddInterval((qreal)interval_ops * s / length, (qreal)interval_bytes * us / length);
+			results.time += length;
+			interval_start = now;
+			interval_ops = 0;
+			interval_bytes = 0;
+		}
+	}
+
+	// remove file
+	if(file) {
+		file->VerifyWritten();
+		file->Close();
+		delete file;
+		device->DelFile(filename);
+		device->ClearSafeTemp();
+	}
+}
+
+void MixedWorkload::InitResults() {
+	results.erase();
+}
+
+int MixedWorkload::GetProgress() {
+	return qMin((hddtime)100, 100 * results.time / MIXED_TIME);
+}
+
+QString MixedWorkload::GetSummary() {
+	return "Profile: " + results.profile + " on " + results.target + "\n" +
+			"IOPS: " + results.iops_stats.Summary("IOPS") + "\n" +
+			"Throughput: " + QString::number(results.Speed(), 'f', 1) + " MB/s\n" +
+			"Reads: " + QString::number(results.reads) + ", " + results.read_histogram.Summary() + "\n" +
+			"Writes: " + QString::number(results.writes) + ", " + results.write_histogram.Summary();
+}
+
+QList<Benchmark::Metric> MixedWorkload::GetMetrics() {
+	QList<Metric> metrics;
+	if(results.time > 0) {
+		metrics.append(Metric("IOPS", results.IOPS(), "IOPS", true));
+		metrics.append(Metric("Throughput", results.Speed(), "MB/s", true));
+	}
+	if(results.reads > 0) {
+		metrics.append(Metric("Read time p99", (qreal)results.read_histogram.Percentile(99) / ms, "ms", false));
+	}
+	if(results.writes > 0) {
+		metrics.append(Metric("Write time p99", (qreal)results.write_histogram.Percentile(99) / ms, "ms", false));
+	}
+
+	return metrics;
+}
+
+hddsize MixedWorkload::GetRandomBlock() {
+	// file of fixed size is used on filesystem
+	return device->fs?0:ActiveProfile().MaxBlock();
+}
+
+bool MixedWorkload::SetProfile(QString spec) {
+	Profile profile = presets[mode];
+	if(!profile.Parse(spec)) {
+		return false;
+	}
+	custom = profile;
+	use_custom = true;
+
+	return true;
+}
+
+MixedWorkload::Profile MixedWorkload::ActiveProfile() {
+	return use_custom?custom:presets[mode];
+}
+
+MixedWorkload::Profile::Profile():
+	read(100), random(true), zipf(0) {
+	blocks.append(qMakePair((hddsize)4 * K, 1));
+}
+
+hddsize MixedWorkload::Profile::MinBlock() const {
+	hddsize size = blocks.first().first;
+	for(int i = 1; i < blocks.size(); ++i) {
+		size = qMin(size, blocks[i].first);
+	}
+
+	return size;
+}
+
+hddsize MixedWorkload::Profile::MaxBlock() const {
+	hddsize size = blocks.first().first;
+	for(int i = 1; i < blocks.size(); ++i) {
+		size = qMax(size, blocks[i].first);
+	}
+
+	return size;
+}
+
+QString MixedWorkload::Profile::Spec() const {
+	QString spec = "read=" + QString::number(read) +
+			",pattern=" + (random?"random":"sequential") +
+			",zipf=" + QString::number(zipf) + ",bs=";
+	for(int i = 0; i < blocks.size(); ++i) {
+		spec += ((i > 0)?"/":"") + SpecSize(blocks[i].first) + ":" + QString::number(blocks[i].second);
+	}
+
+	return spec;
+}
+
+bool MixedWorkload::Profile::Parse(QString spec) {
+	QStringList pairs = spec.split(',', Qt::SkipEmptyParts);
+	for(int i = 0; i < pairs.size(); ++i) {
+		QString key = pairs[i].section('=', 0, 0).trimmed();
+		QString value = pairs[i].section('=', 1).trimmed();
+		bool ok = false;
+
+		if(key == "read") {
+			read = value.toInt(&ok);
+			if(!ok || (read < 0) || (read > 100)) {
+				return false;
+			}
+		} else if(key == "pattern") {
+			if((value != "random") && (value != "sequential")) {
+				return false;
+			}
+			random = (value == "random");
+		} else if(key == "zipf") {
+			zipf = value.toDouble(&ok);
+			if(!ok || (zipf < 0) || (zipf >= 1)) {
+				return false;
+			}
+		} else if(key == "bs") {
+			// size:weight items, weight 1 when omitted
+			QList<QPair<hddsize, int> > sizes;
+			QStringList items = value.split('/', Qt::SkipEmptyParts);
+			for(int j = 0; j < items.size(); ++j) {
+				hddsize size;
+				int weight = items[j].contains(':')?items[j].section(':', 1).toInt(&ok):1;
+				if(!ParseSize(items[j].section(':', 0, 0), size) || (items[j].contains(':') && !ok) || (weight <= 0)) {
+					return false;
+				}
+				sizes.append(qMakePair(size, weight));
+			}
+			if(sizes.isEmpty()) {
+				return false;
+			}
+			blocks = sizes;
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+MixedWorkloadResults::MixedWorkloadResults():
+	new_speeds(RING_SIZE) {
+	erase();
+}
+
+void MixedWorkloadResults::AddInterval(qreal iops, qreal speed) {
+	this->iops.push_back(iops);
+	speeds.push_back(speed);
+	// add to results to draw, never blocks measuring thread
+	new_speeds.Push(speed);
+
+	iops_stats.Add(iops);
+}
+
+qreal MixedWorkloadResults::IOPS() const {
+	return (time > 0)?(qreal)(reads + writes) * s / time:0;
+}
+
+qreal MixedWorkloadResults::Speed() const {
+	return (time > 0)?(qreal)(bytes_read + bytes_written) * us / time:0;
+}
+
+void MixedWorkloadResults::erase() {
+	profile.clear();
+	target.clear();
+	iops.clear();
+	speeds.clear();
+	new_speeds.Clear();
+	iops_stats.erase();
+	reads = 0;
+	writes = 0;
+	bytes_read = 0;
+	bytes_written = 0;
+	time = 0;
+	read_histogram.erase();
+	write_histogram.erase();
+}
+
+void MixedWorkload::WriteResults(ResultWriter &writer) {
+	// create main element
+	writer.StartElement("Mixed_Workload");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("seed", seed);
+	writer.Attribute("pattern", pattern.Name());
+	writer.Attribute("range_begin", rangeBegin);
+	writer.Attribute("range_end", rangeEnd);
+	writer.Attribute("profile", results.profile);
+	writer.Attribute("target", results.target);
+	writer.Attribute("time", results.time);
+	writer.Attribute("reads", results.reads);
+	writer.Attribute("writes", results.writes);
+	writer.Attribute("read", results.bytes_read);
+	writer.Attribute("written", results.bytes_written);
+
+	// add intervals
+	if(GetProgress() == 100) for(int i = 0; i < results.iops.size(); ++i) {
+		writer.StartElement("Interval");
+		writer.Attribute("iops", results.iops[i]);
+		writer.Attribute("speed", results.speeds[i]);
+		writer.EndElement();
+	}
+
+	// add latencies
+	writer.StartElement("Read_data");
+	results.read_histogram.Write(writer);
+	writer.EndElement();
+	writer.StartElement("Write_data");
+	results.write_histogram.Write(writer);
+	writer.EndElement();
+
+	sampler.Write(writer);
+	verifier.Write(writer);
+
+	writer.EndElement();
+}
+
+void MixedWorkload::RestoreResults(const ResultElement &root, DataSet dataset) {
+	MixedWorkloadResults &res = (dataset == REFERENCE)?reference:results;
+
+	// Locate main element
+	ResultElement main = root.Child("Mixed_Workload");
+
+	// throughput samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+		verifier.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// erase old results
+	res.erase();
+
+	hddtime unit = Def::StoredTimeUnit(main);
+	res.profile = main.Attribute("profile");
+	res.target = main.Attribute("target");
+	res.time = main.Integer("time") * unit;
+	res.reads = main.Integer("reads");
+	res.writes = main.Integer("writes");
+	res.bytes_read = main.Integer("read");
+	res.bytes_written = main.Integer("written");
+
+	// read intervals
+	ResultList intervals = main.Children("Interval");
+	ResultColumn iops = intervals.Column("iops");
+	ResultColumn speeds = intervals.Column("speed");
+	for(int i = 0; i < intervals.Size(); ++i) {
+		res.AddInterval(iops.Number(i), speeds.Number(i));
+	}
+
+	res.read_histogram.Read(main.Child("Read_data"));
+	res.write_histogram.Read(main.Child("Write_data"));
+}
+
+void MixedWorkload::EraseResults(DataSet dataset) {
+	// erase data
+	if(dataset == RESULTS) {
+		sampler.erase();
+		verifier.erase();
+		results.erase();
+	} else {
+		reference.erase();
+	}
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QPair>
+
+#include "definitions.h"
+#include "benchmark.h"
+#include "randomgenerator.h"
+#include "ring.h"
+#include "statistics.h"
+
+/// Stores Mixed workload benchmark results
+/** MixedWorkloadResults keeps operation counters, read and write latencies
+and IOPS and throughput of every interval of Mixed workload benchmark.
+@see MixedWorkload class **/
+class MixedWorkloadResults {
+public:
+	MixedWorkloadResults();	/// The constructor
+
+	static const int RING_SIZE = 1024;	/// capacity of new results ring
+
+	QString profile;			/// Workload profile specification
+	QString target;				/// "file" or "device"
+	QList<qreal> iops;			/// IOPS of every interval
+	QList<qreal> speeds;		/// Throughput of every interval in MB/s
+	Ring<qreal> new_speeds;		/// new throughputs to be drawn to graph
+	Statistics iops_stats;		/// IOPS statistics
+	hddsize reads;				/// Count of read operations
+	hddsize writes;				/// Count of write operations
+	hddsize bytes_read;			/// Bytes read
+	hddsize bytes_written;		/// Bytes written
+	hddtime time;				/// Duration of measured intervals
+	Histogram read_histogram;	/// Read latencies
+	Histogram write_histogram;	/// Write latencies
+
+	/** Add interval results
+	  @param iops operations per second in interval
+	  @param speed throughput in MB/s in interval **/
+	void AddInterval(qreal iops, qreal speed);
+
+	qreal IOPS() const;		/// Average operations per second
+	qreal Speed() const;	/// Average throughput in MB/s
+
+	void erase();	/// Erase results
+};
+
+/// Mixed workload benchmark main class
+/** Mixed workload benchmark runs mix of reads and writes described by profile
+for fixed time. Profile gives share of reads, random or sequential access,
+distribution of block sizes and Zipfian skew of random positions, which
+makes small hot set receive most of the operations as database pages do.
+Workload runs on preallocated file when filesystem is mounted and on raw
+device otherwise, the latter destroys data on the device. Throughput of
+every interval is kept, IOPS and read and write latency percentiles are
+reported in summary.
+@see MixedWorkloadResults
+@see MixedWorkloadWidget **/
+class MixedWorkload : public Benchmark {
+public:
+	MixedWorkload(QObject *parent = 0);	/// The constructor
+
+	/// Workload description
+	struct Profile {
+		Profile();
+
+		int read;		/// Share of reads in percent
+		bool random;	/// Whenever positions are random instead of sequential
+		qreal zipf;		/// Zipfian skew of random positions, 0 for uniform
+		QList<QPair<hddsize, int> > blocks;	/// Block sizes with their weights
+
+		hddsize MinBlock() const;	/// The smallest block size
+		hddsize MaxBlock() const;	/// The biggest block size
+
+		/** Profile in specification format
+		  @return for example "read=70,pattern=random,zipf=0.99,bs=8K:90/64K:10" **/
+		QString Spec() const;
+
+		/** Parses profile specification, missing keys keep their values
+		  @param spec comma separated key=value pairs, see Spec
+		  @return false when specification is not valid **/
+		bool Parse(QString spec);
+	};
+
+	static const hddtime MIXED_TIME = 30 * s;			/// Duration of workload
+	static const hddtime MIXED_INTERVAL = 500 * ms;		/// Length of one graph interval
+	static const hddsize MIXED_FILE_SIZE = 1024 * M;	/// Size of preallocated file
+	static const hddsize MIXED_FILL_BLOCK = 4 * M;		/// Block size used to fill the file
+
+	void InitResults();	/// Erases results before benchmark begins
+	void TestLoop();	/// Main benchmark code
+	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+	hddsize GetRandomBlock();	/// Largest block of profile on raw device, 0 on filesystem
+
+	/** Use custom profile instead of mode presets
+	  @param spec profile specification, see Profile::Spec
+	  @return false when specification is not valid **/
+	bool SetProfile(QString spec);
+
+	MixedWorkloadResults results;	/// Primary results
+	MixedWorkloadResults reference;	/// Reference results
+
+	void WriteResults(ResultWriter &writer);	/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
+	void EraseResults(DataSet dataset);	/// Erases selected results
+
+private:
+	Profile ActiveProfile();	// custom profile or preset of mode
+
+	QList<Profile> presets;		// profiles of modes
+	Profile custom;
+	bool use_custom;
+};
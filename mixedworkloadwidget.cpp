@@ -0,0 +1,75 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "mixedworkloadwidget.h"
+
+MixedWorkloadWidget::MixedWorkloadWidget(QWidget *parent):
+	TestWidget(new MixedWorkload(), parent), test(static_cast<MixedWorkload*>(benchmark)) {
+	// add throughput graphs
+	graph = addLineGraph("MB/s", QColor(255, 0, 0));
+	reference_graph = addLineGraph("MB/s", QColor(0, 0, 255));
+	avg_line = addLine("MB/s", "avg", QColor(255, 0, 0));
+	reference_avg_line = addLine("MB/s", "avg", QColor(0, 0, 255));
+
+	// add background net
+	net = addNet("MB/s", "Time", "Throughput");
+
+	// add legend
+	legend = addLegend();
+	legend->AddItem("Results", QColor(255, 0, 0));
+	legend->AddItem("Reference", QColor(0, 0, 255));
+
+	// raw device test can bypass page cache
+	SetDirectIOVisible(true);
+}
+
+void MixedWorkloadWidget::InitScene() {
+	graph->erase();
+}
+
+void MixedWorkloadWidget::UpdateScene() {
+	graph->SetSize(MixedWorkload::MIXED_TIME / MixedWorkload::MIXED_INTERVAL);
+	reference_graph->SetSize(MixedWorkload::MIXED_TIME / MixedWorkload::MIXED_INTERVAL);
+
+	// add new values to graphs
+	qreal data;
+	while(test->results.new_speeds.Pop(data)) {
+		graph->AddValue(data);
+	}
+	while(test->reference.new_speeds.Pop(data)) {
+		reference_graph->AddValue(data);
+	}
+
+	avg_line->SetValue(test->results.Speed());
+	reference_avg_line->SetValue(test->reference.Speed());
+
+	Rescale();
+}
+
+void MixedWorkloadWidget::EraseResults(Benchmark::DataSet dataset) {
+	(dataset == Benchmark::REFERENCE)?reference_graph->erase():graph->erase();
+	TestWidget::EraseResults(dataset);
+}
+
+void MixedWorkloadWidget::RestoreResults(const ResultElement &root, Benchmark::DataSet dataset) {
+	// restored intervals are added to empty graph
+	(dataset == Benchmark::REFERENCE)?reference_graph->erase():graph->erase();
+	TestWidget::RestoreResults(root, dataset);
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "mixedworkload.h"
+
+/// Mixed workload benchmark widget
+/** Shows results of Mixed workload benchmark. Throughput of every interval
+is drawn as line graph with average throughput.
+@see MixedWorkload class **/
+class MixedWorkloadWidget : public TestWidget {
+public:
+	MixedWorkloadWidget(QWidget *parent = 0);	/// The constructor
+
+	void InitScene();	/// Initializes scene before benchmark begins
+	void UpdateScene();	/// Updates scene
+	void EraseResults(Benchmark::DataSet dataset);	/// Erases selected results and their graph
+	void RestoreResults(const ResultElement &root, Benchmark::DataSet dataset);	/// Reads results and redraws their graph
+
+	MixedWorkload *test;	/// Benchmark shown by widget
+
+private:
+	LineGraph *graph;
+	LineGraph *reference_graph;
+	Line *avg_line;
+	Line *reference_avg_line;
+	Net *net;
+	Legend *legend;
+};
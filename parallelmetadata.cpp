@@ -0,0 +1,336 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "parallelmetadata.h"
+
+MetadataResult::MetadataResult(int threads):
+	__threads(threads) {
+	erase();
+}
+
+qreal MetadataResult::OpsPerSecond(int phase) const {
+	return (__time[phase] > 0)?(qreal)__ops[phase] * s / (qreal)__time[phase]:0;
+}
+
+qreal MetadataResult::TotalOpsPerSecond() const {
+	hddsize ops = 0;
+	hddtime time = 0;
+	for(int i = 0; i < PHASE_COUNT; ++i) {
+		ops += __ops[i];
+		time += __time[i];
+	}
+
+	return (time > 0)?(qreal)ops * s / (qreal)time:0;
+}
+
+QString MetadataResult::PhaseName(int phase) {
+	switch(phase) {
+	case PHASE_CREATE:
+		return "Create";
+	case PHASE_STAT:
+		return "Stat";
+	case PHASE_READ:
+		return "Read";
+	default:
+		return "Delete";
+	}
+}
+
+void MetadataResult::erase() {
+	for(int i = 0; i < PHASE_COUNT; ++i) {
+		__ops[i] = 0;
+		__time[i] = 0;
+		__flush[i] = 0;
+		__histogram[i].erase();
+	}
+	__done = false;
+}
+
+MetadataWorker::MetadataWorker(Device *device, Benchmark *test, QString root, int dirs, int files, hddsize min_size, hddsize max_size,
+		int stream):
+	phase(MetadataResult::PHASE_CREATE), device(device), test(test),
+	dirs(dirs), files(files), min_size(min_size), max_size(max_size), random(test->seed, stream), tree(device, root, false) {
+	for(int i = 0; i < MetadataResult::PHASE_COUNT; ++i) {
+		ops[i] = 0;
+	}
+}
+
+void MetadataWorker::run() {
+	device->timer.SetHistogram(&histogram[phase]);
+
+	switch(phase) {
+	case MetadataResult::PHASE_CREATE:
+		Create();
+		break;
+	case MetadataResult::PHASE_STAT:
+		Stat();
+		break;
+	case MetadataResult::PHASE_READ:
+		Read();
+		break;
+	default:
+		Delete();
+		break;
+	}
+
+	device->timer.SetHistogram(NULL);
+}
+
+void MetadataWorker::Create() {
+	int dirs_left = dirs;
+	int files_left = files;
+
+	while(((dirs_left > 0) || (files_left > 0)) && (test->testState != Benchmark::STOPPING)) {
+		// new entry is placed in random directory
+		int parent = random.Below(tree.Dirs());
+
+		if((files_left == 0) || ((dirs_left > 0) && (random.Get32() % 2 == 0))) {
+			tree.MkDir(parent);
+			--dirs_left;
+		} else {
+			hddsize size = min_size;
+			if(max_size > min_size) {
+				size += random.Below(max_size - min_size);
+			}
+			tree.MkFile(parent, size);
+			--files_left;
+		}
+
+		++ops[MetadataResult::PHASE_CREATE];
+	}
+}
+
+void MetadataWorker::Stat() {
+	for(int i = 0; (i < tree.Files()) && (test->testState != Benchmark::STOPPING); ++i) {
+		tree.StatFile(i);
+		++ops[MetadataResult::PHASE_STAT];
+	}
+
+	// node 0 is worker root
+	for(int i = 1; (i < tree.Dirs()) && (test->testState != Benchmark::STOPPING); ++i) {
+		tree.StatDir(i);
+		++ops[MetadataResult::PHASE_STAT];
+	}
+}
+
+void MetadataWorker::Read() {
+	// read files in random order
+	QList<int> to_read;
+	for(int i = 0; i < tree.Files(); ++i) {
+		to_read.push_back(i);
+	}
+	while(!to_read.empty() && (test->testState != Benchmark::STOPPING)) {
+		int index = random.Below(to_read.size());
+		tree.ReadFile(to_read[index]);
+		to_read.removeAt(index);
+
+		++ops[MetadataResult::PHASE_READ];
+	}
+}
+
+void MetadataWorker::Delete() {
+	// the tree is always removed, even when benchmark is stopped
+	for(int i = 0; i < tree.Files(); ++i) {
+		tree.DelFile(i);
+		++ops[MetadataResult::PHASE_DELETE];
+	}
+
+	for(int i = tree.Dirs() - 1; i > 0; --i) {
+		tree.DelDir(i);
+		++ops[MetadataResult::PHASE_DELETE];
+	}
+}
+
+ParallelMetadata::ParallelMetadata(Benchmark *test, int dirs, int files, hddsize min_size, hddsize max_size):
+	test(test), dirs(dirs), files(files), min_size(min_size), max_size(max_size) {
+	// add subtests to subtest list
+	for(int i = 0, threads = 1; i < PARALLEL_METADATA_COUNT; ++i, threads *= 2) {
+		results.push_back(MetadataResult(threads));
+		reference.push_back(MetadataResult(threads));
+	}
+}
+
+void ParallelMetadata::TestLoop() {
+	Device *device = test->device;
+	QString temp = device->GetSafeTemp();
+	if(temp.isEmpty()) {
+		return;
+	}
+
+	for(int i = 0; i < results.size(); ++i) {
+		MetadataResult &result = results[i];
+
+		// every worker gets its own device clone, root and part of entries
+		QList<Device*> clones;
+		QList<MetadataWorker*> workers;
+		QDir dir(temp);
+		for(int t = 0; t < result.__threads; ++t) {
+			QString root = temp + "/" + QString::number(t);
+			dir.mkdir(root);
+
+			Device *clone = device->Clone();
+			clones.push_back(clone);
+			workers.push_back(new MetadataWorker(clone, test, root,
+					qMax(dirs / result.__threads, 1), qMax(files / result.__threads, 1), min_size, max_size, t));
+		}
+
+		// run phases, all workers run the same phase at once
+		for(int phase = 0; phase < MetadataResult::PHASE_COUNT; ++phase) {
+			device->DropCaches();
+
+			Timer timer;
+			timer.MarkStart();
+			for(int t = 0; t < workers.size(); ++t) {
+				workers[t]->phase = phase;
+				workers[t]->start();
+			}
+			for(int t = 0; t < workers.size(); ++t) {
+				workers[t]->wait();
+			}
+			timer.MarkEnd();
+
+			result.__time[phase] = timer.GetFinalOffset();
+			result.__flush[phase] = device->Sync();
+		}
+
+		// collect results
+		for(int t = 0; t < workers.size(); ++t) {
+			for(int phase = 0; phase < MetadataResult::PHASE_COUNT; ++phase) {
+				result.__ops[phase] += workers[t]->ops[phase];
+				result.__histogram[phase].Merge(workers[t]->histogram[phase]);
+			}
+			delete workers[t];
+			delete clones[t];
+			dir.rmdir(temp + "/" + QString::number(t));
+		}
+
+		if(test->testState == Benchmark::STOPPING) {
+			break;
+		}
+		result.__done = true;
+	}
+
+	device->ClearSafeTemp();
+}
+
+int ParallelMetadata::GetProgress() {
+	int done = 0;
+
+	for(int i = 0; i < results.size(); ++i) {
+		if(results[i].__done) {
+			++done;
+		}
+	}
+
+	return (100 * done) / results.size();
+}
+
+QString ParallelMetadata::GetSummary() {
+	QString summary;
+	for(int i = 0; i < results.size(); ++i) {
+		const MetadataResult &result = results.at(i);
+		summary += QString::number(result.__threads) + " threads:";
+		hddtime flush = 0;
+		for(int phase = 0; phase < MetadataResult::PHASE_COUNT; ++phase) {
+			summary += " " + MetadataResult::PhaseName(phase).toLower() + " " +
+					QString::number(result.OpsPerSecond(phase), 'f', 0) + " ops/s,";
+			flush += result.__flush[phase];
+		}
+		summary += " flush " + Def::FormatTime(flush) + "\n";
+	}
+
+	return summary.trimmed();
+}
+
+QList<Benchmark::Metric> ParallelMetadata::GetMetrics() {
+	QList<Benchmark::Metric> metrics;
+	for(int i = 0; i < results.size(); ++i) {
+		if(results[i].__done) {
+			metrics.append(Benchmark::Metric("Parallel " + QString::number(results[i].__threads) + " threads",
+					results[i].TotalOpsPerSecond(), "ops/s", true));
+		}
+	}
+
+	return metrics;
+}
+
+QString ParallelMetadata::Description() {
+	QString description = " Parallel mode splits the structure between 1 to " +
+			QString::number(results.last().__threads) + " threads working at once." +
+			" Every thread creates, stats, reads and deletes its part of entries and bars show" +
+			" operations per second of all phases for every thread count (p99 of create latency is shown below).";
+
+	return description;
+}
+
+void ParallelMetadata::WriteResults(ResultWriter &writer) {
+	writer.StartElement("Parallel");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+
+	for(int i = 0; i < results.size(); ++i) {
+		writer.StartElement("Result");
+		writer.Attribute("threads", results[i].__threads);
+		for(int phase = 0; phase < MetadataResult::PHASE_COUNT; ++phase) {
+			writer.StartElement(MetadataResult::PhaseName(phase));
+			writer.Attribute("ops", results[i].__ops[phase]);
+			writer.Attribute("time", results[i].__time[phase]);
+			writer.Attribute("flush", results[i].__flush[phase]);
+			results[i].__histogram[phase].Write(writer);
+			writer.EndElement();
+		}
+		writer.EndElement();
+	}
+
+	writer.EndElement();
+}
+
+void ParallelMetadata::RestoreResults(const ResultElement &root, Benchmark::DataSet dataset) {
+	QList<MetadataResult> &res = (dataset == Benchmark::REFERENCE)?reference:results;
+
+	// Locate parallel element
+	ResultElement main = root.Child("Parallel");
+	if(!main.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// read subresults
+	hddtime unit = Def::StoredTimeUnit(main);
+	ResultList xmlresults = main.Children("Result");
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		ResultElement xmlresult = xmlresults.At(i);
+		res[i].erase();
+		res[i].__threads = xmlresult.Integer("threads");
+		for(int phase = 0; phase < MetadataResult::PHASE_COUNT; ++phase) {
+			ResultElement element = xmlresult.Child(MetadataResult::PhaseName(phase));
+			res[i].__ops[phase] = element.Integer("ops");
+			res[i].__time[phase] = element.Integer("time") * unit;
+			res[i].__flush[phase] = element.Integer("flush") * unit;
+			res[i].__histogram[phase].Read(element);
+		}
+		res[i].__done = true;
+	}
+}
+
+void ParallelMetadata::EraseResults(Benchmark::DataSet dataset) {
+	QList<MetadataResult> &res = (dataset == Benchmark::RESULTS)?results:reference;
+	for(int i = 0; i < res.size(); ++i) {
+		res[i].erase();
+	}
+}
@@ -0,0 +1,144 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QThread>
+#include <QtXml>
+
+#include "benchmark.h"
+#include "randomgenerator.h"
+#include "device.h"
+#include "filetree.h"
+
+/// Stores results of one parallel metadata subtest
+/** MetadataResult class keeps operation counts, wall times and latencies
+of every phase for one count of threads working at once.
+@see ParallelMetadata class **/
+class MetadataResult {
+public:
+	/// Phases run by all threads at once
+	enum Phase { PHASE_CREATE, PHASE_STAT, PHASE_READ, PHASE_DELETE, PHASE_COUNT };
+
+	MetadataResult(int threads);	/// The constructor
+
+	int __threads;						/// Count of threads working in this subtest
+	hddsize __ops[PHASE_COUNT];			/// Operations done by all threads in every phase
+	hddtime __time[PHASE_COUNT];		/// Wall time of every phase
+	hddtime __flush[PHASE_COUNT];		/// Filesystem flush time after every phase
+	Histogram __histogram[PHASE_COUNT];	/// Operation latencies of every phase
+	bool __done;						/// Whenever the subtest has finished
+
+	qreal OpsPerSecond(int phase) const;	/// Operations per second of phase
+	qreal TotalOpsPerSecond() const;		/// Operations per second of all phases together
+
+	static QString PhaseName(int phase);	/// Phase name used in summary and XML
+
+	void erase();	/// Erase results
+};
+
+/// Worker thread of parallel metadata subtest
+/** MetadataWorker owns its part of random directory tree placed in its own
+root directory. Every start runs one phase on the worker part, so all workers
+run the same phase at once. Operations are done through own Device clone in
+order to have own timer and use directory descriptor relative FileTree. **/
+class MetadataWorker : public QThread {
+public:
+	/** Prepares worker
+	  @param device device clone used exclusively by this worker
+	  @param test benchmark the worker belongs to
+	  @param root existing directory the worker tree is built in
+	  @param dirs count of directories to create
+	  @param files count of files to create
+	  @param min_size minimal file size
+	  @param max_size maximal file size
+	  @param stream random stream of this worker **/
+	MetadataWorker(Device *device, Benchmark *test, QString root, int dirs, int files, hddsize min_size, hddsize max_size,
+			int stream);
+
+	void run();	/// Runs selected phase
+
+	int phase;										/// Phase run by next start
+	hddsize ops[MetadataResult::PHASE_COUNT];		/// Operations done in every phase
+	Histogram histogram[MetadataResult::PHASE_COUNT];	/// Operation latencies of every phase
+
+private:
+	void Create();	// builds random tree
+	void Stat();	// reads attributes of all entries
+	void Read();	// reads files in random order
+	void Delete();	// removes whole tree except root
+
+	Device *device;
+	Benchmark *test;
+	int dirs;
+	int files;
+	hddsize min_size;
+	hddsize max_size;
+
+	RandomGenerator random;
+	FileTree tree;
+};
+
+/// Parallel metadata mode of filesystem benchmarks
+/** ParallelMetadata partitions random directory tree across increasing count
+of worker threads. Workers create, stat, read and delete their entries at once
+and aggregate operations per second of every phase are reported for every thread
+count, showing how filesystem metadata operations scale. The same total count of
+entries is used for every thread count. The class owns its results,
+so benchmarks only forward their calls in parallel mode.
+@see ParallelMetadataBars class **/
+class ParallelMetadata {
+public:
+	/** Prepares parallel mode subtests
+	  @param test benchmark the mode belongs to
+	  @param dirs total count of directories
+	  @param files total count of files
+	  @param min_size minimal file size
+	  @param max_size maximal file size **/
+	ParallelMetadata(Benchmark *test, int dirs, int files, hddsize min_size, hddsize max_size);
+
+	static const int PARALLEL_METADATA_COUNT = 6;	/// Subtest count (1 to 32 threads)
+
+	QList<MetadataResult> results;		/// Primary results
+	QList<MetadataResult> reference;	/// Reference results
+
+	void TestLoop();	/// Runs all subtests on benchmark device
+
+	int GetProgress();		/// Returns parallel mode progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Benchmark::Metric> GetMetrics();	/// Returns operations per second of every thread count
+	QString Description();	/// Returns mode description for benchmark info
+
+	void WriteResults(ResultWriter &writer);	/// Writes results to Parallel element
+
+	/** Reads results from Parallel element
+	  @param root benchmark element
+	  @param dataset which results are to be replaced **/
+	void RestoreResults(const ResultElement &root, Benchmark::DataSet dataset);
+
+	void EraseResults(Benchmark::DataSet dataset);	/// Erases selected results
+
+private:
+	Benchmark *test;
+	int dirs;
+	int files;
+	hddsize min_size;
+	hddsize max_size;
+};
@@ -0,0 +1,65 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "parallelmetadatabars.h"
+
+ParallelMetadataBars::ParallelMetadataBars(TestWidget *widget, ParallelMetadata *parallel):
+	widget(widget), parallel(parallel) {
+	// add bars to scene, they are shown in parallel mode only
+	int count = parallel->results.size() + parallel->reference.size();
+	for(int i = 0; i < parallel->results.size(); ++i) {
+		TestWidget::Bar *bar = widget->addBar(
+				"ops/s",
+				QString::number(parallel->results[i].__threads),
+				QColor(0xff, 0xa0 * (i+1) / parallel->results.size(), 0),
+				2*i * 1.0f / count,
+				1.0f / (count + 1));
+		bar->SetVisible(false);
+		bars.push_back(bar);
+	}
+
+	for(int i = 0; i < parallel->reference.size(); ++i) {
+		TestWidget::Bar *bar = widget->addBar(
+				"ops/s",
+				QString::number(parallel->reference[i].__threads),
+				QColor(0, 0xc0 * (i+1) / parallel->reference.size(), 0xff),
+				(2*i + 1) * 1.0f / count,
+				1.0f / (count + 1));
+		bar->SetVisible(false);
+		reference_bars.push_back(bar);
+	}
+}
+
+void ParallelMetadataBars::UpdateScene(bool visible) {
+	for(int i = 0; i < parallel->results.size(); ++i) {
+		const MetadataResult &result = parallel->results.at(i);
+		const MetadataResult &refer = parallel->reference.at(i);
+
+		bars[i]->SetVisible(visible);
+		bars[i]->Set(result.__done?100:0, result.TotalOpsPerSecond());
+		bars[i]->SetName(QString::number(result.__threads) + "\np99 " +
+				Def::FormatTime(widget->Settled(result.__histogram[MetadataResult::PHASE_CREATE], Benchmark::RESULTS).Percentile(99)));
+
+		reference_bars[i]->SetVisible(visible);
+		reference_bars[i]->Set(refer.__done?100:0, refer.TotalOpsPerSecond());
+		reference_bars[i]->SetName(QString::number(refer.__threads) + "\np99 " +
+				Def::FormatTime(widget->Settled(refer.__histogram[MetadataResult::PHASE_CREATE], Benchmark::REFERENCE).Percentile(99)));
+	}
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "parallelmetadata.h"
+
+/// Bars of parallel metadata mode
+/** ParallelMetadataBars draws aggregate operations per second of every
+thread count of ParallelMetadata results. Bars are shown in parallel mode
+only, so widgets only forward their scene updates.
+@see ParallelMetadata class **/
+class ParallelMetadataBars {
+public:
+	/** Adds parallel mode bars to widget
+	  @param widget widget the bars are drawn to
+	  @param parallel parallel mode shown by bars **/
+	ParallelMetadataBars(TestWidget *widget, ParallelMetadata *parallel);
+
+	/** Updates bars
+	  @param visible whenever parallel mode is selected **/
+	void UpdateScene(bool visible);
+
+private:
+	TestWidget *widget;
+	ParallelMetadata *parallel;
+
+	QList<TestWidget::Bar*> bars;
+	QList<TestWidget::Bar*> reference_bars;
+};
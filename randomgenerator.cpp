@@ -20,21 +20,133 @@
 
 #include "randomgenerator.h"
 
-RandomGenerator::RandomGenerator() {
-	memset(&data, 0, sizeof(random_data));
-	initstate_r(1, state, statelen, &data);
-	time_t t;
-	time(&t);
-	srandom(t);
+#include <math.h>
+
+static inline quint64 Rotate(quint64 x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+RandomGenerator::RandomGenerator(quint64 seed, int stream):
+	seed(seed) {
+	// every stream starts from different point of splitmix sequence
+	quint64 x = seed ^ ((quint64)stream * Q_UINT64_C(0xd1342543de82ef95));
+	for(int i = 0; i < 4; ++i) {
+		state[i] = SplitMix(x);
+	}
 }
 
 qint32 RandomGenerator::Get32() {
-	int32_t result;
-	random_r(&data, &result);
+	return Next() >> 33;
+}
+
+qint64 RandomGenerator::Get64() {
+	return Next() >> 1;
+}
+
+quint64 RandomGenerator::Next() {
+	const quint64 result = Rotate(state[1] * 5, 7) * 9;
+	const quint64 t = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = Rotate(state[3], 45);
 
 	return result;
 }
 
-qint64 RandomGenerator::Get64() {
-	return ((qint64)( Get32()) << 32) | Get32();
+qreal RandomGenerator::Uniform() {
+	// 53 bits fill mantissa of double
+	return (Next() >> 11) * (1.0 / (Q_UINT64_C(1) << 53));
+}
+
+quint64 RandomGenerator::Below(quint64 bound) {
+	// multiply and reject the few values that would make low numbers more likely
+	unsigned __int128 m = (unsigned __int128)Next() * bound;
+	quint64 low = (quint64)m;
+	if(low < bound) {
+		const quint64 threshold = -bound % bound;
+		while(low < threshold) {
+			m = (unsigned __int128)Next() * bound;
+			low = (quint64)m;
+		}
+	}
+
+	return m >> 64;
+}
+
+quint64 RandomGenerator::Seed() const {
+	return seed;
+}
+
+quint64 RandomGenerator::SplitMix(quint64 &x) {
+	quint64 z = (x += Q_UINT64_C(0x9e3779b97f4a7c15));
+	z = (z ^ (z >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+	z = (z ^ (z >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+
+	return z ^ (z >> 31);
+}
+
+RandomOffset::RandomOffset(hddsize begin, hddsize end, hddsize block, hddsize align):
+	align(align) {
+	// first aligned position in range
+	this->begin = (begin + align - 1) / align * align;
+	count = (end - this->begin >= block)?(end - this->begin - block) / align + 1:0;
+}
+
+hddsize RandomOffset::Get(RandomGenerator &gen) const {
+	return begin + gen.Below(count) * align;
+}
+
+quint64 RandomOffset::Count() const {
+	return count;
+}
+
+hddsize RandomOffset::At(quint64 index) const {
+	return begin + index * align;
+}
+
+Zipfian::Zipfian(quint64 count, qreal theta):
+	count(qMax(count, (quint64)1)), theta(qBound(0.0, theta, 0.999)) {
+	zetan = Zeta(this->count, this->theta);
+	alpha = 1.0 / (1.0 - this->theta);
+	half = pow(0.5, this->theta);
+	eta = (1.0 - pow(2.0 / this->count, 1.0 - this->theta)) / (1.0 - (1.0 + half) / zetan);
+}
+
+quint64 Zipfian::Get(RandomGenerator &gen) const {
+	// rank of index, the lowest ranks are the hottest ones
+	qreal u = gen.Uniform();
+	qreal uz = u * zetan;
+	quint64 rank;
+	if(uz < 1.0) {
+		rank = 0;
+	} else if(uz < 1.0 + half) {
+		rank = 1;
+	} else {
+		rank = qMin((quint64)(count * pow(eta * u - eta + 1.0, alpha)), count - 1);
+	}
+
+	// spread ranks across range
+	quint64 x = rank * Q_UINT64_C(0x9e3779b97f4a7c15);
+	x = (x ^ (x >> 31)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+
+	return (x ^ (x >> 29)) % count;
+}
+
+qreal Zipfian::Zeta(quint64 count, qreal theta) {
+	// sum the first terms, approximate the rest by integral
+	const quint64 exact = qMin(count, (quint64)1 << 20);
+	qreal sum = 0;
+	for(quint64 i = 1; i <= exact; ++i) {
+		sum += pow((qreal)i, -theta);
+	}
+	if(count > exact) {
+		sum += (pow((qreal)count, 1.0 - theta) - pow((qreal)exact, 1.0 - theta)) / (1.0 - theta) +
+				(pow((qreal)count, -theta) - pow((qreal)exact, -theta)) / 2;
+	}
+
+	return sum;
 }
@@ -26,23 +26,95 @@
 #include <stdint.h>
 #include <iostream>
 
+#include "definitions.h"
+
 using namespace std;
+using namespace HDDTest;
 
 /// Implements deterministic random genrator
-/** Implementation of predictable random number generator.
-Provides two methods for querying random numbers (32 and 64 bit).
-Uses random with states internaly.
-Random number stability is guaranted only on the same machine with thw same SW versions **/
+/** Implementation of xoshiro256** random number generator. Sequence is given
+only by seed, so it is the same on every machine and benchmark started with
+the seed stored in result file reads the same positions again. Generator is
+not thread safe, every worker thread should use its own instance created with
+the same seed and unique stream number, streams are seeded independently.
+Provides 31 and 63 bit non-negative numbers and unbiased numbers in range. **/
 class RandomGenerator {
 public:
-	RandomGenerator();	/// Initalize generator with stable seed
+	static constexpr quint64 DEFAULT_SEED = 1;	/// Seed used when none is given
+
+	/** Initalize generator
+	  @param seed sequence seed
+	  @param stream number of independent sequence of the same seed **/
+	RandomGenerator(quint64 seed = DEFAULT_SEED, int stream = 0);
+
+	qint32 Get32();	/// Gets predictible non-negative 32bit integer
+	qint64 Get64();	/// Gets predictible non-negative 64bit integer
+	quint64 Next();	/// Gets next raw 64 bit value
+	qreal Uniform();	/// Gets uniform real number from 0 to 1 (exclusive)
+
+	/** Gets unbiased number in range
+	  @param bound upper bound, must be positive
+	  @return number from 0 to bound - 1 **/
+	quint64 Below(quint64 bound);
+
+	quint64 Seed() const;	/// Seed generator was created with
+
+private:
+	static quint64 SplitMix(quint64 &x);	// seeding generator
+
+	quint64 seed;
+	quint64 state[4];
+};
+
+/// Generates random aligned positions
+/** RandomOffset draws block positions uniformly from range of device.
+Every position is multiple of alignment and whole block fits to range, so
+positions are valid for direct (O_DIRECT) access when alignment is multiple
+of logical block size. Range too small for one block has no positions. **/
+class RandomOffset {
+public:
+	/** Creates offset generator
+	  @param begin first byte of range
+	  @param end byte behind range
+	  @param block size of accessed block
+	  @param align alignment of positions **/
+	RandomOffset(hddsize begin, hddsize end, hddsize block, hddsize align);
+
+	/** Gets next position, must not be called when Count is 0
+	  @param gen random number source
+	  @return block position **/
+	hddsize Get(RandomGenerator &gen) const;
+
+	quint64 Count() const;			/// Count of positions
+	hddsize At(quint64 index) const;	/// Position of given index
+
+private:
+	hddsize begin;
+	hddsize align;
+	quint64 count;	// count of aligned positions
+};
+
+/// Generates Zipfian distributed indexes
+/** Zipfian draws indexes so that few of them are accessed most of the time,
+as database pages or other hot data are. Rank of index is drawn by Gray's
+method and scrambled by hash, so hot indexes are spread across whole range
+instead of forming one area at its beginning. **/
+class Zipfian {
+public:
+	/** Creates distribution
+	  @param count count of indexes
+	  @param theta skew from 0 (uniform) to 1 (exclusive), 0.99 is usual hot set **/
+	Zipfian(quint64 count, qreal theta);
 
-	qint32 Get32();	/// Gets predictible 32bit integer
-	qint64 Get64();	/// Gets predictible 64bit integer
+	/** Gets next index
+	  @param gen random number source
+	  @return index from 0 to count - 1 **/
+	quint64 Get(RandomGenerator &gen) const;
 
 private:
-	static const int statelen = 10;
+	static qreal Zeta(quint64 count, qreal theta);	// generalized harmonic number
 
-	struct random_data data;
-	char state[statelen];
+	quint64 count;
+	qreal theta;
+	qreal alpha, zetan, eta, half;
 };
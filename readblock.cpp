@@ -20,8 +20,8 @@
 
 #include "readblock.h"
 
-ReadBlock::ReadBlock(QWidget *parent):
-	TestWidget(parent) {
+ReadBlock::ReadBlock(QObject *parent):
+	Benchmark(parent) {
 	// add subtests to subtest list
 	int base = READ_BLOCK_BASE_BLOCK_SIZE;
 	for(int i = 0; i < READ_BLOCK_BLOCK_SIZE_COUNT; ++i) {
@@ -40,28 +40,6 @@ ReadBlock::ReadBlock(QWidget *parent):
 			testDescription += ", ";
 		testDescription += Def::FormatSize(results[i].__block_size);
 	}
-
-	// add bars to scene
-	for(int i = 0; i < results.size(); ++i) {
-		Bar *bar = this->addBar(
-				"MB/s",
-				Def::FormatSize(results[i].__block_size),
-				QColor(0xff, 0xa0 * (i+1) / results.size(), 0),
-				2*i * 1.0f / (results.size() + reference.size()),
-				1.0f / (results.size() + reference.size() + 1));
-		bars.push_back(bar);
-	}
-
-	// add reference bars to scene
-	for(int i = 0; i < reference.size(); ++i) {
-		Bar *bar = this->addBar(
-				"MB/s",
-				Def::FormatSize(reference[i].__block_size),
-				QColor(0, 0xc0 * (i+1) / reference.size(), 0xff),
-				(2*i + 1) * 1.0f / (reference.size() + reference.size()),
-				1.0f / (reference.size() + reference.size() + 1));
-		reference_bars.push_back(bar);
-	}
 }
 
 void ReadBlock::TestLoop() {
@@ -70,14 +48,26 @@ void ReadBlock::TestLoop() {
 		results[i].erase();
 	}
 
+	// allocate read buffer for the biggest block before timed reads
+	device->PrepareBuffer(READ_BLOCK_BASE_BLOCK_SIZE);
+
 	// run subtests
 	for(int i = 0; i < results.size(); ++i) {
 		ReadBlockResult *result = &results[i];
 
+		// record latency of every block
+		device->timer.SetHistogram(&result->__histogram);
+
 		// run subtest
 		while(result->__bytes_read < READ_BLOCK_SIZE) {
 			result->__time_elapsed += device->Read(result->__block_size);
-			result->__bytes_read += result->__block_size;
+
+			// direct access reads whole logical blocks, count what was really read
+			hddsize done = device->GetTransferred();
+			if(done <= 0) {
+				break;
+			}
+			result->__bytes_read += done;
 
 			if(testState == STOPPING) {
 				return;
@@ -91,32 +81,37 @@ void ReadBlock::TestLoop() {
 }
 
 
-void ReadBlock::InitScene() {}
+int ReadBlock::GetProgress() {
+	hddsize read = 0;
+
+	for(int i = 0; i < results.size(); ++i)
+		read += results[i].__bytes_read;
+	return (100 * read) / (results.size() * READ_BLOCK_SIZE);
+}
 
-void ReadBlock::UpdateScene() {
-	// update subtest results
+QString ReadBlock::GetSummary() {
+	QString summary;
 	for(int i = 0; i < results.size(); ++i) {
-		//// update subresult
 		const ReadBlockResult &result = results.at(i);
-		const ReadBlockResult &refer = reference.at(i);
-
-		// rescale and update graphics
-		bars[i]->Set(
-				(qreal)(100 * result.__bytes_read) / READ_BLOCK_SIZE,
-				(result.__time_elapsed > 0)?(qreal)result.__bytes_read / (qreal)result.__time_elapsed:0);
-		reference_bars[i]->Set(
-				(qreal)(100 * refer.__bytes_read) / READ_BLOCK_SIZE,
-				(refer.__time_elapsed > 0)?(qreal)refer.__bytes_read / (qreal)refer.__time_elapsed:0);
-		Rescale();
+		qreal speed = (result.__time_elapsed > 0)?(qreal)result.__bytes_read * us / (qreal)result.__time_elapsed:0;
+		summary += Def::FormatSize(result.__block_size) + ": " + QString::number(speed, 'f', 1) + " MB/s, " +
+				result.__histogram.Summary() + "\n";
 	}
+
+	return summary.trimmed();
 }
 
-int ReadBlock::GetProgress() {
-	hddsize read = 0;
+QList<Benchmark::Metric> ReadBlock::GetMetrics() {
+	QList<Metric> metrics;
+	for(int i = 0; i < results.size(); ++i) {
+		const ReadBlockResult &result = results.at(i);
+		if(result.__time_elapsed > 0) {
+			metrics.append(Metric("Speed " + Def::FormatSize(result.__block_size),
+					(qreal)result.__bytes_read * us / (qreal)result.__time_elapsed, "MB/s", true));
+		}
+	}
 
-	for(int i = 0; i < results.size(); ++i)
-		read += results[i].__bytes_read;
-	return (100 * read) / (results.size() * READ_BLOCK_SIZE);
+	return metrics;
 }
 
 ReadBlockResult::ReadBlockResult(hddsize block_size):
@@ -128,32 +123,41 @@ void ReadBlockResult::erase() {
 	// reset bytes read and time elapsed
 	this->__bytes_read = 0;
 	this->__time_elapsed = 0;
+	this->__histogram.erase();
 }
 
-QDomElement ReadBlock::WriteResults(QDomDocument &doc) {
+void ReadBlock::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("Read_Block");
-	master.setAttribute("valid", (GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("Read_Block");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
 
 	// write subresults
 	for(int i = 0; i < results.size(); ++i) {
 		// add build element
-		QDomElement build = doc.createElement("Result");
-		build.setAttribute("size", results[i].__block_size);
-		build.setAttribute("time", results[i].__time_elapsed);
-		master.appendChild(build);
+		writer.StartElement("Result");
+		writer.Attribute("size", results[i].__block_size);
+		writer.Attribute("time", results[i].__time_elapsed);
+		results[i].__histogram.Write(writer);
+		writer.EndElement();
 	}
 
-	return master;
+	sampler.Write(writer);
+
+	writer.EndElement();
 }
 
-void ReadBlock::RestoreResults(QDomElement &results, DataSet dataset) {
+void ReadBlock::RestoreResults(const ResultElement &results, DataSet dataset) {
 	QList<ReadBlockResult> &res = (dataset == REFERENCE)?this->reference:this->results;
 
 	// Locate main readblock element
-	QDomElement seek = results.firstChildElement("Read_Block");
-	if(!seek.attribute("valid", "no").compare("no")) {
+	ResultElement seek = results.Child("Read_Block");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(seek);
+	}
+	if(!seek.Attribute("valid", "no").compare("no")) {
 		return;
 	}
 
@@ -163,22 +167,22 @@ void ReadBlock::RestoreResults(QDomElement &results, DataSet dataset) {
 	}
 
 	// get list of readblock subresults
-	QDomNodeList xmlresults = seek.elementsByTagName("Result");
+	ResultList xmlresults = seek.Children("Result");
 
 	// read subresults
-	for(int i = 0; i < this->results.size(); ++i) {
-		res[i].__block_size = xmlresults.at(i).toElement().attribute("size").toLongLong();
-		res[i].__time_elapsed = xmlresults.at(i).toElement().attribute("time").toLongLong();
+	hddtime unit = Def::StoredTimeUnit(seek);
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		res[i].__block_size = xmlresults.At(i).Integer("size");
+		res[i].__time_elapsed = xmlresults.At(i).Integer("time") * unit;
 		res[i].__bytes_read = READ_BLOCK_SIZE;
+		res[i].__histogram.Read(xmlresults.At(i));
 	}
-
-	// refresh view
-	UpdateScene();
 }
 
 void ReadBlock::EraseResults(DataSet dataset) {
 	// erase data
 	if(dataset == RESULTS) {
+		sampler.erase();
 		for(int i = 0; i < results.size(); ++i) {
 			results[i].erase();
 		}
@@ -187,7 +191,4 @@ void ReadBlock::EraseResults(DataSet dataset) {
 			reference[i].erase();
 		}
 	}
-
-	// refresh view
-	UpdateScene();
 }
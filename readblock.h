@@ -20,7 +20,7 @@
 
 #pragma once
 
-#include "testwidget.h"
+#include "benchmark.h"
 #include "randomgenerator.h"
 #include "device.h"
 
@@ -34,18 +34,19 @@ public:
 	hddsize __bytes_read;	/// Count of bytes read by selected block size
 	hddtime __time_elapsed;	/// Time elased while reading
 	hddsize __block_size;	/// Size of the block for this subtest
+	Histogram __histogram;	/// Block read latencies
 
 	void erase(); /// Erase all values
 };
 
 /// Read Block benchmark main class
 /** Read Block test. The test reads blocks of differsent sizes from the device.
-Bar graphs for every block size are drawn to the graph.
-@see ReadBlockResults class **/
-class ReadBlock : public TestWidget {
+@see ReadBlockResults class
+@see ReadBlockWidget class **/
+class ReadBlock : public Benchmark {
 public:
 	// ReadRnd class constructor
-	ReadBlock(QWidget *parent = 0);	/// The constructor
+	ReadBlock(QObject *parent = 0);	/// The constructor
 
 	static const hddsize READ_BLOCK_SIZE = 100 * M;				/// Data to be read by every block size
 	static const hddsize READ_BLOCK_BASE_BLOCK_SIZE = 1 * M;	/// base block size for first substes
@@ -53,19 +54,15 @@ public:
 	static const int READ_BLOCK_BLOCK_SIZE_STEP = 2;			/// Divisior for next subtest
 
 	void TestLoop();	/// Main benchmark code
-	void InitScene();	/// Initializes scene before benchmark begins
-	void UpdateScene();	/// Updates scene
 	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
 
 	// list of subtest results
 	QList<ReadBlockResult> results;		/// Primary results
 	QList<ReadBlockResult> reference;	/// Reference results
 
-	QDomElement WriteResults(QDomDocument &doc);				/// Writes results of test to XML
-	void RestoreResults(QDomElement &root, DataSet dataset);	/// Reads results from XML document
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
 	void EraseResults(DataSet dataset);							/// Erases selected results
-
-private:
-	QList<Bar*> bars;
-	QList<Bar*> reference_bars;
 };
@@ -20,31 +20,33 @@
 
 #include "readcont.h"
 
-ReadCont::ReadCont(QWidget *parent):
-	TestWidget(parent) {
-	// add line components to graph
-	averageLine = addLine("MB/s", "", QColor(255, 0, 0));
-	refAverageLine = addLine("MB/s", "", QColor(0, 0, 255));
-
-	// add line graph component to graph
-	graph = addLineGraph("MB/s", QColor(255, 128, 128));
-	refGraph = addLineGraph("MB/s", QColor(128, 128, 255));
-
-	// add background net
-	net = addNet("MB/s", "Device position", "Read speed");
+ReadCont::ReadCont(QObject *parent):
+	Benchmark(parent) {
+	AddMode("Beginning");
+	AddMode("Full surface, sparse");
+	AddMode("Full surface");
+	AddMode("Full surface, dense");
 
 	testName = "Read Continuous";
 	testDescription = "Read Continuous test reads " + Def::FormatSize(READ_CONT_SIZE) + " from device." +
 			" Read operation is divided into blocks of " + Def::FormatSize(READ_CONT_BLOCK) + " in order to draw graph." +
-			" Horizontal axis is device position and vertical is read speed.";
- }
+			" Horizontal axis is device position and vertical is read speed." +
+			" Full surface modes read " + QString::number(READ_CONT_SAMPLES) + " windows of " + Def::FormatSize(READ_CONT_WINDOW) +
+			" spread evenly across the whole device instead (sparse and dense modes read 4 times less or more windows)," +
+			" so slower inner parts and damaged regions of big drives are shown in reasonable time.";
+}
 
 ReadCont::~ReadCont() {}
 
 void ReadCont::TestLoop() {
-	// erase old results
-	results.erase();
+	if(mode == MODE_BEGINNING) {
+		BeginningLoop();
+	} else {
+		SurfaceLoop(GetSurfaceSamples());
+	}
+}
 
+void ReadCont::BeginningLoop() {
 	// get test size
 	hddsize bytes_to_read = READ_CONT_SIZE;
 	if(bytes_to_read > device->GetSize())
@@ -52,46 +54,77 @@ void ReadCont::TestLoop() {
 
 	// get block count
 	results.blocks = bytes_to_read / READ_CONT_BLOCK;
+	results.span = results.blocks * READ_CONT_BLOCK;
+
+	// allocate result lists and read buffer before timed reads
+	results.results.reserve(results.blocks);
+	results.positions.reserve(results.blocks);
+	device->PrepareBuffer(READ_CONT_BLOCK);
+
+	// record latency of every block
+	device->timer.SetHistogram(&results.histogram);
 
 	// read block until enough data is read
 	for(results.blocks_done = 1; results.blocks_done <= results.blocks; ++results.blocks_done) {
 		hddtime time = device->Read(READ_CONT_BLOCK);
-		results.AddResult((qreal)READ_CONT_BLOCK / time);
+		results.AddResult((qreal)READ_CONT_BLOCK * us / time, (results.blocks_done - 1) * READ_CONT_BLOCK);
 
 		if(testState == STOPPING)
 			break;
 	}
 }
 
-void ReadCont::InitScene() {
-	graph->erase();
-	results.erase();
-}
+void ReadCont::SurfaceLoop(int samples) {
+	hddsize size = device->GetSize();
+	if(size < READ_CONT_WINDOW) {
+		return;
+	}
 
-void ReadCont::UpdateScene() {
-	// set line graph line count
-	graph->SetSize(results.blocks);
-	refGraph->SetSize(reference.blocks);
+	// spread windows evenly, the last one ends at the end of device
+	results.blocks = samples;
+	results.span = size;
+	hddsize stride = (size - READ_CONT_WINDOW) / qMax(samples - 1, 1);
 
-	// add all new values to line graph
-	while(!results.new_results.empty()) {
-		qreal data = results.new_results.dequeue();
-		graph->AddValue(data);
-	}
+	// allocate result lists and read buffer before timed reads
+	results.results.reserve(results.blocks);
+	results.positions.reserve(results.blocks);
+	device->PrepareBuffer(READ_CONT_BLOCK);
 
-	// add all new values to reference line graph
-	while(!reference.new_results.empty()) {
-		qreal data = reference.new_results.dequeue();
-		refGraph->AddValue(data);
-	}
+	// record latency of every block
+	device->timer.SetHistogram(&results.histogram);
+
+	// read windows one by one from the beginning to the end of device
+	for(results.blocks_done = 1; results.blocks_done <= results.blocks; ++results.blocks_done) {
+		hddsize pos = (results.blocks_done - 1) * stride;
+		pos -= pos % READ_CONT_BLOCK;
+
+		// seek is not part of window read time
+		device->SetPos(pos);
+
+		hddtime time = 0;
+		for(hddsize done = 0; done < READ_CONT_WINDOW; done += READ_CONT_BLOCK) {
+			time += device->Read(READ_CONT_BLOCK);
+		}
+		results.AddResult((qreal)READ_CONT_WINDOW * us / time, pos);
 
+		if(testState == STOPPING)
+			break;
+	}
+}
 
-	// update horizontal lines
-	averageLine->SetValue(results.avg);
-	refAverageLine->SetValue(reference.avg);
+int ReadCont::GetSurfaceSamples() {
+	switch(mode) {
+	case MODE_SURFACE_SPARSE:
+		return READ_CONT_SAMPLES / 4;
+	case MODE_SURFACE_DENSE:
+		return READ_CONT_SAMPLES * 4;
+	default:
+		return READ_CONT_SAMPLES;
+	}
+}
 
-	// rescale scene to reflect possible new max
-	Rescale();
+void ReadCont::InitResults() {
+	results.erase();
 }
 
 int ReadCont::GetProgress() {
@@ -101,84 +134,127 @@ int ReadCont::GetProgress() {
 	return 100 * results.blocks_done / results.blocks;
 }
 
-ReadContResults::ReadContResults() {
+QString ReadCont::GetSummary() {
+	return "Speed: " + results.stats.Summary("MB/s") + "\n" +
+			"Block read time: " + results.histogram.Summary();
+}
+
+QList<Benchmark::Metric> ReadCont::GetMetrics() {
+	QList<Metric> metrics;
+	if(results.stats.Count() > 0) {
+		metrics.append(Metric("Speed", results.stats.Mean(), "MB/s", true));
+		metrics.append(Metric("Minimal speed", results.stats.Min(), "MB/s", true));
+		metrics.append(Metric("Block read time p99", (qreal)results.histogram.Percentile(99) / ms, "ms", false));
+	}
+
+	return metrics;
+}
+
+ReadContResults::ReadContResults():
+		new_results(RING_SIZE) {
 	erase();
 }
 
-void ReadContResults::AddResult(qreal result) {
+void ReadContResults::AddResult(qreal result, hddsize position) {
 	results.push_back(result);		// add result
-	new_results.enqueue(result);	// add results to new results (not yet drawn)
+	positions.push_back(position);
 
-	// update average
-	qreal sum = 0;
-	for(int i = 0; i < results.size(); ++i)
-		sum += results[i];
-	avg = sum / results.size();
+	// hand result to scene, never blocks measuring thread
+	Sample sample = {result, position};
+	new_results.Push(sample);
+
+	// update statistics
+	stats.Add(result);
 }
 
 void ReadContResults::erase() {
 	this->blocks = 0;
 	this->blocks_done = 0;
+	this->span = 1;
 	results.clear();
-	avg = 0;
+	positions.clear();
+	new_results.Clear();
+	stats.erase();
+	histogram.erase();
 }
 
-QDomElement ReadCont::WriteResults(QDomDocument &doc) {
+void ReadCont::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("Read_Continuous");
-	master.setAttribute("valid", (GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("Read_Continuous");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	const char *modeNames[] = { "beginning", "surface-sparse", "surface", "surface-dense" };
+	writer.Attribute("mode", modeNames[mode]);
+	if(mode != MODE_BEGINNING) {
+		writer.Attribute("windows", GetSurfaceSamples());
+	}
+	writer.Attribute("span", results.span);
 
 	// write subresults
 	for(int i = 0; i < results.results.size(); ++i) {
 		// add speed element
-		QDomElement speed = doc.createElement("Speed");
-		speed.setAttribute("value", results.results[i]);
-		master.appendChild(speed);
+		writer.StartElement("Speed");
+		writer.Attribute("value", results.results[i]);
+		writer.Attribute("position", results.positions[i]);
+		writer.EndElement();
 	}
 
-	return master;
+	// write block latencies
+	results.histogram.Write(writer);
+
+	sampler.Write(writer);
+
+	writer.EndElement();
 }
 
-void ReadCont::RestoreResults(QDomElement &root, DataSet dataset) {
+void ReadCont::RestoreResults(const ResultElement &root, DataSet dataset) {
 	ReadContResults &results = (dataset == REFERENCE)?this->reference:this->results;
 
 	// Locate main readcont element
-	QDomElement main = root.firstChildElement("Read_Continuous");
-	if(!main.attribute("valid", "no").compare("no")) {
+	ResultElement main = root.Child("Read_Continuous");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no")) {
 		return;
 	}
 
-	// init scene and remove results
-	(dataset == REFERENCE)?refGraph->erase():graph->erase();
+	// remove results
 	results.erase();
 
 	// get list of read continuous values
-	QDomNodeList res = main.elementsByTagName("Speed");
-	results.blocks = res.size();
+	ResultList res = main.Children("Speed");
+	ResultColumn values = res.Column("value");
+	ResultColumn positions = res.Column("position");
+	results.blocks = res.Size();
+
+	// older results are continuous blocks from the beginning of device
+	results.span = main.Integer("span", res.Size() * READ_CONT_BLOCK);
+	if(results.span <= 0) {
+		results.span = 1;
+	}
 
 	// read result data
-	for(int i = 0; i < res.size(); ++i) {
-		results.AddResult(res.at(i).toElement().attribute("value", "0").toDouble());
+	for(int i = 0; i < res.Size(); ++i) {
+		results.AddResult(values.Number(i), positions.Integer(i, i * READ_CONT_BLOCK));
 	}
 
 	// set progress
-	results.blocks_done = results.blocks = res.size();
+	results.blocks_done = results.blocks = res.Size();
 
-	// refresh view
-	UpdateScene();
+	// read block latencies
+	results.histogram.Read(main);
 }
 
 void ReadCont::EraseResults(DataSet dataset) {
 	// erase data
 	if(dataset == RESULTS) {
+		sampler.erase();
 		results.erase();
-		graph->erase();
 	} else {
 		reference.erase();
-		refGraph->erase();
 	}
-
-	// refresh view
-	UpdateScene();
 }
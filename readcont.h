@@ -26,7 +26,9 @@
 #include <QString>
 
 #include "device.h"
-#include "testwidget.h"
+#include "benchmark.h"
+#include "ring.h"
+#include "statistics.h"
 
 /// Stores Read Continuous benchmark results
 /** ReadContResults class encapsulates read Continuous benchmark results
@@ -35,47 +37,65 @@ class ReadContResults {
 public:
 	ReadContResults();
 
+	static const int RING_SIZE = 16384;	/// Capacity of new results ring, holds the longest test
+
+	/// One speed sample handed to the scene
+	struct Sample {
+		qreal speed;		/// Speed measured
+		hddsize position;	/// Device position the sample starts at
+	};
+
 	QList<qreal> results;
-	QQueue<qreal> new_results;
+	QList<hddsize> positions;		/// Device position of every result
+	Ring<Sample> new_results;		/// Results not drawn yet
+	hddsize span;					/// Size of device area results are spread over
 	int blocks;
-	qreal avg;
+	Statistics stats;		/// Speed statistics
 	int blocks_done;
+	Histogram histogram;	/// Block read latencies
 
-	void AddResult(qreal result);
+	/** Add one speed sample
+	  @param result speed measured
+	  @param position device position the sample starts at **/
+	void AddResult(qreal result, hddsize position);
 	void erase();
 };
 
 /// Read Continuous benchmark main class
 /** Implenets read continuos test. The test reads blocks from different size from the device.
 Blocks are read continuosly (one by one) for every size from the beginning of the device.
-Bar graph for wvery block size are shown.
-@see ReadContResults **/
-class ReadCont : public TestWidget {
+In full surface modes sample windows evenly spread across the whole device
+are read instead, so the results show speed over the entire device.
+@see ReadContResults
+@see ReadContWidget **/
+class ReadCont : public Benchmark {
 public:
-	ReadCont(QWidget *parent = 0);	/// The constructor
+	ReadCont(QObject *parent = 0);	/// The constructor
 	~ReadCont(); /// The destructor
 
 	static const hddsize READ_CONT_SIZE = 4096 * M;	/// Size of data read from device
 	static const hddsize READ_CONT_BLOCK = 4 * M;	/// Block size by which data are read
+	static const hddsize READ_CONT_WINDOW = 16 * M;	/// Data read by every full surface sample
+	static const int READ_CONT_SAMPLES = 1024;		/// Full surface sample count, sparse and dense modes use 1/4 and 4 times more
+
+	/// Benchmark modes
+	enum Mode { MODE_BEGINNING, MODE_SURFACE_SPARSE, MODE_SURFACE, MODE_SURFACE_DENSE };
 
+	void InitResults();	/// Erases results before benchmark begins
 	void TestLoop();	/// Main benchmark code
-	void InitScene();	/// Initializes scene before benchmark begins
-	void UpdateScene();	/// Updates scene
 	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
 
 	ReadContResults results;	/// Primary results
 	ReadContResults reference;	/// Reference results
 
-	QDomElement WriteResults(QDomDocument &doc);				/// Writes results of test to XML
-	void RestoreResults(QDomElement &root, DataSet dataset);	/// Reads results from XML document
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
 	void EraseResults(DataSet dataset);							/// Erase elected results
 
 private:
-	LineGraph *graph;
-	LineGraph *refGraph;
-
-	Net *net;
-
-	Line *averageLine;
-	Line *refAverageLine;
+	void BeginningLoop();				/// Reads data from the beginning of device
+	void SurfaceLoop(int samples);		/// Reads sample windows across whole device
+	int GetSurfaceSamples();			/// Returns sample count of selected full surface mode
 };
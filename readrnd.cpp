@@ -20,8 +20,8 @@
 
 #include "readrnd.h"
 
-ReadRnd::ReadRnd(QWidget *parent):
-	TestWidget(parent) {
+ReadRnd::ReadRnd(QObject *parent):
+	Benchmark(parent) {
 	// add subtests to subtest list
 	int base = READ_RND_BASE_BLOCK_SIZE;
 	for(int i = 0; i < READ_RND_BLOCK_SIZE_COUNT; ++i) {
@@ -30,6 +30,12 @@ ReadRnd::ReadRnd(QWidget *parent):
 		base /= READ_RND_BLOCK_SIZE_STEP;
 	}
 
+	// add queue depth subtests
+	for(int i = 0, depth = 1; i < READ_RND_QUEUE_DEPTH_COUNT; ++i, depth *= 2) {
+		queue_results.push_back(ReadRndResult(READ_RND_QUEUE_BLOCK_SIZE, depth));
+		queue_reference.push_back(ReadRndResult(READ_RND_QUEUE_BLOCK_SIZE, depth));
+	}
+
 	// test name and description
 	testName = "Read random";
 	testDescription = "Read random test reads " + QString::number(READ_RND_SIZE) +
@@ -41,49 +47,51 @@ ReadRnd::ReadRnd(QWidget *parent):
 		}
 		testDescription += Def::FormatSize(results[i].__block_size);
 	}
+	testDescription += ". Queue depth mode reads at least " + QString::number(READ_RND_QUEUE_SIZE) +
+			" blocks of " + Def::FormatSize(READ_RND_QUEUE_BLOCK_SIZE) +
+			" asynchronously for queue depths from 1 to " + QString::number(queue_results.back().__queue_depth) + ".";
 
-	// add bars to scene
-	for(int i = 0; i < results.size(); ++i) {
-		Bar *bar = this->addBar(
-				"MB/s",
-				Def::FormatSize(results[i].__block_size),
-				QColor(0xff, 0xa0 * (i+1) / results.size(), 0),
-				2*i * 1.0f / (results.size() + reference.size()),
-				1.0f / (results.size() + reference.size() + 1));
-		bars.push_back(bar);
-	}
+	AddMode("Block size");
+	AddMode("Queue depth");
+}
 
-	// add reference bars to scene
-	for(int i = 0; i < reference.size(); ++i) {
-		Bar *bar = this->addBar(
-				"MB/s",
-				Def::FormatSize(reference[i].__block_size),
-				QColor(0, 0xc0 * (i+1) / reference.size(), 0xff),
-				(2*i + 1) * 1.0f / (reference.size() + reference.size()),
-				1.0f / (reference.size() + reference.size() + 1));
-		reference_bars.push_back(bar);
+void ReadRnd::TestLoop() {
+	if(mode == MODE_QUEUE_DEPTH) {
+		QueueDepthLoop();
+	} else {
+		BlockSizeLoop();
 	}
 }
 
-void ReadRnd::TestLoop() {
+void ReadRnd::BlockSizeLoop() {
 	// erase prevoius results
 	for(int i = 0;i < results.size(); ++i)
 		results[i].erase();
 
 	// initialize random number generator
-	RandomGenerator gen;
+	RandomGenerator gen(seed);
+
+	// allocate read buffer for the biggest block before timed reads
+	device->PrepareBuffer(READ_RND_BASE_BLOCK_SIZE);
 
 	// run subtests
 	for(int i = 0; i < results.size(); ++i) {
 		ReadRndResult &result = results[i];
 
+		// record latency of every block
+		device->timer.SetHistogram(&result.__histogram);
+		RandomOffset offsets = GetOffsets(result.__block_size);
+		if(offsets.Count() == 0) {
+			return;
+		}
+
 		// run subtest
 		while(result.__blocks_done < READ_RND_SIZE) {
 			// get new position
-			hddsize newpos = gen.Get64() % (device->GetSize() - result.__block_size);
+			hddsize newpos = offsets.Get(gen);
 
 			result.__time_elapsed += device->ReadAt(result.__block_size, newpos);
-			result.__bytes_read += result.__block_size;
+			result.__bytes_read += device->GetTransferred();
 			result.__blocks_done++;
 
 			if(testState == STOPPING) {
@@ -98,77 +106,145 @@ void ReadRnd::TestLoop() {
 }
 
 
-void ReadRnd::InitScene() {}
+void ReadRnd::QueueDepthLoop() {
+	// erase prevoius results
+	for(int i = 0; i < queue_results.size(); ++i)
+		queue_results[i].erase();
 
-void ReadRnd::UpdateScene() {
-	// update subtest results
-	for(int i = 0; i < results.size(); ++i) {
-		//// update subresult
-		const ReadRndResult &result = results.at(i);
-		const ReadRndResult &refer = reference.at(i);
-
-		// get global max
-		qreal max = 0;
-		for(int j = 0; j < results.size(); ++j) {
-			qreal speed = 0.0f;
-			speed = (qreal)results[j].__bytes_read / results[j].__time_elapsed;
-			if(max < speed) {
-				max = speed;
+	// initialize random number generator
+	RandomGenerator gen(seed);
+
+	// allocate buffer for all requests of the deepest queue before timed reads
+	device->PrepareBuffer(READ_RND_QUEUE_BLOCK_SIZE * queue_results.back().__queue_depth);
+
+	// run subtests
+	for(int i = 0; i < queue_results.size(); ++i) {
+		ReadRndResult &result = queue_results[i];
+
+		// record latency of every request
+		device->timer.SetHistogram(&result.__histogram);
+
+		// one engine per subtest, its queue stays full across batches
+		RandomOffset offsets = GetOffsets(result.__block_size);
+		if(offsets.Count() == 0) {
+			return;
+		}
+
+		AsyncIO *engine = device->CreateQueue(result.__queue_depth);
+		if(engine == NULL) {
+			return;
+		}
+
+		QVector<hddsize> positions(READ_RND_QUEUE_BATCH * result.__queue_depth);
+
+		while(result.__blocks_done < READ_RND_QUEUE_SIZE) {
+			// get new positions outside of timed section
+			for(int j = 0; j < positions.size(); ++j) {
+				positions[j] = offsets.Get(gen);
 			}
-			speed = (qreal)reference[j].__bytes_read / reference[j].__time_elapsed;
-			if(max < speed) {
-				max = speed;
+
+			// the last batch waits for all requests in flight
+			bool last = (result.__blocks_done + positions.size() >= READ_RND_QUEUE_SIZE);
+			result.__time_elapsed += device->ReadAtQueued(engine, result.__block_size, positions, last);
+			result.__bytes_read += device->GetTransferred();
+			result.__blocks_done += positions.size();
+
+			if(testState == STOPPING) {
+				// collect requests still in flight before engine is destroyed
+				if(!last) {
+					device->ReadAtQueued(engine, result.__block_size, QVector<hddsize>(), true);
+				}
+				break;
 			}
 		}
 
-		// rescale and update graphics
-		bars[i]->Set(
-				(qreal)(100 * result.__blocks_done) / READ_RND_SIZE,
-				(result.__time_elapsed > 0)?(qreal)result.__bytes_read / (qreal)result.__time_elapsed:0);
-		reference_bars[i]->Set(
-				(qreal)(100 * refer.__blocks_done) / READ_RND_SIZE,
-				(refer.__time_elapsed > 0)?(qreal)refer.__bytes_read / (qreal)refer.__time_elapsed:0);
-		Rescale();
+		delete engine;
+
+		if(testState == STOPPING) {
+			return;
+		}
 	}
+
+	queue_engine = device->asyncEngine;
 }
 
-ReadRndResult::ReadRndResult(hddsize block_size):
-	__bytes_read(0), __time_elapsed(0), __block_size(block_size) {
+ReadRndResult::ReadRndResult(hddsize block_size, int queue_depth):
+	__bytes_read(0), __time_elapsed(0), __block_size(block_size), __queue_depth(queue_depth) {
 	erase();
 }
 
+qreal ReadRndResult::Speed() const {
+	return (__time_elapsed > 0)?(qreal)__bytes_read * us / (qreal)__time_elapsed:0;
+}
+
+qreal ReadRndResult::IOPS() const {
+	return (__time_elapsed > 0)?(qreal)__bytes_read / __block_size * s / (qreal)__time_elapsed:0;
+}
+
 void ReadRndResult::erase() {
 	// reset bytes read and time elapsed
 	__bytes_read = 0;
 	__time_elapsed = 0;
 	__blocks_done = 0;
+	__histogram.erase();
 }
 
-QDomElement ReadRnd::WriteResults(QDomDocument &doc) {
+void ReadRnd::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("Read_Random");
-	master.setAttribute("valid", (GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("Read_Random");
+	writer.Attribute("valid", (GetBlockProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("seed", seed);
+	writer.Attribute("range_begin", rangeBegin);
+	writer.Attribute("range_end", rangeEnd);
 
 	// write subresults
 	for(int i = 0; i < results.size(); ++i) {
 		// add build element
-		QDomElement build = doc.createElement("Result");
-		build.setAttribute("size", results[i].__block_size);
-		build.setAttribute("time", results[i].__time_elapsed);
-		build.setAttribute("read", results[i].__bytes_read);
-		master.appendChild(build);
+		writer.StartElement("Result");
+		writer.Attribute("size", results[i].__block_size);
+		writer.Attribute("time", results[i].__time_elapsed);
+		writer.Attribute("read", results[i].__bytes_read);
+		results[i].__histogram.Write(writer);
+		writer.EndElement();
+	}
+
+	// write queue depth subresults
+	writer.StartElement("Queue_Depth");
+	writer.Attribute("valid", (GetQueueProgress() == 100)?"yes":"no");
+	writer.Attribute("engine", queue_engine);
+	for(int i = 0; i < queue_results.size(); ++i) {
+		writer.StartElement("Result");
+		writer.Attribute("depth", queue_results[i].__queue_depth);
+		writer.Attribute("size", queue_results[i].__block_size);
+		writer.Attribute("time", queue_results[i].__time_elapsed);
+		writer.Attribute("read", queue_results[i].__bytes_read);
+		writer.Attribute("blocks", queue_results[i].__blocks_done);
+		queue_results[i].__histogram.Write(writer);
+		writer.EndElement();
 	}
+	writer.EndElement();
 
-	return master;
+	sampler.Write(writer);
+
+	writer.EndElement();
 }
 
-void ReadRnd::RestoreResults(QDomElement &results, DataSet dataset) {
+void ReadRnd::RestoreResults(const ResultElement &results, DataSet dataset) {
 	QList<ReadRndResult> &res = (dataset == REFERENCE)?this->reference:this->results;
 
 	// Locate main readrnd element
-	QDomElement seek = results.firstChildElement("Read_Random");
-	if(!seek.attribute("valid", "no").compare("no")) {
+	ResultElement seek = results.Child("Read_Random");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(seek);
+	}
+
+	// queue depth results are valid on their own
+	RestoreQueueResults(seek, dataset);
+
+	if(!seek.Attribute("valid", "no").compare("no")) {
 		return;
 	}
 
@@ -177,22 +253,109 @@ void ReadRnd::RestoreResults(QDomElement &results, DataSet dataset) {
 		res[i].erase();
 	}
 
-	// get list of reads
-	QDomNodeList xmlresults = seek.elementsByTagName("Result");
+	// read subresults, only direct children as queue depth results are nested
+	hddtime unit = Def::StoredTimeUnit(seek);
+	ResultList xmlresults = seek.Children("Result");
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		ResultElement xmlresult = xmlresults.At(i);
+		res[i].__block_size = xmlresult.Integer("size");
+		res[i].__time_elapsed = xmlresult.Integer("time") * unit;
+		res[i].__bytes_read = xmlresult.Integer("read");
+		res[i].__blocks_done = READ_RND_SIZE;
+		res[i].__histogram.Read(xmlresult);
+	}
+}
+
+void ReadRnd::RestoreQueueResults(const ResultElement &root, DataSet dataset) {
+	QList<ReadRndResult> &res = (dataset == REFERENCE)?this->queue_reference:this->queue_results;
+
+	// Locate queue depth element
+	ResultElement queue = root.Child("Queue_Depth");
+	if(!queue.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// get list of queue depth subresults
+	ResultList xmlresults = queue.Children("Result");
 
 	// read subresults
-	for(int i = 0; i < res.size(); ++i) {
-		res[i].__block_size = xmlresults.at(i).toElement().attribute("size").toLongLong();
-		res[i].__time_elapsed = xmlresults.at(i).toElement().attribute("time").toLongLong();
-		res[i].__bytes_read = xmlresults.at(i).toElement().attribute("read").toLongLong();
-		res[i].__blocks_done = READ_RND_SIZE;
+	hddtime unit = Def::StoredTimeUnit(queue);
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		ResultElement xmlresult = xmlresults.At(i);
+		res[i].erase();
+		res[i].__queue_depth = xmlresult.Integer("depth");
+		res[i].__block_size = xmlresult.Integer("size");
+		res[i].__time_elapsed = xmlresult.Integer("time") * unit;
+		res[i].__bytes_read = xmlresult.Integer("read");
+		res[i].__blocks_done = xmlresult.Integer("blocks");
+		res[i].__histogram.Read(xmlresult);
 	}
+}
 
-	// refresh view
-	UpdateScene();
+int ReadRnd::GetQueueProgress() {
+	hddsize progress = 0;
+
+	for(int i = 0; i < queue_results.size(); ++i) {
+		progress += qMin(queue_results[i].__blocks_done, (hddsize)READ_RND_QUEUE_SIZE);
+	}
+
+	return (100 * progress) / (queue_results.size() * READ_RND_QUEUE_SIZE);
 }
 
 int ReadRnd::GetProgress() {
+	if(mode == MODE_QUEUE_DEPTH) {
+		return GetQueueProgress();
+	}
+
+	return GetBlockProgress();
+}
+
+QString ReadRnd::GetSummary() {
+	QString summary;
+	if(mode == MODE_QUEUE_DEPTH) {
+		summary += "Engine: " + queue_engine + "\n";
+		for(int i = 0; i < queue_results.size(); ++i) {
+			const ReadRndResult &result = queue_results.at(i);
+			summary += "QD" + QString::number(result.__queue_depth) + ": " +
+					QString::number(result.Speed(), 'f', 1) + " MB/s, " +
+					QString::number(result.IOPS(), 'f', 0) + " IOPS, " +
+					result.__histogram.Summary() + "\n";
+		}
+	} else {
+		for(int i = 0; i < results.size(); ++i) {
+			const ReadRndResult &result = results.at(i);
+			summary += Def::FormatSize(result.__block_size) + ": " +
+					QString::number(result.Speed(), 'f', 1) + " MB/s, " +
+					result.__histogram.Summary() + "\n";
+		}
+	}
+
+	return summary.trimmed();
+}
+
+QList<Benchmark::Metric> ReadRnd::GetMetrics() {
+	QList<Metric> metrics;
+	for(int i = 0; i < results.size(); ++i) {
+		const ReadRndResult &result = results.at(i);
+		if(result.__time_elapsed > 0) {
+			metrics.append(Metric("Speed " + Def::FormatSize(result.__block_size), result.Speed(), "MB/s", true));
+		}
+	}
+	for(int i = 0; i < queue_results.size(); ++i) {
+		const ReadRndResult &result = queue_results.at(i);
+		if(result.__time_elapsed > 0) {
+			metrics.append(Metric("IOPS QD" + QString::number(result.__queue_depth), result.IOPS(), "IOPS", true));
+		}
+	}
+
+	return metrics;
+}
+
+hddsize ReadRnd::GetRandomBlock() {
+	return (mode == MODE_QUEUE_DEPTH)?READ_RND_QUEUE_BLOCK_SIZE:READ_RND_BASE_BLOCK_SIZE;
+}
+
+int ReadRnd::GetBlockProgress() {
 	hddsize progress = 0;
 
 	for(int i = 0; i < results.size(); ++i) {
@@ -205,6 +368,7 @@ int ReadRnd::GetProgress() {
 void ReadRnd::EraseResults(DataSet dataset) {
 	// erase data
 	if(dataset == RESULTS) {
+		sampler.erase();
 		for(int i = 0; i < results.size(); ++i) {
 			results[i].erase();
 		}
@@ -214,6 +378,9 @@ void ReadRnd::EraseResults(DataSet dataset) {
 		}
 	}
 
-	// refresh view
-	UpdateScene();
+	// erase queue depth data
+	QList<ReadRndResult> &queue = (dataset == RESULTS)?queue_results:queue_reference;
+	for(int i = 0; i < queue.size(); ++i) {
+		queue[i].erase();
+	}
 }
@@ -20,7 +20,7 @@
 
 #pragma once
 
-#include "testwidget.h"
+#include "benchmark.h"
 #include "randomgenerator.h"
 #include "device.h"
 
@@ -29,43 +29,71 @@
 @see ReadRnd class **/
 class ReadRndResult {
 public:
-	ReadRndResult(hddsize block_size);	/// The constructor
+	ReadRndResult(hddsize block_size, int queue_depth = 1);	/// The constructor
 
 	hddsize __bytes_read;		/// Number of bytes read in this subtest
 	hddtime __time_elapsed;		/// time spend reading in this subtest
 	hddsize __block_size;		/// Block size in this subtest
 	hddsize __blocks_done;		/// Count of blocks done in this subtest
+	int __queue_depth;			/// Count of reads in flight in this subtest
+	Histogram __histogram;		/// Block read latencies
+
+	qreal Speed() const;	/// Read speed in bytes per microsecond (MB/s)
+	qreal IOPS() const;		/// Read operations per second
 
 	void erase();	/// Erase results
 };
 
 /// ReadRandom benchmark main class
 /** Read random test. The test reads blocks of differsent sizes from random positions on the device.
-Bar graphs for every block size aredrawn to the graph.
-@see ReadRndResults **/
-class ReadRnd : public TestWidget {
+In queue depth mode small blocks are read asynchronously with increasing count of
+requests in flight. Speed and IOPS for every queue depth are measured instead.
+@see ReadRndResults
+@see ReadRndWidget **/
+class ReadRnd : public Benchmark {
 public:
-	ReadRnd(QWidget *parent = 0); ///ReadRnd class constructor
+	ReadRnd(QObject *parent = 0); ///ReadRnd class constructor
 
 	static const hddsize READ_RND_SIZE = 100;				/// Read random benchmark subtest data size
 	static const hddsize READ_RND_BASE_BLOCK_SIZE = 1 * M;	/// Base block size (first subtest block size)
 	static const int READ_RND_BLOCK_SIZE_COUNT = 12;		/// Subtest count
 	static const int READ_RND_BLOCK_SIZE_STEP = 2;			/// next subtest divisior
 
+	static const hddsize READ_RND_QUEUE_BLOCK_SIZE = 4 * K;	/// Block size used by queue depth subtests
+	static const hddsize READ_RND_QUEUE_SIZE = 2048;		/// Minimal count of blocks read by queue depth subtest
+	static const int READ_RND_QUEUE_BATCH = 16;				/// Blocks per batch as multiple of queue depth
+	static const int READ_RND_QUEUE_DEPTH_COUNT = 9;		/// Queue depth subtest count (1 to 256)
+
+	/// Benchmark modes
+	enum Mode { MODE_BLOCK_SIZE, MODE_QUEUE_DEPTH };
+
 	void TestLoop();	/// Main benchmark code
-	void InitScene();	/// Initializes scene before benchmark begins
-	void UpdateScene();	/// Updates scene
 	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+	hddsize GetRandomBlock();	/// Largest block read at random positions
 
 	// list of subtest results
 	QList<ReadRndResult> results;	/// Primary results
 	QList<ReadRndResult> reference;	/// Reference results
 
-	QDomElement WriteResults(QDomDocument &doc);				/// Writes results of test to XML
-	void RestoreResults(QDomElement &root, DataSet dataset);	/// Reads results from XML document
+	// list of queue depth subtest results
+	QList<ReadRndResult> queue_results;		/// Primary queue depth results
+	QList<ReadRndResult> queue_reference;	/// Reference queue depth results
+	QString queue_engine;					/// Asynchronous engine used for queue depth results
+
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
 	void EraseResults(DataSet dataset);							/// Erases selected resutls
 
 private:
-	QList<Bar*> bars;
-	QList<Bar*> reference_bars;
+	void BlockSizeLoop();	/// Block size subtests
+	void QueueDepthLoop();	/// Queue depth subtests
+	int GetBlockProgress();	/// Returns block size subtests progress
+	int GetQueueProgress();	/// Returns queue depth subtests progress
+
+	/** Reads queue depth results from XML element
+	  @param root Read_Random element
+	  @param dataset which results are to be replaced **/
+	void RestoreQueueResults(const ResultElement &root, DataSet dataset);
 };
@@ -0,0 +1,130 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "readrndwidget.h"
+
+ReadRndWidget::ReadRndWidget(QWidget *parent):
+	TestWidget(new ReadRnd(), parent), test(static_cast<ReadRnd*>(benchmark)) {
+	// add bars to scene
+	for(int i = 0; i < test->results.size(); ++i) {
+		Bar *bar = this->addBar(
+				"MB/s",
+				Def::FormatSize(test->results[i].__block_size),
+				QColor(0xff, 0xa0 * (i+1) / test->results.size(), 0),
+				2*i * 1.0f / (test->results.size() + test->reference.size()),
+				1.0f / (test->results.size() + test->reference.size() + 1));
+		bars.push_back(bar);
+	}
+
+	// add reference bars to scene
+	for(int i = 0; i < test->reference.size(); ++i) {
+		Bar *bar = this->addBar(
+				"MB/s",
+				Def::FormatSize(test->reference[i].__block_size),
+				QColor(0, 0xc0 * (i+1) / test->reference.size(), 0xff),
+				(2*i + 1) * 1.0f / (test->reference.size() + test->reference.size()),
+				1.0f / (test->reference.size() + test->reference.size() + 1));
+		reference_bars.push_back(bar);
+	}
+
+	// add queue depth bars to scene
+	for(int i = 0; i < test->queue_results.size(); ++i) {
+		Bar *bar = this->addBar(
+				"MB/s",
+				"QD" + QString::number(test->queue_results[i].__queue_depth),
+				QColor(0xff, 0xa0 * (i+1) / test->queue_results.size(), 0),
+				2*i * 1.0f / (test->queue_results.size() + test->queue_reference.size()),
+				1.0f / (test->queue_results.size() + test->queue_reference.size() + 1));
+		queue_bars.push_back(bar);
+	}
+
+	// add queue depth reference bars to scene
+	for(int i = 0; i < test->queue_reference.size(); ++i) {
+		Bar *bar = this->addBar(
+				"MB/s",
+				"QD" + QString::number(test->queue_reference[i].__queue_depth),
+				QColor(0, 0xc0 * (i+1) / test->queue_reference.size(), 0xff),
+				(2*i + 1) * 1.0f / (test->queue_reference.size() + test->queue_reference.size()),
+				1.0f / (test->queue_reference.size() + test->queue_reference.size() + 1));
+		queue_reference_bars.push_back(bar);
+	}
+
+	// raw device test can bypass page cache
+	SetDirectIOVisible(true);
+}
+
+void ReadRndWidget::InitScene() {}
+
+void ReadRndWidget::UpdateScene() {
+	// update subtest results
+	for(int i = 0; i < test->results.size(); ++i) {
+		//// update subresult
+		const ReadRndResult &result = test->results.at(i);
+		const ReadRndResult &refer = test->reference.at(i);
+
+		// get global max
+		qreal max = 0;
+		for(int j = 0; j < test->results.size(); ++j) {
+			qreal speed = 0.0f;
+			speed = (qreal)test->results[j].__bytes_read * us / test->results[j].__time_elapsed;
+			if(max < speed) {
+				max = speed;
+			}
+			speed = (qreal)test->reference[j].__bytes_read * us / test->reference[j].__time_elapsed;
+			if(max < speed) {
+				max = speed;
+			}
+		}
+
+		// rescale and update graphics
+		bars[i]->Set(
+				(qreal)(100 * result.__blocks_done) / ReadRnd::READ_RND_SIZE,
+				(result.__time_elapsed > 0)?(qreal)result.__bytes_read * us / (qreal)result.__time_elapsed:0);
+		reference_bars[i]->Set(
+				(qreal)(100 * refer.__blocks_done) / ReadRnd::READ_RND_SIZE,
+				(refer.__time_elapsed > 0)?(qreal)refer.__bytes_read * us / (qreal)refer.__time_elapsed:0);
+		bars[i]->SetName(Def::FormatSize(result.__block_size) + "\np99 " +
+				Def::FormatTime(Settled(result.__histogram, Benchmark::RESULTS).Percentile(99)));
+		reference_bars[i]->SetName(Def::FormatSize(refer.__block_size) + "\np99 " +
+				Def::FormatTime(Settled(refer.__histogram, Benchmark::REFERENCE).Percentile(99)));
+		bars[i]->SetVisible(test->mode == ReadRnd::MODE_BLOCK_SIZE);
+		reference_bars[i]->SetVisible(test->mode == ReadRnd::MODE_BLOCK_SIZE);
+		Rescale();
+	}
+
+	// update queue depth subtest results
+	for(int i = 0; i < test->queue_results.size(); ++i) {
+		const ReadRndResult &result = test->queue_results.at(i);
+		const ReadRndResult &refer = test->queue_reference.at(i);
+
+		queue_bars[i]->Set(qMin((qreal)(100 * result.__blocks_done) / ReadRnd::READ_RND_QUEUE_SIZE, (qreal)100), result.Speed());
+		queue_bars[i]->SetName("QD" + QString::number(result.__queue_depth) + "\n" +
+				QString::number(result.IOPS(), 'f', 0) + " IOPS\np99 " +
+				Def::FormatTime(Settled(result.__histogram, Benchmark::RESULTS).Percentile(99)));
+		queue_bars[i]->SetVisible(test->mode == ReadRnd::MODE_QUEUE_DEPTH);
+
+		queue_reference_bars[i]->Set(qMin((qreal)(100 * refer.__blocks_done) / ReadRnd::READ_RND_QUEUE_SIZE, (qreal)100), refer.Speed());
+		queue_reference_bars[i]->SetName("QD" + QString::number(refer.__queue_depth) + "\n" +
+				QString::number(refer.IOPS(), 'f', 0) + " IOPS\np99 " +
+				Def::FormatTime(Settled(refer.__histogram, Benchmark::REFERENCE).Percentile(99)));
+		queue_reference_bars[i]->SetVisible(test->mode == ReadRnd::MODE_QUEUE_DEPTH);
+	}
+	Rescale();
+}
@@ -0,0 +1,45 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "readrnd.h"
+
+/// Read Random benchmark widget
+/** Shows results of Read Random benchmark. Bar graphs for every block size
+are drawn to the graph, in queue depth mode speed and IOPS for every queue
+depth are drawn instead.
+@see ReadRnd class **/
+class ReadRndWidget : public TestWidget {
+public:
+	ReadRndWidget(QWidget *parent = 0);	/// The constructor
+
+	void InitScene();	/// Initializes scene before benchmark begins
+	void UpdateScene();	/// Updates scene
+
+	ReadRnd *test;	/// Benchmark shown by widget
+
+private:
+	QList<Bar*> bars;
+	QList<Bar*> reference_bars;
+	QList<Bar*> queue_bars;
+	QList<Bar*> queue_reference_bars;
+};
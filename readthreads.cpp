@@ -0,0 +1,289 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "readthreads.h"
+
+ReadThreads::ReadThreads(QObject *parent):
+	Benchmark(parent) {
+	// add subtests to subtest list
+	for(int i = 0, threads = 1; i < READ_THREADS_COUNT; ++i, threads *= 2) {
+		results.push_back(ReadThreadsResult(threads));
+		reference.push_back(ReadThreadsResult(threads));
+	}
+
+	// test name and description
+	testName = "Read threads";
+	testDescription = "Read threads test reads blocks of " + Def::FormatSize(READ_THREADS_BLOCK_SIZE) +
+			" by several threads at once for " + QString::number(READ_THREADS_TIME / s) + "s." +
+			" Every thread has its own device descriptor and buffer, reads its own part of the device" +
+			" and is pinned to a core. Blocks are read randomly or sequentially depending on selected mode." +
+			" Bars show aggregate speed and average read time for every thread count. Thread counts are: ";
+	for(int i = 0; i < results.size(); ++i) {
+		if(i > 0) {
+			testDescription += ", ";
+		}
+		testDescription += QString::number(results[i].__threads);
+	}
+
+	AddMode("Random");
+	AddMode("Sequential");
+}
+
+void ReadThreads::TestLoop() {
+	// erase prevoius results
+	for(int i = 0; i < results.size(); ++i) {
+		results[i].erase();
+	}
+
+	// every worker needs at least one block of range
+	if(GetOffsets(READ_THREADS_BLOCK_SIZE).Count() == 0) {
+		return;
+	}
+
+	int cores = qMax(QThread::idealThreadCount(), 1);
+
+	// run subtests
+	for(int i = 0; i < results.size(); ++i) {
+		ReadThreadsResult &result = results[i];
+
+		// every worker gets its own device clone, part of the device range and random stream,
+		// worker areas start on a grid valid for direct access of the read block
+		hddsize grid = qMax(device->GetBlockSize(), (hddsize)READ_THREADS_BLOCK_SIZE);
+		hddsize begin = (rangeBegin + grid - 1) / grid * grid;
+		hddsize end = (rangeEnd > 0)?qMin(rangeEnd, device->GetSize()):device->GetSize();
+		hddsize length = qMax((end - begin) / result.__threads / grid * grid, grid);
+		QList<Device*> clones;
+		QList<ReadThreadsWorker*> workers;
+		for(int t = 0; t < result.__threads; ++t) {
+			// areas of workers overlap at range end when range is too small for all of them
+			hddsize start = qMin(begin + t * length, qMax((end - length) / grid * grid, begin));
+			Device *clone = device->Clone();
+			clones.push_back(clone);
+			workers.push_back(new ReadThreadsWorker(clone, this, t % cores, mode == MODE_SEQUENTIAL,
+					start, length, RandomGenerator(seed, t)));
+		}
+
+		// run workers
+		Timer timer;
+		timer.MarkStart();
+		for(int t = 0; t < workers.size(); ++t) {
+			workers[t]->start();
+		}
+		for(int t = 0; t < workers.size(); ++t) {
+			workers[t]->wait();
+		}
+		timer.MarkEnd();
+
+		// collect results
+		for(int t = 0; t < workers.size(); ++t) {
+			result.__bytes_read += workers[t]->bytes_read;
+			result.__blocks_done += workers[t]->blocks_done;
+			result.__read_time += workers[t]->read_time;
+			result.__histogram.Merge(workers[t]->histogram);
+			delete workers[t];
+			delete clones[t];
+		}
+		result.__time_elapsed = timer.GetFinalOffset();
+		result.__done = true;
+
+		if(testState == STOPPING) {
+			return;
+		}
+	}
+}
+
+int ReadThreads::GetProgress() {
+	int done = 0;
+
+	for(int i = 0; i < results.size(); ++i) {
+		if(results[i].__done) {
+			++done;
+		}
+	}
+
+	return (100 * done) / results.size();
+}
+
+QString ReadThreads::GetSummary() {
+	QString summary;
+	for(int i = 0; i < results.size(); ++i) {
+		const ReadThreadsResult &result = results.at(i);
+		summary += QString::number(result.__threads) + " threads: " +
+				QString::number(result.Speed(), 'f', 1) + " MB/s, " +
+				result.__histogram.Summary() + "\n";
+	}
+
+	return summary.trimmed();
+}
+
+QList<Benchmark::Metric> ReadThreads::GetMetrics() {
+	QList<Metric> metrics;
+	for(int i = 0; i < results.size(); ++i) {
+		const ReadThreadsResult &result = results.at(i);
+		if(result.__done) {
+			metrics.append(Metric("Speed " + QString::number(result.__threads) + " threads", result.Speed(), "MB/s", true));
+		}
+	}
+
+	return metrics;
+}
+
+hddsize ReadThreads::GetRandomBlock() {
+	return READ_THREADS_BLOCK_SIZE;
+}
+
+ReadThreadsResult::ReadThreadsResult(int threads):
+	__threads(threads) {
+	erase();
+}
+
+qreal ReadThreadsResult::Speed() const {
+	return (__time_elapsed > 0)?(qreal)__bytes_read * us / (qreal)__time_elapsed:0;
+}
+
+qreal ReadThreadsResult::Latency() const {
+	return (__blocks_done > 0)?(qreal)__read_time / (qreal)__blocks_done:0;
+}
+
+void ReadThreadsResult::erase() {
+	__bytes_read = 0;
+	__blocks_done = 0;
+	__time_elapsed = 0;
+	__read_time = 0;
+	__done = false;
+	__histogram.erase();
+}
+
+ReadThreadsWorker::ReadThreadsWorker(Device *device, Benchmark *test, int core, bool sequential, hddsize start, hddsize length,
+		RandomGenerator gen):
+	bytes_read(0), blocks_done(0), read_time(0), device(device), test(test),
+	core(core), sequential(sequential), start(start), length(length), gen(gen),
+	offsets(test->GetOffsets(ReadThreads::READ_THREADS_BLOCK_SIZE, start, length)) {}
+
+void ReadThreadsWorker::run() {
+	// area without room for a block has no random positions
+	if(!sequential && (offsets.Count() == 0)) {
+		return;
+	}
+
+	// pin thread to its core
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+
+	const hddsize block = ReadThreads::READ_THREADS_BLOCK_SIZE;
+	device->PrepareBuffer(block);
+	device->timer.SetHistogram(&histogram);
+	device->SetPos(start);
+	hddsize pos = start;
+
+	// read until subtest time is over
+	Timer timer;
+	timer.MarkStart();
+	while((timer.GetCurrentOffset() < ReadThreads::READ_THREADS_TIME) && (test->testState != Benchmark::STOPPING)) {
+		if(sequential) {
+			// start again at the beginning of worker area, start and length are block aligned
+			if(pos + block > start + length) {
+				pos = start;
+				device->SetPos(start);
+			}
+			read_time += device->Read(block);
+			pos += block;
+		} else {
+			read_time += device->ReadAt(block, offsets.Get(gen));
+		}
+
+		bytes_read += device->GetTransferred();
+		++blocks_done;
+	}
+}
+
+void ReadThreads::WriteResults(ResultWriter &writer) {
+	// create main element
+	writer.StartElement("Read_Threads");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("mode", (mode == MODE_SEQUENTIAL)?"sequential":"random");
+	writer.Attribute("seed", seed);
+	writer.Attribute("range_begin", rangeBegin);
+	writer.Attribute("range_end", rangeEnd);
+
+	// write subresults
+	for(int i = 0; i < results.size(); ++i) {
+		writer.StartElement("Result");
+		writer.Attribute("threads", results[i].__threads);
+		writer.Attribute("time", results[i].__time_elapsed);
+		writer.Attribute("read", results[i].__bytes_read);
+		writer.Attribute("blocks", results[i].__blocks_done);
+		writer.Attribute("readtime", results[i].__read_time);
+		results[i].__histogram.Write(writer);
+		writer.EndElement();
+	}
+
+	sampler.Write(writer);
+
+	writer.EndElement();
+}
+
+void ReadThreads::RestoreResults(const ResultElement &results, DataSet dataset) {
+	QList<ReadThreadsResult> &res = (dataset == REFERENCE)?this->reference:this->results;
+
+	// Locate main element
+	ResultElement main = results.Child("Read_Threads");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// get list of subresults
+	ResultList xmlresults = main.Children("Result");
+
+	// read subresults
+	hddtime unit = Def::StoredTimeUnit(main);
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		ResultElement xmlresult = xmlresults.At(i);
+		res[i].erase();
+		res[i].__threads = xmlresult.Integer("threads");
+		res[i].__time_elapsed = xmlresult.Integer("time") * unit;
+		res[i].__bytes_read = xmlresult.Integer("read");
+		res[i].__blocks_done = xmlresult.Integer("blocks");
+		res[i].__read_time = xmlresult.Integer("readtime") * unit;
+		res[i].__histogram.Read(xmlresult);
+		res[i].__done = true;
+	}
+}
+
+void ReadThreads::EraseResults(DataSet dataset) {
+	// samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.erase();
+	}
+
+	QList<ReadThreadsResult> &res = (dataset == RESULTS)?results:reference;
+	for(int i = 0; i < res.size(); ++i) {
+		res[i].erase();
+	}
+}
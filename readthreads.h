@@ -0,0 +1,118 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <QThread>
+
+#include "benchmark.h"
+#include "randomgenerator.h"
+#include "device.h"
+
+/// Stores Read Threads benchmark results
+/** ReadThreadsResult class keeps results of one subtest, the subtest
+runs fixed count of reading threads at once.
+@see ReadThreads class **/
+class ReadThreadsResult {
+public:
+	ReadThreadsResult(int threads);	/// The constructor
+
+	int __threads;				/// Count of threads reading in this subtest
+	hddsize __bytes_read;		/// Bytes read by all threads
+	hddsize __blocks_done;		/// Blocks read by all threads
+	hddtime __time_elapsed;		/// Wall time of the subtest
+	hddtime __read_time;		/// Sum of read times of all threads
+	bool __done;				/// Whenever the subtest has finished
+	Histogram __histogram;		/// Read latencies of all threads
+
+	qreal Speed() const;	/// Aggregate read speed in bytes per microsecond (MB/s)
+	qreal Latency() const;	/// Average time of one read in one thread
+
+	void erase();	/// Erase results
+};
+
+/// Reading thread of Read Threads benchmark
+/** ReadThreadsWorker reads blocks from its own Device clone until the subtest
+time is over or the benchmark is stopped. The thread is pinned to single core. **/
+class ReadThreadsWorker : public QThread {
+public:
+	/** Prepares worker
+	  @param device device clone used exclusively by this worker
+	  @param test benchmark the worker belongs to
+	  @param core core the thread is pinned to
+	  @param sequential whenever blocks are read sequentially instead of randomly
+	  @param start first position of area read by this worker
+	  @param length size of area read by this worker
+	  @param gen random generator owned by this worker **/
+	ReadThreadsWorker(Device *device, Benchmark *test, int core, bool sequential, hddsize start, hddsize length,
+			RandomGenerator gen);
+
+	void run();	/// Reads blocks until time is over
+
+	hddsize bytes_read;	/// Bytes read by this worker
+	hddsize blocks_done;/// Blocks read by this worker
+	hddtime read_time;	/// Time spent reading by this worker
+	Histogram histogram;/// Read latencies of this worker
+
+private:
+	Device *device;
+	Benchmark *test;
+	int core;
+	bool sequential;
+	hddsize start;
+	hddsize length;
+	RandomGenerator gen;
+	RandomOffset offsets;
+};
+
+/// Read Threads benchmark main class
+/** Read threads test. The test reads blocks from the device by increasing count
+of threads at once. Every thread has its own device descriptor and buffer and is
+pinned to a core. Aggregate speed and average read latency are measured for
+every thread count.
+@see ReadThreadsResult
+@see ReadThreadsWidget **/
+class ReadThreads : public Benchmark {
+public:
+	ReadThreads(QObject *parent = 0);	/// The constructor
+
+	static const hddsize READ_THREADS_BLOCK_SIZE = 64 * K;	/// Size of block read by workers
+	static const hddtime READ_THREADS_TIME = 3 * s;			/// Duration of every subtest
+	static const int READ_THREADS_COUNT = 7;				/// Subtest count (1 to 64 threads)
+
+	/// Benchmark modes
+	enum Mode { MODE_RANDOM, MODE_SEQUENTIAL };
+
+	void TestLoop();	/// Main benchmark code
+	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+	hddsize GetRandomBlock();	/// Block read at random positions by workers
+
+	QList<ReadThreadsResult> results;	/// Primary results
+	QList<ReadThreadsResult> reference;	/// Reference results
+
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
+	void EraseResults(DataSet dataset);							/// Erases selected results
+};
@@ -0,0 +1,42 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "readthreads.h"
+
+/// Read Threads benchmark widget
+/** Shows results of Read Threads benchmark. Aggregate speed bars labelled
+with average read latency are drawn for every thread count.
+@see ReadThreads class **/
+class ReadThreadsWidget : public TestWidget {
+public:
+	ReadThreadsWidget(QWidget *parent = 0);	/// The constructor
+
+	void InitScene();	/// Initializes scene before benchmark begins
+	void UpdateScene();	/// Updates scene
+
+	ReadThreads *test;	/// Benchmark shown by widget
+
+private:
+	QList<Bar*> bars;
+	QList<Bar*> reference_bars;
+};
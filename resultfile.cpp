@@ -0,0 +1,471 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "resultfile.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include <QBuffer>
+#include <QLocale>
+#include <QXmlStreamReader>
+#include <QtNumeric>
+
+const char ResultFile::MAGIC[8] = {'H', 'D', 'D', 'T', 'B', 'I', 'N', '\0'};
+
+// cells of number columns hold bits of double
+static qreal CellNumber(qint64 cell) {
+	qreal value;
+	memcpy(&value, &cell, sizeof(value));
+	return value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// ResultColumn //////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+ResultColumn::ResultColumn():
+	file(NULL), column(-1), table(-1), begin(0) {}
+
+qint64 ResultColumn::Integer(int index, qint64 value) const {
+	if(column < 0) {
+		return value;
+	}
+
+	const ResultFile::Column &values = file->tables[table].columns[column];
+	qint64 cell = values.cells[begin + index];
+	switch(values.type) {
+	case ResultFile::COLUMN_INTEGER:
+		return (cell == ResultFile::NULL_INTEGER)?value:cell;
+	case ResultFile::COLUMN_NUMBER:
+		return ((quint64)cell == ResultFile::NULL_NUMBER)?value:(qint64)CellNumber(cell);
+	default:
+		return (cell == ResultFile::NULL_STRING)?value:file->String(cell).toLongLong();
+	}
+}
+
+qreal ResultColumn::Number(int index, qreal value) const {
+	if(column < 0) {
+		return value;
+	}
+
+	const ResultFile::Column &values = file->tables[table].columns[column];
+	qint64 cell = values.cells[begin + index];
+	switch(values.type) {
+	case ResultFile::COLUMN_INTEGER:
+		return (cell == ResultFile::NULL_INTEGER)?value:(qreal)cell;
+	case ResultFile::COLUMN_NUMBER:
+		return ((quint64)cell == ResultFile::NULL_NUMBER)?value:CellNumber(cell);
+	default:
+		return (cell == ResultFile::NULL_STRING)?value:file->String(cell).toDouble();
+	}
+}
+
+QString ResultColumn::Text(int index, const QString &value) const {
+	if(column < 0) {
+		return value;
+	}
+
+	const ResultFile::Column &values = file->tables[table].columns[column];
+	qint64 cell = values.cells[begin + index];
+	switch(values.type) {
+	case ResultFile::COLUMN_INTEGER:
+		return (cell == ResultFile::NULL_INTEGER)?value:QString::number(cell);
+	case ResultFile::COLUMN_NUMBER:
+		return ((quint64)cell == ResultFile::NULL_NUMBER)?value:
+				QString::number(CellNumber(cell), 'g', QLocale::FloatingPointShortest);
+	default:
+		return (cell == ResultFile::NULL_STRING)?value:file->String(cell);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// ResultElement /////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+ResultElement::ResultElement():
+	file(NULL), table(-1), row(0) {}
+
+ResultElement::ResultElement(const ResultFile *file, int table, int row):
+	file(file), table(table), row(row) {}
+
+bool ResultElement::IsNull() const {
+	return file == NULL;
+}
+
+QString ResultElement::Name() const {
+	return IsNull()?QString():file->tables[table].name;
+}
+
+ResultElement ResultElement::Root() const {
+	return IsNull()?ResultElement():file->Root();
+}
+
+ResultElement ResultElement::Child(const QString &name) const {
+	ResultList list = Children(name);
+	return (list.Size() > 0)?list.At(0):ResultElement();
+}
+
+ResultList ResultElement::Children(const QString &name) const {
+	ResultList list;
+	if(IsNull()) {
+		return list;
+	}
+
+	// elements of the same name and parent share one table
+	const QVector<int> &children = file->tables[table].children;
+	for(int i = 0; i < children.size(); ++i) {
+		if(file->tables[children[i]].name == name) {
+			list.file = file;
+			list.table = children[i];
+			file->Range(row, children[i], list.begin, list.end);
+			break;
+		}
+	}
+
+	return list;
+}
+
+QString ResultElement::Attribute(const QString &name, const QString &value) const {
+	return Column(name).Text(0, value);
+}
+
+qint64 ResultElement::Integer(const QString &name, qint64 value) const {
+	return Column(name).Integer(0, value);
+}
+
+qreal ResultElement::Number(const QString &name, qreal value) const {
+	return Column(name).Number(0, value);
+}
+
+ResultColumn ResultElement::Column(const QString &name) const {
+	ResultColumn column;
+	if(!IsNull()) {
+		column.file = file;
+		column.table = table;
+		column.column = file->FindColumn(table, name);
+		column.begin = row;
+	}
+
+	return column;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// ResultList ////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+ResultList::ResultList():
+	file(NULL), table(-1), begin(0), end(0) {}
+
+int ResultList::Size() const {
+	return end - begin;
+}
+
+ResultElement ResultList::At(int index) const {
+	return ResultElement(file, table, begin + index);
+}
+
+ResultColumn ResultList::Column(const QString &name) const {
+	ResultColumn column;
+	if(file != NULL) {
+		column.file = file;
+		column.table = table;
+		column.column = file->FindColumn(table, name);
+		column.begin = begin;
+	}
+
+	return column;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// ResultFile ////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+ResultFile::ResultFile():
+	data(NULL), size(0) {}
+
+ResultFile::~ResultFile() {}
+
+bool ResultFile::Open(QString filename) {
+	file.setFileName(filename);
+	if(!file.open(QIODevice::ReadOnly)) {
+		error = file.errorString();
+		return false;
+	}
+
+	// binary results are used in place
+	char magic[sizeof(MAGIC)];
+	if((file.peek(magic, sizeof(magic)) != sizeof(magic)) || (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)) {
+		return ReadXml();
+	}
+
+	size = file.size();
+	data = file.map(0, size);
+	if(data == NULL) {
+		// resources cannot be always mapped
+		buffer = file.readAll();
+		data = (const uchar*)buffer.constData();
+	}
+
+	return Load();
+}
+
+QString ResultFile::Error() const {
+	return error;
+}
+
+ResultElement ResultFile::Root() const {
+	if(tables.isEmpty() || (tables[0].rows == 0)) {
+		return ResultElement();
+	}
+
+	return ResultElement(this, 0, 0);
+}
+
+void ResultFile::Write(ResultWriter &writer) const {
+	for(int i = 0; i < tables.size(); ++i) {
+		for(int row = 0; (tables[i].parent < 0) && (row < tables[i].rows); ++row) {
+			WriteElement(writer, i, row);
+		}
+	}
+}
+
+bool ResultFile::ReadXml() {
+	QBuffer output(&buffer);
+	output.open(QIODevice::WriteOnly);
+
+	// convert elements in the same order as they were written
+	BinaryResultWriter writer(&output);
+	writer.StartDocument();
+
+	QXmlStreamReader xml(&file);
+	while(!xml.atEnd()) {
+		xml.readNext();
+		if(xml.isStartElement()) {
+			writer.StartElement(xml.name().toString());
+
+			QXmlStreamAttributes attributes = xml.attributes();
+			for(int i = 0; i < attributes.size(); ++i) {
+				QString name = attributes[i].name().toString();
+				QString value = attributes[i].value().toString();
+
+				// numbers are stored as numbers only if they are written back the same way
+				bool ok = false;
+				qint64 integer = value.toLongLong(&ok);
+				if(ok && (QString::number(integer) == value)) {
+					writer.Attribute(name, (qlonglong)integer);
+					continue;
+				}
+				double number = value.toDouble(&ok);
+				if(ok && qIsFinite(number) && (QString::number(number, 'g', QLocale::FloatingPointShortest) == value)) {
+					writer.Attribute(name, number);
+					continue;
+				}
+				writer.Attribute(name, value);
+			}
+		} else if(xml.isEndElement()) {
+			writer.EndElement();
+		}
+	}
+
+	if(xml.hasError()) {
+		error = xml.errorString() + " at line " + QString::number(xml.lineNumber());
+		return false;
+	}
+
+	writer.EndDocument();
+	output.close();
+
+	data = (const uchar*)buffer.constData();
+	size = buffer.size();
+
+	return Load();
+}
+
+bool ResultFile::Load() {
+	// cells are read in place, so they have to be aligned
+	if(((quintptr)data % sizeof(qint64)) != 0) {
+		buffer = QByteArray((const char*)data, size);
+		if(((quintptr)buffer.constData() % sizeof(qint64)) != 0) {
+			error = "Cannot align result data";
+			return false;
+		}
+		data = (const uchar*)buffer.constData();
+	}
+
+	// check header
+	const Header *header = (const Header*)data;
+	if((size < (qint64)sizeof(Header)) || (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)) {
+		error = "Not a binary result file";
+		return false;
+	}
+	if(header->byte_order != BYTE_ORDER) {
+		error = "Result file was written on machine with other byte order";
+		return false;
+	}
+	if(header->version > VERSION) {
+		error = "Result file was written by newer version";
+		return false;
+	}
+	if(header->size != (quint64)size) {
+		error = "Result file is truncated";
+		return false;
+	}
+
+	// read string table directory
+	quint64 offset = sizeof(Header);
+	if(!Check(offset, (quint64)header->strings * sizeof(StringEntry))) {
+		error = "Invalid string table";
+		return false;
+	}
+	const StringEntry *string_entries = (const StringEntry*)(data + offset);
+	strings.resize(header->strings);
+	for(quint32 i = 0; i < header->strings; ++i) {
+		if(!Check(string_entries[i].offset, string_entries[i].size)) {
+			error = "Invalid string table";
+			return false;
+		}
+		strings[i] = &string_entries[i];
+	}
+	offset += (quint64)header->strings * sizeof(StringEntry);
+
+	// read tables directory, cells stay in file data
+	if(!Check(offset, (quint64)header->tables * sizeof(TableEntry))) {
+		error = "Invalid table directory";
+		return false;
+	}
+	const TableEntry *table_entries = (const TableEntry*)(data + offset);
+	tables.resize(header->tables);
+	for(quint32 i = 0; i < header->tables; ++i) {
+		const TableEntry &entry = table_entries[i];
+		if((entry.name >= header->strings) || (entry.parent >= (qint32)i) || (entry.parent < -1) ||
+				!Check(entry.parents, (quint64)entry.rows * sizeof(quint32)) ||
+				!Check(entry.order, (quint64)entry.rows * sizeof(quint32)) ||
+				!Check(entry.column, (quint64)entry.columns * sizeof(ColumnEntry))) {
+			error = "Invalid table " + QString::number(i);
+			return false;
+		}
+
+		Table &table = tables[i];
+		table.name = String(entry.name);
+		table.parent = entry.parent;
+		table.rows = entry.rows;
+		table.parents = (const quint32*)(data + entry.parents);
+		table.order = (const quint32*)(data + entry.order);
+		if(table.parent >= 0) {
+			tables[table.parent].children.append(i);
+		}
+
+		const ColumnEntry *column_entries = (const ColumnEntry*)(data + entry.column);
+		table.columns.resize(entry.columns);
+		for(quint32 j = 0; j < entry.columns; ++j) {
+			if((column_entries[j].name >= header->strings) || (column_entries[j].type > COLUMN_STRING) ||
+					!Check(column_entries[j].cells, (quint64)entry.rows * sizeof(qint64))) {
+				error = "Invalid column in table " + QString::number(i);
+				return false;
+			}
+			table.columns[j].name = String(column_entries[j].name);
+			table.columns[j].type = column_entries[j].type;
+			table.columns[j].cells = (const qint64*)(data + column_entries[j].cells);
+		}
+	}
+
+	return true;
+}
+
+bool ResultFile::Check(quint64 offset, quint64 size) const {
+	return ((offset % sizeof(qint64)) == 0) && (offset <= (quint64)this->size) && (size <= (quint64)this->size - offset);
+}
+
+QString ResultFile::String(qint64 index) const {
+	if((index < 0) || (index >= strings.size())) {
+		return QString();
+	}
+
+	return QString::fromUtf8((const char*)data + strings[index]->offset, strings[index]->size);
+}
+
+int ResultFile::FindColumn(int table, const QString &name) const {
+	const QVector<Column> &columns = tables[table].columns;
+	for(int i = 0; i < columns.size(); ++i) {
+		if(columns[i].name == name) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void ResultFile::Range(int row, int child, int &begin, int &end) const {
+	// rows are stored in document order, so parent rows are sorted
+	const quint32 *parents = tables[child].parents;
+	int rows = tables[child].rows;
+	begin = std::lower_bound(parents, parents + rows, (quint32)row) - parents;
+	end = std::upper_bound(parents, parents + rows, (quint32)row) - parents;
+}
+
+void ResultFile::WriteElement(ResultWriter &writer, int table, int row) const {
+	const Table &element = tables[table];
+	writer.StartElement(element.name);
+
+	// attributes in column order, missing ones are skipped
+	for(int i = 0; i < element.columns.size(); ++i) {
+		const QString &name = element.columns[i].name;
+		qint64 cell = element.columns[i].cells[row];
+		switch(element.columns[i].type) {
+		case COLUMN_INTEGER:
+			if(cell != NULL_INTEGER) {
+				writer.Attribute(name, (qlonglong)cell);
+			}
+			break;
+		case COLUMN_NUMBER:
+			if((quint64)cell != NULL_NUMBER) {
+				writer.Attribute(name, CellNumber(cell));
+			}
+			break;
+		default:
+			if(cell != NULL_STRING) {
+				writer.Attribute(name, String(cell));
+			}
+		}
+	}
+
+	// child elements of all tables merged back to document order
+	int count = element.children.size();
+	QVector<int> next(count), end(count);
+	for(int i = 0; i < count; ++i) {
+		Range(row, element.children[i], next[i], end[i]);
+	}
+	while(true) {
+		int best = -1;
+		for(int i = 0; i < count; ++i) {
+			if((next[i] < end[i]) && ((best < 0) ||
+					(tables[element.children[i]].order[next[i]] < tables[element.children[best]].order[next[best]]))) {
+				best = i;
+			}
+		}
+		if(best < 0) {
+			break;
+		}
+		WriteElement(writer, element.children[best], next[best]++);
+	}
+
+	writer.EndElement();
+}
@@ -0,0 +1,273 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "definitions.h"
+#include "resultwriter.h"
+
+using namespace HDDTest;
+
+class ResultFile;
+class ResultList;
+
+/// Typed values of one attribute over list of elements
+/** Values are read directly from result file data without any conversion
+when column type matches the requested one. **/
+class ResultColumn {
+public:
+	ResultColumn();	/// Creates column without values
+
+	/** Get value as integer
+	  @param index element index in list
+	  @param value default value when attribute is missing
+	  @return attribute value **/
+	qint64 Integer(int index, qint64 value = 0) const;
+
+	/** Get value as floating point number
+	  @param index element index in list
+	  @param value default value when attribute is missing
+	  @return attribute value **/
+	qreal Number(int index, qreal value = 0) const;
+
+	/** Get value as text
+	  @param index element index in list
+	  @param value default value when attribute is missing
+	  @return attribute value **/
+	QString Text(int index, const QString &value = QString()) const;
+
+private:
+	friend class ResultList;
+	friend class ResultElement;
+
+	const ResultFile *file;
+	int column;		// column index in table, -1 when missing
+	int table;
+	int begin;		// row of the first element in list
+};
+
+/// Element of result file
+/** ResultElement is light handle of one element in ResultFile used by
+RestoreResults. It is only valid while ResultFile
+it comes from exists. Null element is returned for missing elements and
+all its attributes have default values. **/
+class ResultElement {
+public:
+	ResultElement();	/// Creates null element
+
+	bool IsNull() const;	/// Whenever element does not exist
+	QString Name() const;	/// Element name
+
+	ResultElement Root() const;	/// Root element of file element comes from
+
+	/** Get first child element
+	  @param name child element name
+	  @return child element or null element **/
+	ResultElement Child(const QString &name) const;
+
+	/** Get all child elements with the same name
+	  @param name child elements name
+	  @return list of elements in file order **/
+	ResultList Children(const QString &name) const;
+
+	/** Get attribute as text
+	  @param name attribute name
+	  @param value default value when attribute is missing
+	  @return attribute value **/
+	QString Attribute(const QString &name, const QString &value = QString()) const;
+
+	/** Get attribute as integer
+	  @param name attribute name
+	  @param value default value when attribute is missing
+	  @return attribute value **/
+	qint64 Integer(const QString &name, qint64 value = 0) const;
+
+	/** Get attribute as floating point number
+	  @param name attribute name
+	  @param value default value when attribute is missing
+	  @return attribute value **/
+	qreal Number(const QString &name, qreal value = 0) const;
+
+private:
+	friend class ResultFile;
+	friend class ResultList;
+
+	ResultElement(const ResultFile *file, int table, int row);
+
+	ResultColumn Column(const QString &name) const;	// one value column of this element
+
+	const ResultFile *file;
+	int table;
+	int row;
+};
+
+/// List of sibling elements with the same name
+class ResultList {
+public:
+	ResultList();	/// Creates empty list
+
+	int Size() const;	/// Count of elements
+
+	/** Get element
+	  @param index element index in list
+	  @return element **/
+	ResultElement At(int index) const;
+
+	/** Get values of one attribute of all elements in list
+	  @param name attribute name
+	  @return column of values **/
+	ResultColumn Column(const QString &name) const;
+
+private:
+	friend class ResultElement;
+
+	const ResultFile *file;
+	int table;
+	int begin;	// row of the first element
+	int end;	// row after the last element
+};
+
+/// Results loaded from file
+/** ResultFile opens both result file formats. Binary result file is mapped
+to memory and used in place, XML result file is converted to binary form in
+memory once while it is read by QXmlStreamReader.
+
+Binary result file is columnar. Elements with the same name and the same
+parent element kind form one table. Every table stores parent row and
+document order of its rows and one column of 8 byte cells per attribute.
+Cells hold 64 bit integer, double or index to string table, missing values
+have special null value. All integers use byte order of the machine that
+wrote the file, offsets are counted from the beginning of file and aligned
+to 8 bytes:
+ - Header
+ - StringEntry for every string
+ - TableEntry for every table, parent table always precedes its children
+ - ColumnEntry for every column of every table
+ - parent rows (quint32), document order (quint32) and cells of every table
+ - UTF-8 strings **/
+class ResultFile {
+public:
+	ResultFile();
+	~ResultFile();
+
+	/** Open result file
+	  @param filename binary or XML result file
+	  @return false when file cannot be read or is not valid **/
+	bool Open(QString filename);
+
+	QString Error() const;	/// Reason why file could not be opened
+
+	ResultElement Root() const;	/// Root element, null when nothing is open
+
+	/** Write all elements to another format
+	  @param writer writer receiving elements, document is not started or ended **/
+	void Write(ResultWriter &writer) const;
+
+	static const char MAGIC[8];						/// File identification
+	static const quint32 VERSION = 1;				/// Current format version
+	static const quint32 BYTE_ORDER = 0x01020304;	/// Byte order mark
+
+	/// Column types
+	enum ColumnType { COLUMN_INTEGER, COLUMN_NUMBER, COLUMN_STRING };
+
+	static const qint64 NULL_INTEGER = -Q_INT64_C(0x7fffffffffffffff) - 1;		/// Missing integer
+	static const quint64 NULL_NUMBER = Q_UINT64_C(0x7ff8dead00000000);			/// Missing number, NaN bits
+	static const qint64 NULL_STRING = -1;										/// Missing string
+
+	/// File header
+	struct Header {
+		char magic[8];
+		quint32 version;
+		quint32 byte_order;
+		quint32 strings;	/// Count of strings
+		quint32 tables;		/// Count of tables
+		quint64 size;		/// Size of whole file
+	};
+
+	/// String table entry
+	struct StringEntry {
+		quint64 offset;
+		quint32 size;		/// Size in bytes
+		quint32 reserved;
+	};
+
+	/// Table entry
+	struct TableEntry {
+		quint32 name;		/// Element name string
+		qint32 parent;		/// Parent table, -1 for root element
+		quint32 rows;		/// Count of elements
+		quint32 columns;	/// Count of attributes
+		quint64 parents;	/// Offset of parent rows
+		quint64 order;		/// Offset of document order
+		quint64 column;		/// Offset of the first ColumnEntry
+	};
+
+	/// Column entry
+	struct ColumnEntry {
+		quint32 name;		/// Attribute name string
+		quint32 type;		/// ColumnType
+		quint64 cells;		/// Offset of cells
+	};
+
+private:
+	friend class ResultElement;
+	friend class ResultList;
+	friend class ResultColumn;
+
+	struct Column {
+		QString name;
+		quint32 type;
+		const qint64 *cells;
+	};
+
+	struct Table {
+		QString name;
+		int parent;
+		int rows;
+		const quint32 *parents;
+		const quint32 *order;
+		QVector<Column> columns;
+		QVector<int> children;	// child tables
+	};
+
+	bool Load();						// reads directories of binary data
+	bool ReadXml();						// converts XML file to binary data
+	bool Check(quint64 offset, quint64 size) const;	// whenever range lies in data
+	QString String(qint64 index) const;	// string from string table
+
+	int FindColumn(int table, const QString &name) const;
+	void Range(int row, int child, int &begin, int &end) const;	// rows of child table belonging to parent row
+
+	void WriteElement(ResultWriter &writer, int table, int row) const;
+
+	QFile file;
+	QByteArray buffer;		// converted data when file is not mapped
+	const uchar *data;
+	qint64 size;
+	QString error;
+
+	QVector<const StringEntry*> strings;
+	QVector<Table> tables;
+};
@@ -0,0 +1,221 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "resultstore.h"
+#include "resultfile.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+const char *ResultStore::INDEX = ".index.hddbin";
+
+QString ResultStore::Entry::Label() const {
+	return model + " " + serial + " " + firmware + ", " + kernel + ", " +
+			QDateTime::fromMSecsSinceEpoch(modified).toString("yyyy-MM-dd hh:mm") + ", " +
+			QFileInfo(file).fileName();
+}
+
+ResultStore::ResultStore(QString directory):
+	directory(directory.isEmpty()?DefaultDirectory():directory) {}
+
+QString ResultStore::DefaultDirectory() {
+	return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/results";
+}
+
+QString ResultStore::Directory() const {
+	return directory;
+}
+
+bool ResultStore::Open() {
+	if(!QDir().mkpath(directory)) {
+		return false;
+	}
+
+	ReadIndex();
+
+	// reuse entries of files that have not changed
+	QHash<QString, Entry> known;
+	for(int i = 0; i < entries.size(); ++i) {
+		known.insert(entries[i].file, entries[i]);
+	}
+
+	bool changed = false;
+	QList<Entry> current;
+	QFileInfoList files = QDir(directory).entryInfoList(QStringList() << "*.hddtest" << "*.hddbin", QDir::Files);
+	for(int i = 0; i < files.size(); ++i) {
+		QString path = files[i].absoluteFilePath();
+		Entry entry = known.value(path);
+		if((entry.file != path) || (entry.modified != files[i].lastModified().toMSecsSinceEpoch()) ||
+				(entry.bytes != files[i].size())) {
+			if(!ReadEntry(path, entry)) {
+				continue;
+			}
+			changed = true;
+		}
+		current.append(entry);
+	}
+	changed = changed || (current.size() != entries.size());
+
+	// rebuild lookup tables in time order
+	std::sort(current.begin(), current.end(), [](const Entry &a, const Entry &b) {
+		return a.modified < b.modified;
+	});
+	entries.clear();
+	models.clear();
+	for(int i = 0; i < current.size(); ++i) {
+		Insert(current[i]);
+	}
+
+	return !changed || WriteIndex();
+}
+
+QString ResultStore::Add(QString filename) {
+	Entry entry;
+	if(!ReadEntry(filename, entry)) {
+		return QString();
+	}
+
+	// keep original name unless it is used
+	QFileInfo info(filename);
+	QString target = directory + "/" + info.fileName();
+	for(int i = 1; QFile::exists(target); ++i) {
+		target = directory + "/" + info.completeBaseName() + "-" + QString::number(i) + "." + info.suffix();
+	}
+	if(!QFile::copy(filename, target)) {
+		return QString();
+	}
+
+	// copy has its own time and path
+	ReadEntry(target, entry);
+	Insert(entry);
+	WriteIndex();
+
+	return target;
+}
+
+QList<ResultStore::Entry> ResultStore::Find(QString model, QString serial, QString firmware, QString kernel) const {
+	// model is indexed, other keys filter its results
+	QList<int> candidates;
+	if(model.isEmpty()) {
+		for(int i = 0; i < entries.size(); ++i) {
+			candidates.append(i);
+		}
+	} else {
+		candidates = models.values(model);
+		std::sort(candidates.begin(), candidates.end());
+	}
+
+	QList<Entry> found;
+	for(int i = 0; i < candidates.size(); ++i) {
+		const Entry &entry = entries[candidates[i]];
+		if((serial.isEmpty() || (entry.serial == serial)) &&
+				(firmware.isEmpty() || (entry.firmware == firmware)) &&
+				(kernel.isEmpty() || (entry.kernel == kernel))) {
+			found.append(entry);
+		}
+	}
+
+	return found;
+}
+
+bool ResultStore::ReadEntry(QString path, Entry &entry) {
+	ResultFile results;
+	if(!results.Open(path)) {
+		return false;
+	}
+
+	QFileInfo info(path);
+	ResultElement root = results.Root();
+	ResultElement dev = root.Child("Info").Child("Device");
+	entry.file = info.absoluteFilePath();
+	entry.modified = info.lastModified().toMSecsSinceEpoch();
+	entry.bytes = info.size();
+	entry.model = dev.Attribute("model");
+	entry.serial = dev.Attribute("serial");
+	entry.firmware = dev.Attribute("firmware");
+	entry.size = dev.Integer("size");
+	entry.kernel = root.Child("Info").Child("Kernel").Attribute("kernel");
+	entry.fstype = root.Child("Info").Child("FS").Attribute("fstype");
+
+	return true;
+}
+
+void ResultStore::ReadIndex() {
+	entries.clear();
+	models.clear();
+
+	ResultFile index;
+	if(!index.Open(directory + "/" + INDEX)) {
+		return;
+	}
+
+	ResultList list = index.Root().Children("Entry");
+	for(int i = 0; i < list.Size(); ++i) {
+		ResultElement element = list.At(i);
+		Entry entry;
+		entry.file = directory + "/" + element.Attribute("file");
+		entry.modified = element.Integer("modified");
+		entry.bytes = element.Integer("bytes");
+		entry.model = element.Attribute("model");
+		entry.serial = element.Attribute("serial");
+		entry.firmware = element.Attribute("firmware");
+		entry.kernel = element.Attribute("kernel");
+		entry.fstype = element.Attribute("fstype");
+		entry.size = element.Integer("size");
+		Insert(entry);
+	}
+}
+
+bool ResultStore::WriteIndex() {
+	QFile file(directory + "/" + INDEX);
+	if(!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+
+	BinaryResultWriter writer(&file);
+	writer.StartDocument();
+	writer.StartElement("Store");
+	for(int i = 0; i < entries.size(); ++i) {
+		writer.StartElement("Entry");
+		writer.Attribute("file", QFileInfo(entries[i].file).fileName());
+		writer.Attribute("modified", entries[i].modified);
+		writer.Attribute("bytes", entries[i].bytes);
+		writer.Attribute("model", entries[i].model);
+		writer.Attribute("serial", entries[i].serial);
+		writer.Attribute("firmware", entries[i].firmware);
+		writer.Attribute("kernel", entries[i].kernel);
+		writer.Attribute("fstype", entries[i].fstype);
+		writer.Attribute("size", entries[i].size);
+		writer.EndElement();
+	}
+	writer.EndDocument();
+	file.close();
+
+	return file.error() == QFileDevice::NoError;
+}
+
+void ResultStore::Insert(const Entry &entry) {
+	models.insert(entry.model, entries.size());
+	entries.append(entry);
+}
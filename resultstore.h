@@ -0,0 +1,92 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QMultiHash>
+
+#include "definitions.h"
+
+using namespace HDDTest;
+
+/// Local store of many result files
+/** ResultStore keeps result files of a fleet of drives in one directory
+together with index of drive information of every file. Index is stored
+as binary result file in the same directory and it is updated only for
+files that were added, changed or removed since last time, so thousands of
+results can be searched without opening them. Results are looked up by
+drive model and filtered by serial number, firmware and kernel. **/
+class ResultStore {
+public:
+	/// Indexed result file
+	struct Entry {
+		QString file;		/// Full path to result file
+		qint64 modified;	/// File modification time in ms since epoch
+		qint64 bytes;		/// File size
+		QString model;		/// Drive model
+		QString serial;		/// Drive serial number
+		QString firmware;	/// Drive firmware
+		QString kernel;		/// Kernel the results were measured on
+		QString fstype;		/// Filesystem type, empty for raw device
+		hddsize size;		/// Drive size
+
+		QString Label() const;	/// Short human readable description
+	};
+
+	/** Creates store in directory
+	  @param directory store directory, default one when empty **/
+	ResultStore(QString directory = QString());
+
+	static QString DefaultDirectory();	/// Directory of store in user data
+
+	QString Directory() const;	/// Store directory
+
+	/** Reads index and updates it with files in directory
+	  @return false when directory cannot be created **/
+	bool Open();
+
+	/** Copies result file to store
+	  @param filename result file
+	  @return path of file in store, empty when it could not be added **/
+	QString Add(QString filename);
+
+	/** Finds results, empty arguments match everything
+	  @param model drive model
+	  @param serial drive serial number
+	  @param firmware drive firmware
+	  @param kernel kernel version
+	  @return matching results ordered by modification time **/
+	QList<Entry> Find(QString model = QString(), QString serial = QString(),
+			QString firmware = QString(), QString kernel = QString()) const;
+
+private:
+	static const char *INDEX;	/// Index file name, hidden from directory listing
+
+	bool ReadEntry(QString path, Entry &entry);	// read drive information from result file
+	void ReadIndex();
+	bool WriteIndex();
+	void Insert(const Entry &entry);			// add entry to lookup tables
+
+	QString directory;
+	QList<Entry> entries;
+	QMultiHash<QString, int> models;	// model to entries index
+};
@@ -0,0 +1,464 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "resultwriter.h"
+#include "resultfile.h"
+
+#include <string.h>
+
+#include <QLocale>
+#include <QtNumeric>
+
+ResultWriter::ResultWriter(QIODevice *device):
+	device(device) {}
+
+ResultWriter::~ResultWriter() {}
+
+ResultWriter* ResultWriter::Create(QIODevice *device, QString filename) {
+	QString suffix = QFileInfo(filename).suffix().toLower();
+	if(suffix == "jsonl") {
+		return new JsonResultWriter(device);
+	}
+	if(suffix == "csv") {
+		return new CsvResultWriter(device);
+	}
+	if(suffix == "hddbin") {
+		return new BinaryResultWriter(device);
+	}
+
+	return new XmlResultWriter(device);
+}
+
+QString ResultWriter::Filter() {
+	return "Results (*.hddtest);;Binary results (*.hddbin);;JSON Lines (*.jsonl);;CSV (*.csv)";
+}
+
+void ResultWriter::StartDocument() {}
+
+void ResultWriter::EndDocument() {
+	while(!path.isEmpty()) {
+		EndElement();
+	}
+}
+
+void ResultWriter::StartElement(const QString &name) {
+	path.append(name);
+	WriteStart(name);
+}
+
+void ResultWriter::EndElement() {
+	WriteEnd();
+	path.removeLast();
+}
+
+void ResultWriter::Attribute(const QString &name, const QString &value) {
+	WriteAttribute(name, value, TEXT);
+}
+
+void ResultWriter::Attribute(const QString &name, int value) {
+	WriteAttribute(name, QString::number(value), INTEGER);
+}
+
+void ResultWriter::Attribute(const QString &name, uint value) {
+	WriteAttribute(name, QString::number(value), INTEGER);
+}
+
+void ResultWriter::Attribute(const QString &name, qlonglong value) {
+	WriteAttribute(name, QString::number(value), INTEGER);
+}
+
+void ResultWriter::Attribute(const QString &name, qulonglong value) {
+	WriteAttribute(name, QString::number(value), INTEGER);
+}
+
+void ResultWriter::Attribute(const QString &name, float value) {
+	Attribute(name, (double)value);
+}
+
+void ResultWriter::Attribute(const QString &name, double value) {
+	// shortest text that is read back as the same value
+	WriteAttribute(name, QString::number(value, 'g', QLocale::FloatingPointShortest), qIsFinite(value)?NUMBER:TEXT);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// XML ///////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+XmlResultWriter::XmlResultWriter(QIODevice *device):
+	ResultWriter(device), stream(device) {
+	stream.setAutoFormatting(true);
+	stream.setAutoFormattingIndent(1);
+}
+
+void XmlResultWriter::StartDocument() {
+	stream.writeStartDocument();
+	stream.writeDTD("<!DOCTYPE HddTest>");
+}
+
+void XmlResultWriter::EndDocument() {
+	ResultWriter::EndDocument();
+	stream.writeEndDocument();
+}
+
+void XmlResultWriter::WriteStart(const QString &name) {
+	stream.writeStartElement(name);
+}
+
+void XmlResultWriter::WriteEnd() {
+	stream.writeEndElement();
+}
+
+void XmlResultWriter::WriteAttribute(const QString &name, const QString &value, Type) {
+	stream.writeAttribute(name, value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// JSON Lines ////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+JsonResultWriter::JsonResultWriter(QIODevice *device):
+	ResultWriter(device), attributes(false) {}
+
+void JsonResultWriter::WriteStart(const QString &name) {
+	Q_UNUSED(name);
+
+	// parent attributes are complete once child starts
+	Flush();
+	line = "{\"element\":" + Quote(path.join("/"));
+	attributes = false;
+}
+
+void JsonResultWriter::WriteEnd() {
+	Flush();
+}
+
+void JsonResultWriter::WriteAttribute(const QString &name, const QString &value, Type type) {
+	line += "," + Quote(name) + ":" + ((type == TEXT)?Quote(value):value);
+	attributes = true;
+}
+
+void JsonResultWriter::Flush() {
+	// elements without attributes carry no data
+	if(attributes) {
+		line += "}\n";
+		device->write(line.toUtf8());
+	}
+	line.clear();
+	attributes = false;
+}
+
+QString JsonResultWriter::Quote(const QString &text) {
+	QString quoted = "\"";
+	for(int i = 0; i < text.size(); ++i) {
+		QChar c = text[i];
+		if(c == '"' || c == '\\') {
+			quoted += '\\';
+			quoted += c;
+		} else if(c == '\n') {
+			quoted += "\\n";
+		} else if(c == '\t') {
+			quoted += "\\t";
+		} else if(c.unicode() < 0x20) {
+			quoted += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+		} else {
+			quoted += c;
+		}
+	}
+	quoted += '"';
+
+	return quoted;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// CSV ///////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+CsvResultWriter::CsvResultWriter(QIODevice *device):
+	ResultWriter(device), record(0) {}
+
+void CsvResultWriter::StartDocument() {
+	device->write("record,element,attribute,value\n");
+}
+
+void CsvResultWriter::WriteStart(const QString &name) {
+	Q_UNUSED(name);
+	++record;
+}
+
+void CsvResultWriter::WriteEnd() {}
+
+void CsvResultWriter::WriteAttribute(const QString &name, const QString &value, Type) {
+	QString row = QString::number(record) + "," + Quote(path.join("/")) + "," + Quote(name) + "," + Quote(value) + "\n";
+	device->write(row.toUtf8());
+}
+
+QString CsvResultWriter::Quote(const QString &text) {
+	if(!text.contains(',') && !text.contains('"') && !text.contains('\n')) {
+		return text;
+	}
+
+	return "\"" + QString(text).replace("\"", "\"\"") + "\"";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/////// Binary ////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+BinaryResultWriter::BinaryResultWriter(QIODevice *device):
+	ResultWriter(device), order(0) {}
+
+void BinaryResultWriter::WriteStart(const QString &name) {
+	int parent = open.isEmpty()?-1:open.last().first;
+	quint32 parent_row = open.isEmpty()?0:open.last().second;
+
+	// elements of the same name and parent share one table
+	QPair<qint32, quint32> key(parent, String(name));
+	int index = table_index.value(key, -1);
+	if(index < 0) {
+		index = tables.size();
+		table_index.insert(key, index);
+
+		Table table;
+		table.name = key.second;
+		table.parent = parent;
+		tables.append(table);
+	}
+
+	Table &table = tables[index];
+	open.append(qMakePair(index, (int)table.parents.size()));
+	table.parents.append(parent_row);
+	table.order.append(order++);
+}
+
+void BinaryResultWriter::WriteEnd() {
+	open.removeLast();
+}
+
+void BinaryResultWriter::WriteAttribute(const QString &name, const QString &value, Type type) {
+	Table &table = tables[open.last().first];
+	int row = open.last().second;
+
+	// locate column, the first value selects its type
+	quint32 id = String(name);
+	int index = 0;
+	while((index < table.columns.size()) && (table.columns[index].name != id)) {
+		++index;
+	}
+	if(index == table.columns.size()) {
+		Column column;
+		column.name = id;
+		column.type = (type == INTEGER)?ResultFile::COLUMN_INTEGER:
+				(type == NUMBER)?ResultFile::COLUMN_NUMBER:ResultFile::COLUMN_STRING;
+		table.columns.append(column);
+	}
+	Column &column = table.columns[index];
+
+	// widen column when value does not fit
+	qint64 integer = (type == INTEGER)?value.toLongLong():0;
+	if(type == TEXT) {
+		Convert(column, ResultFile::COLUMN_STRING);
+	} else if((type == NUMBER) && (column.type == ResultFile::COLUMN_INTEGER)) {
+		Convert(column, ResultFile::COLUMN_NUMBER);
+	} else if((type == INTEGER) && (column.type == ResultFile::COLUMN_NUMBER) && ((qint64)(double)integer != integer)) {
+		Convert(column, ResultFile::COLUMN_STRING);
+	}
+
+	qint64 cell;
+	if(column.type == ResultFile::COLUMN_INTEGER) {
+		cell = integer;
+	} else if(column.type == ResultFile::COLUMN_NUMBER) {
+		double number = value.toDouble();
+		memcpy(&cell, &number, sizeof(cell));
+	} else {
+		cell = String(value);
+	}
+
+	// elements without this attribute have missing value
+	while(column.cells.size() < row) {
+		column.cells.append(Null(column.type));
+	}
+	if(column.cells.size() == row) {
+		column.cells.append(cell);
+	} else {
+		column.cells[row] = cell;
+	}
+}
+
+void BinaryResultWriter::EndDocument() {
+	ResultWriter::EndDocument();
+
+	// complete columns and count directory size
+	quint64 columns = 0;
+	for(int i = 0; i < tables.size(); ++i) {
+		int rows = tables[i].parents.size();
+		for(int j = 0; j < tables[i].columns.size(); ++j) {
+			Column &column = tables[i].columns[j];
+			while(column.cells.size() < rows) {
+				column.cells.append(Null(column.type));
+			}
+		}
+		columns += tables[i].columns.size();
+	}
+
+	QVector<QByteArray> utf8(strings.size());
+	for(int i = 0; i < strings.size(); ++i) {
+		utf8[i] = strings[i].toUtf8();
+	}
+
+	// lay out data behind directories
+	quint64 offset = sizeof(ResultFile::Header) +
+			strings.size() * sizeof(ResultFile::StringEntry) +
+			tables.size() * sizeof(ResultFile::TableEntry) +
+			columns * sizeof(ResultFile::ColumnEntry);
+
+	QVector<ResultFile::TableEntry> table_entries(tables.size());
+	QVector<ResultFile::ColumnEntry> column_entries;
+	quint64 column_offset = sizeof(ResultFile::Header) +
+			strings.size() * sizeof(ResultFile::StringEntry) +
+			tables.size() * sizeof(ResultFile::TableEntry);
+	for(int i = 0; i < tables.size(); ++i) {
+		ResultFile::TableEntry &entry = table_entries[i];
+		quint64 rows = tables[i].parents.size();
+		entry.name = tables[i].name;
+		entry.parent = tables[i].parent;
+		entry.rows = rows;
+		entry.columns = tables[i].columns.size();
+		entry.column = column_offset;
+		column_offset += entry.columns * sizeof(ResultFile::ColumnEntry);
+
+		entry.parents = offset;
+		offset += Padded(rows * sizeof(quint32));
+		entry.order = offset;
+		offset += Padded(rows * sizeof(quint32));
+
+		for(int j = 0; j < tables[i].columns.size(); ++j) {
+			ResultFile::ColumnEntry column;
+			column.name = tables[i].columns[j].name;
+			column.type = tables[i].columns[j].type;
+			column.cells = offset;
+			column_entries.append(column);
+			offset += rows * sizeof(qint64);
+		}
+	}
+
+	QVector<ResultFile::StringEntry> string_entries(strings.size());
+	for(int i = 0; i < strings.size(); ++i) {
+		string_entries[i].offset = offset;
+		string_entries[i].size = utf8[i].size();
+		string_entries[i].reserved = 0;
+		offset += Padded(utf8[i].size());
+	}
+
+	ResultFile::Header header;
+	memcpy(header.magic, ResultFile::MAGIC, sizeof(header.magic));
+	header.version = ResultFile::VERSION;
+	header.byte_order = ResultFile::BYTE_ORDER;
+	header.strings = strings.size();
+	header.tables = tables.size();
+	header.size = offset;
+
+	// write file in the same order
+	Output(&header, sizeof(header));
+	Output(string_entries.constData(), string_entries.size() * sizeof(ResultFile::StringEntry));
+	Output(table_entries.constData(), table_entries.size() * sizeof(ResultFile::TableEntry));
+	Output(column_entries.constData(), column_entries.size() * sizeof(ResultFile::ColumnEntry));
+	for(int i = 0; i < tables.size(); ++i) {
+		Output(tables[i].parents.constData(), tables[i].parents.size() * sizeof(quint32));
+		Output(tables[i].order.constData(), tables[i].order.size() * sizeof(quint32));
+		for(int j = 0; j < tables[i].columns.size(); ++j) {
+			Output(tables[i].columns[j].cells.constData(), tables[i].columns[j].cells.size() * sizeof(qint64));
+		}
+	}
+	for(int i = 0; i < utf8.size(); ++i) {
+		Output(utf8[i].constData(), utf8[i].size());
+	}
+}
+
+quint32 BinaryResultWriter::String(const QString &text) {
+	QHash<QString, quint32>::const_iterator it = string_index.constFind(text);
+	if(it != string_index.constEnd()) {
+		return it.value();
+	}
+
+	quint32 index = strings.size();
+	strings.append(text);
+	string_index.insert(text, index);
+
+	return index;
+}
+
+void BinaryResultWriter::Convert(Column &column, quint32 type) {
+	if(column.type == type) {
+		return;
+	}
+
+	// integers that double cannot hold exactly are kept as text
+	if((column.type == ResultFile::COLUMN_INTEGER) && (type == ResultFile::COLUMN_NUMBER)) {
+		for(int i = 0; i < column.cells.size(); ++i) {
+			qint64 cell = column.cells[i];
+			if((cell != ResultFile::NULL_INTEGER) && ((qint64)(double)cell != cell)) {
+				type = ResultFile::COLUMN_STRING;
+				break;
+			}
+		}
+	}
+
+	for(int i = 0; i < column.cells.size(); ++i) {
+		qint64 &cell = column.cells[i];
+		if(cell == Null(column.type)) {
+			cell = Null(type);
+			continue;
+		}
+
+		double number;
+		memcpy(&number, &cell, sizeof(number));
+		if(type == ResultFile::COLUMN_NUMBER) {
+			number = cell;
+			memcpy(&cell, &number, sizeof(cell));
+		} else if(column.type == ResultFile::COLUMN_INTEGER) {
+			cell = String(QString::number(cell));
+		} else {
+			cell = String(QString::number(number, 'g', QLocale::FloatingPointShortest));
+		}
+	}
+	column.type = type;
+}
+
+void BinaryResultWriter::Output(const void *data, quint64 size) {
+	static const char zeros[sizeof(qint64)] = {0};
+
+	device->write((const char*)data, size);
+	device->write(zeros, Padded(size) - size);
+}
+
+qint64 BinaryResultWriter::Null(quint32 type) {
+	switch(type) {
+	case ResultFile::COLUMN_INTEGER:
+		return ResultFile::NULL_INTEGER;
+	case ResultFile::COLUMN_NUMBER:
+		return (qint64)ResultFile::NULL_NUMBER;
+	default:
+		return ResultFile::NULL_STRING;
+	}
+}
+
+quint64 BinaryResultWriter::Padded(quint64 size) {
+	return (size + sizeof(qint64) - 1) & ~(quint64)(sizeof(qint64) - 1);
+}
@@ -0,0 +1,199 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QIODevice>
+#include <QString>
+#include <QStringList>
+#include <QXmlStreamWriter>
+
+#include "definitions.h"
+
+using namespace HDDTest;
+
+/// Streams benchmark results to file
+/** ResultWriter replaces QDomDocument when results are saved. Benchmarks
+describe their results as tree of elements with attributes and every element
+is written out as soon as it is described, so memory used while saving does
+not depend on count of samples. Attributes of element have to be written
+before its first child element. Create selects output format by file suffix:
+XML result file (.hddtest), binary result file (.hddbin), JSON Lines (.jsonl)
+with one object per element or CSV (.csv) with one row per attribute. Only
+result files can be opened again, the other formats are meant for external
+tools. **/
+class ResultWriter {
+public:
+	virtual ~ResultWriter();
+
+	/** Creates writer for file
+	  @param device opened file results are written to
+	  @param filename file name, its suffix selects the format
+	  @return new writer, XML one when suffix is not known **/
+	static ResultWriter* Create(QIODevice *device, QString filename);
+
+	static QString Filter();	/// File dialog filter of all supported formats
+
+	/// Kind of attribute value
+	enum Type { TEXT, INTEGER, NUMBER };
+
+	virtual void StartDocument();	/// Writes document header
+	virtual void EndDocument();		/// Closes all open elements and flushes output
+
+	/** Starts new element nested in currently open one
+	  @param name element name **/
+	void StartElement(const QString &name);
+
+	void EndElement();	/// Ends currently open element
+
+	// Attributes of currently open element, same set of types as QDomElement::setAttribute
+	void Attribute(const QString &name, const QString &value);
+	void Attribute(const QString &name, int value);
+	void Attribute(const QString &name, uint value);
+	void Attribute(const QString &name, qlonglong value);
+	void Attribute(const QString &name, qulonglong value);
+	void Attribute(const QString &name, float value);
+	void Attribute(const QString &name, double value);
+
+protected:
+	ResultWriter(QIODevice *device);
+
+	virtual void WriteStart(const QString &name) = 0;	/// Element started, path already contains it
+	virtual void WriteEnd() = 0;						/// Element ended, path still contains it
+
+	/** Attribute of currently open element
+	  @param name attribute name
+	  @param value attribute value as text, numbers are read back exactly
+	  @param type kind of value **/
+	virtual void WriteAttribute(const QString &name, const QString &value, Type type) = 0;
+
+	QIODevice *device;	/// Output file
+	QStringList path;	/// Names of open elements
+};
+
+/// Writes XML result file readable by RestoreResults
+class XmlResultWriter : public ResultWriter {
+public:
+	XmlResultWriter(QIODevice *device);
+
+	void StartDocument();
+	void EndDocument();
+
+protected:
+	void WriteStart(const QString &name);
+	void WriteEnd();
+	void WriteAttribute(const QString &name, const QString &value, Type type);
+
+private:
+	QXmlStreamWriter stream;
+};
+
+/// Writes one JSON object per line for every element having attributes
+/** Object contains "element" member with slash separated path of element
+followed by element attributes. Attributes are collected until the first
+child element starts or the element ends. **/
+class JsonResultWriter : public ResultWriter {
+public:
+	JsonResultWriter(QIODevice *device);
+
+protected:
+	void WriteStart(const QString &name);
+	void WriteEnd();
+	void WriteAttribute(const QString &name, const QString &value, Type type);
+
+private:
+	void Flush();	// writes collected attributes of open element
+
+	static QString Quote(const QString &text);	// JSON string literal
+
+	QString line;		// object of open element being collected
+	bool attributes;	// whenever open element has some attributes
+};
+
+/// Writes CSV table with one row per attribute
+/** Columns are record, element, attribute and value. Record is sequence
+number of element in file so attributes of the same element can be joined
+back into one row. **/
+class CsvResultWriter : public ResultWriter {
+public:
+	CsvResultWriter(QIODevice *device);
+
+	void StartDocument();
+
+protected:
+	void WriteStart(const QString &name);
+	void WriteEnd();
+	void WriteAttribute(const QString &name, const QString &value, Type type);
+
+private:
+	static QString Quote(const QString &text);	// CSV field
+
+	hddsize record;	// sequence number of open element
+};
+
+/// Writes binary result file
+/** Format is described in ResultFile. Values of one attribute are stored
+together, so they are collected in memory as 8 byte cells and the file is
+written when document ends. Column of attribute is widened to double or text
+when its values do not fit the type of the first value. **/
+class BinaryResultWriter : public ResultWriter {
+public:
+	BinaryResultWriter(QIODevice *device);
+
+	void EndDocument();
+
+protected:
+	void WriteStart(const QString &name);
+	void WriteEnd();
+	void WriteAttribute(const QString &name, const QString &value, Type type);
+
+private:
+	struct Column {
+		quint32 name;
+		quint32 type;
+		QVector<qint64> cells;
+	};
+
+	struct Table {
+		quint32 name;
+		qint32 parent;
+		QVector<quint32> parents;
+		QVector<quint32> order;
+		QVector<Column> columns;
+	};
+
+	quint32 String(const QString &text);		// index of string in string table
+	void Convert(Column &column, quint32 type);	// change column type keeping values
+	void Output(const void *data, quint64 size);	// write data padded to 8 bytes
+
+	static qint64 Null(quint32 type);				// missing value of column type
+	static quint64 Padded(quint64 size);			// size aligned to 8 bytes
+
+	QVector<Table> tables;
+	QHash<QPair<qint32, quint32>, int> table_index;	// parent table and name to table
+	QStringList strings;
+	QHash<QString, quint32> string_index;
+	QVector<QPair<int, int> > open;	// table and row of open elements
+	quint32 order;					// document order of next element
+};
@@ -0,0 +1,97 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include <QVector>
+
+/// Bounded lock-free single producer single consumer queue
+/** Ring hands samples from benchmark thread to GUI thread. Storage is
+allocated by the constructor so Push never allocates or blocks, when
+the ring is full the sample is dropped and counted instead. Only one
+thread may call Push and only one thread may call Pop at a time.
+Capacity is rounded up to power of two. **/
+template<typename T>
+class Ring {
+public:
+	/** The constructor
+	  @param capacity minimal count of items ring can hold **/
+	explicit Ring(int capacity):
+			head(0), tail(0), dropped(0) {
+		int size = 1;
+		while(size < capacity) {
+			size <<= 1;
+		}
+		items.resize(size);
+		data = items.data();
+		mask = size - 1;
+	}
+
+	/** Adds item to the ring, called by producer
+	  @param item item to be added
+	  @return false when ring is full and item was dropped **/
+	bool Push(const T &item) {
+		unsigned int t = tail.load(std::memory_order_relaxed);
+		if(t - head.load(std::memory_order_acquire) > mask) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		data[t & mask] = item;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** Removes oldest item from the ring, called by consumer
+	  @param item receives removed item
+	  @return false when ring is empty **/
+	bool Pop(T &item) {
+		unsigned int h = head.load(std::memory_order_relaxed);
+		if(h == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = data[h & mask];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Discards all items not popped yet, called by consumer
+	void Clear() {
+		head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+		dropped.store(0, std::memory_order_relaxed);
+	}
+
+	/// Returns count of items dropped because the ring was full
+	int Dropped() const {
+		return dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	Ring(const Ring&);
+	Ring& operator=(const Ring&);
+
+	QVector<T> items;
+	T *data;		// items storage, never reallocated after construction
+	unsigned int mask;
+	alignas(64) std::atomic<unsigned int> head;	// next item to pop, written by consumer
+	alignas(64) std::atomic<unsigned int> tail;	// next free slot, written by producer
+	std::atomic<int> dropped;
+};
@@ -0,0 +1,183 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "sampler.h"
+#include "resultfile.h"
+#include "resultwriter.h"
+#include "timer.h"
+
+#include <time.h>
+
+#include <QDateTime>
+
+Counters::Counters() {
+	erase();
+}
+
+void Counters::Add(hddtime latency, hddsize bytes) {
+	ops.fetch_add(1, std::memory_order_relaxed);
+	this->bytes.fetch_add(bytes, std::memory_order_relaxed);
+	busy.fetch_add(latency, std::memory_order_relaxed);
+
+	qint64 current = max.load(std::memory_order_relaxed);
+	while((latency > current) && !max.compare_exchange_weak(current, latency, std::memory_order_relaxed)) {}
+}
+
+void Counters::erase() {
+	ops = 0;
+	bytes = 0;
+	busy = 0;
+	max = 0;
+}
+
+qreal Sample::Speed(hddtime interval) const {
+	return (interval > 0)?(qreal)bytes * us / interval:0;
+}
+
+Sampler::Sampler(Counters *counters):
+	start(0), counters(counters), stopping(false) {}
+
+void Sampler::Start(QString device) {
+	erase();
+	counters->erase();
+	if(!device.isEmpty()) {
+		blockStats.Start(device);
+	}
+	stopping = false;
+	start = QDateTime::currentMSecsSinceEpoch();
+	QThread::start();
+}
+
+void Sampler::Stop() {
+	stopping = true;
+	wait();
+	blockStats.Stop();
+}
+
+void Sampler::run() {
+	Timer timer;
+	timer.MarkStart();
+
+	timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	for(hddtime tick = SAMPLE_INTERVAL; !stopping; tick += SAMPLE_INTERVAL) {
+		// sleep until next grid point
+		next.tv_nsec += SAMPLE_INTERVAL % s;
+		next.tv_sec += SAMPLE_INTERVAL / s + next.tv_nsec / s;
+		next.tv_nsec %= s;
+		while((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0) && !stopping) {}
+
+		if(!stopping) {
+			Take(tick);
+		}
+	}
+
+	// the last interval is shorter
+	Take(timer.GetCurrentOffset());
+}
+
+void Sampler::Take(hddtime time) {
+	Sample sample;
+	sample.time = time;
+	sample.ops = counters->ops.exchange(0, std::memory_order_relaxed);
+	sample.bytes = counters->bytes.exchange(0, std::memory_order_relaxed);
+	hddtime busy = counters->busy.exchange(0, std::memory_order_relaxed);
+	sample.max = counters->max.exchange(0, std::memory_order_relaxed);
+	sample.latency = (sample.ops > 0)?busy / sample.ops:0;
+
+	samples.append(sample);
+	blockStats.Sample();
+}
+
+int Sampler::SteadyState(int window, qreal tolerance) const {
+	for(int i = 0; i + window <= samples.size(); ++i) {
+		qreal mean = 0;
+		for(int j = i; j < i + window; ++j) {
+			mean += samples[j].bytes;
+		}
+		mean /= window;
+
+		bool steady = mean > 0;
+		for(int j = i; steady && (j < i + window); ++j) {
+			steady = qAbs(samples[j].bytes - mean) <= tolerance * mean;
+		}
+		if(steady) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void Sampler::Write(ResultWriter &writer) const {
+	writer.StartElement("Samples");
+	writer.Attribute("start", start);
+	writer.Attribute("interval", SAMPLE_INTERVAL);
+	int steady = SteadyState();
+	if(steady >= 0) {
+		writer.Attribute("steady", (steady > 0)?samples[steady - 1].time:0);
+	}
+
+	for(int i = 0; i < samples.size(); ++i) {
+		writer.StartElement("Sample");
+		writer.Attribute("time", samples[i].time);
+		writer.Attribute("ops", samples[i].ops);
+		writer.Attribute("bytes", samples[i].bytes);
+		writer.Attribute("latency", samples[i].latency);
+		writer.Attribute("max", samples[i].max);
+		writer.EndElement();
+	}
+
+	writer.EndElement();
+
+	blockStats.Write(writer);
+}
+
+void Sampler::Read(const ResultElement &root) {
+	erase();
+	blockStats.Read(root);
+
+	ResultElement master = root.Child("Samples");
+	if(master.IsNull()) {
+		return;
+	}
+	start = master.Integer("start");
+
+	ResultList list = master.Children("Sample");
+	ResultColumn time = list.Column("time");
+	ResultColumn ops = list.Column("ops");
+	ResultColumn bytes = list.Column("bytes");
+	ResultColumn latency = list.Column("latency");
+	ResultColumn max = list.Column("max");
+	samples.resize(list.Size());
+	for(int i = 0; i < list.Size(); ++i) {
+		samples[i].time = time.Integer(i);
+		samples[i].ops = ops.Integer(i);
+		samples[i].bytes = bytes.Integer(i);
+		samples[i].latency = latency.Integer(i);
+		samples[i].max = max.Integer(i);
+	}
+}
+
+void Sampler::erase() {
+	samples.clear();
+	start = 0;
+	blockStats.erase();
+}
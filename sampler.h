@@ -0,0 +1,109 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include <QThread>
+#include <QVector>
+
+#include "blockstats.h"
+#include "definitions.h"
+
+class ResultWriter;
+class ResultElement;
+
+using namespace HDDTest;
+
+/// Operation counters shared by measuring threads and sampler
+/** Counters are updated by Timer of every device, device clone or file
+the benchmark measures with. All of them are atomic, so any count of
+measuring threads can add operations while sampler takes them. **/
+class Counters {
+public:
+	Counters();
+
+	/** Records finished operation
+	  @param latency operation time
+	  @param bytes bytes transferred by operation **/
+	void Add(hddtime latency, hddsize bytes);
+
+	std::atomic<qint64> ops;		/// Operations since last sample
+	std::atomic<qint64> bytes;		/// Bytes since last sample
+	std::atomic<qint64> busy;		/// Sum of operation times since last sample
+	std::atomic<qint64> max;		/// The longest operation since last sample
+
+	void erase();	/// Zero all counters
+};
+
+/// One point of throughput time series
+struct Sample {
+	hddtime time;		/// End of sampled interval from benchmark start
+	qint64 ops;			/// Operations finished in interval
+	hddsize bytes;		/// Bytes transferred in interval
+	hddtime latency;	/// Mean operation time in interval
+	hddtime max;		/// The longest operation in interval
+
+	qreal Speed(hddtime interval) const;	/// Throughput in MB/s over interval
+};
+
+/// Samples operation counters on fixed time grid
+/** Sampler thread wakes up at fixed interval from benchmark start and
+moves counters to new sample, so throughput over time is recorded the same
+way for every benchmark regardless of its block size or count of threads.
+Wake ups use absolute time, so sampling does not drift. Kernel block layer
+counters of the device are collected along with samples. Samples can be
+read only when sampler is stopped. **/
+class Sampler : public QThread {
+public:
+	static const hddtime SAMPLE_INTERVAL = 100 * ms;	/// Sampling grid
+
+	Sampler(Counters *counters);
+
+	/** Erases counters and samples and starts sampling
+	  @param device block device node to collect kernel counters of **/
+	void Start(QString device = QString());
+	void Stop();	/// Takes the last sample and waits for thread to finish
+
+	QVector<Sample> samples;	/// Recorded samples
+	qint64 start;				/// Wall clock time of benchmark start in ms since epoch
+	BlockStats blockStats;		/// Kernel block layer counters over benchmark
+
+	/** Finds begin of steady state, the first window in which throughput
+	  of every sample is within tolerance of window mean
+	  @param window count of samples in window
+	  @param tolerance allowed relative difference from mean
+	  @return index of first sample of steady state or -1 **/
+	int SteadyState(int window = 50, qreal tolerance = 0.1) const;
+
+	void Write(ResultWriter &writer) const;		/// Writes samples and block stats elements
+	void Read(const ResultElement &root);		/// Reads samples and block stats elements of benchmark element
+	void erase();	/// Erase samples
+
+protected:
+	void run();
+
+private:
+	void Take(hddtime time);	// move counters to new sample
+
+	Counters *counters;
+	std::atomic<bool> stopping;
+};
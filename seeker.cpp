@@ -20,16 +20,8 @@
 
 #include "seeker.h"
 
-Seeker::Seeker(QWidget *parent) :
-	TestWidget(parent) {
-	dataAvgLine = addLine("ms", "Avg", QColor(255, 0, 0));
-	referenceAvgLine = addLine("ms", "Avg", QColor(0, 0, 255));
-
-	dataTicks = addTicks(QColor(255, 0, 0));
-	referenceTicks = addTicks(QColor(0, 0, 255));
-
-	net = addNet("ms", "Seek length", "Seek time");
-
+Seeker::Seeker(QObject *parent) :
+	Benchmark(parent) {
 	testName = "Seek";
 	testDescription = "Seek test performs " + QString::number(SEEKER_SEEKCOUNT) +
 			" seeks to random positions on device." +
@@ -39,19 +31,26 @@ Seeker::Seeker(QWidget *parent) :
 Seeker::~Seeker() {}
 
 void Seeker::TestLoop() {
-	// erease previous results
-	result.erase();
-
 	// initialize random number generator
-	RandomGenerator gen;
+	RandomGenerator gen(seed);
+	RandomOffset offsets = GetOffsets(SEEKER_BLOCKSIZE);
+	if(offsets.Count() == 0) {
+		return;
+	}
+
+	// allocate read buffer before timed seeks
+	device->PrepareBuffer(SEEKER_BLOCKSIZE);
 
 	// seek to drive end
 	hddsize last = device->GetSize();
 	device->SeekTo(last);
 
+	// record latency of test seeks
+	device->timer.SetHistogram(&result.histogram);
+
 	// test SEEKER_SEEKCOUNT seeks
 	for(int i = 0; i < SEEKER_SEEKCOUNT; ++i) {
-		hddsize next = gen.Get64() % device->GetSize();	// get next position
+		hddsize next = offsets.Get(gen);	// get next position
 
 		// make timed seek
 		hddtime timediff = device->SeekTo(next);
@@ -67,7 +66,7 @@ void Seeker::TestLoop() {
 		last = next;
 
 		qreal pos = (qreal)posdiff / (qreal)device->GetSize();	// calculate pos relative to drivesize
-                qreal time = (qreal)timediff / 1000.0;			// evaluate seek time in miliseconds
+		qreal time = (qreal)timediff / ms;			// evaluate seek time in miliseconds
 
 		result.AddSeek(QPointF(pos, time));	// add seek to results
 
@@ -80,122 +79,121 @@ void Seeker::TestLoop() {
 	}
 }
 
-void Seeker::InitScene() {
-	// clear ticks
-	dataTicks->erase();
+void Seeker::InitResults() {
+	// clear previous results
+	result.erase();
+	result.seeks.reserve(SEEKER_SEEKCOUNT);
 }
 
-void Seeker::UpdateScene() {
-	// draw new seeks
-	while(!result.newseeks.empty()) {
-		QPointF seek = result.newseeks.pop();
-
-		// mark seek as important if it is close to average
-		if(seek.ry() < SEEKER_IMPORTANT * result.avg()) {
-			dataTicks->AddTick(seek.y(), seek.x(), true);
-		} else {
-			dataTicks->AddTick(seek.y(), seek.x(), false);
-		}
-	}
+int Seeker::GetProgress() {
+	return result.progress;
+}
 
-	// draw new reference seeks
-	while(!reference.newseeks.empty()) {
-		QPointF seek = reference.newseeks.pop();
+QString Seeker::GetSummary() {
+	return "Seek time: " + result.stats.Summary("ms") + "\n" +
+			"Seek time percentiles: " + result.histogram.Summary();
+}
 
-		// mark seek as important if it is close to average
-		if(seek.ry() < SEEKER_IMPORTANT * reference.avg()) {
-			referenceTicks->AddTick(seek.y(), seek.x(), true);
-		} else {
-			referenceTicks->AddTick(seek.y(), seek.x(), false);
-		}
+QList<Benchmark::Metric> Seeker::GetMetrics() {
+	QList<Metric> metrics;
+	if(result.stats.Count() > 0) {
+		metrics.append(Metric("Seek time", result.stats.Mean(), "ms", false));
+		metrics.append(Metric("Seek time p99", (qreal)result.histogram.Percentile(99) / ms, "ms", false));
 	}
 
-	// update lines
-	dataAvgLine->SetValue(result.avg());
-	referenceAvgLine->SetValue(reference.avg());
-
-	// rescale view
-	Rescale();
+	return metrics;
 }
 
-int Seeker::GetProgress() {
-	return result.progress;
+hddsize Seeker::GetRandomBlock() {
+	return SEEKER_BLOCKSIZE;
 }
 
 void Seeker::SeekResult::AddSeek(QPointF seek) {
-	// count new average seek
-	average = ((qreal)seeks.count() * average + seek.y()) / (seeks.count() + 1);
+	// update seek time statistics
+	stats.Add(seek.y());
 
 	seeks.push_back(seek);		// add seek to result seek list
-	newseeks.push_back(seek);	// add sekk to stack used for drawing new results
+	newseeks.Push(seek);		// add seek to ring used for drawing new results
 }
 
 qreal Seeker::SeekResult::avg() {
-	return average;
+	return stats.Mean();
 }
 
 void Seeker::SeekResult::erase() {
 	seeks.erase(seeks.begin(), seeks.end());
-	newseeks.erase(newseeks.begin(), newseeks.end());
+	newseeks.Clear();
 	progress = 0.0f;
-	average = 0.0f;
+	stats.erase();
+	histogram.erase();
 }
 
-QDomElement Seeker::WriteResults(QDomDocument &doc) {
+void Seeker::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("Seeker");
-	master.setAttribute("valid", (GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("Seeker");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("seed", seed);
+	writer.Attribute("range_begin", rangeBegin);
+	writer.Attribute("range_end", rangeEnd);
 
 	// add values to main element
 	if(GetProgress() == 100) for(int i = 0; i < result.seeks.size(); ++i) {
-		QDomElement value = doc.createElement("Seek");
-		value.setAttribute("length", result.seeks[i].x());
-		value.setAttribute("time", result.seeks[i].y());
-		master.appendChild(value);
+		writer.StartElement("Seek");
+		writer.Attribute("length", result.seeks[i].x());
+		writer.Attribute("time", result.seeks[i].y());
+		writer.EndElement();
 	}
 
-	return master;
+	// write seek latencies
+	if(GetProgress() == 100) {
+		result.histogram.Write(writer);
+	}
+
+	sampler.Write(writer);
+
+	writer.EndElement();
 }
 
-void Seeker::RestoreResults(QDomElement &results, DataSet dataset) {
+void Seeker::RestoreResults(const ResultElement &results, DataSet dataset) {
 	SeekResult &result = (dataset == REFERENCE)?this->reference:this->result;
 
 	// Locate main seek element
-	QDomElement seek = results.firstChildElement("Seeker");
-	if(!seek.attribute("valid", "no").compare("no")) {
+	ResultElement seek = results.Child("Seeker");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(seek);
+	}
+	if(!seek.Attribute("valid", "no").compare("no")) {
 		return;
 	}
 
-	// clear results and initialize scene
+	// clear results
 	result.erase();
-	(dataset == REFERENCE)?referenceTicks->erase():dataTicks->erase();
 
 	// get list of seeks
-	QDomNodeList seeks = seek.elementsByTagName("Seek");
+	ResultList seeks = seek.Children("Seek");
+	ResultColumn lengths = seeks.Column("length");
+	ResultColumn times = seeks.Column("time");
 
 	// read result data
-	for(int i = 0; i < seeks.size(); ++i) {
-			result.AddSeek(
-				QPointF(
-						seeks.at(i).toElement().attribute("length", "0").toDouble(),
-						seeks.at(i).toElement().attribute("time", "0").toDouble()));
+	for(int i = 0; i < seeks.Size(); ++i) {
+		result.AddSeek(QPointF(lengths.Number(i), times.Number(i)));
 	}
 
 	// set progress
 	result.progress = 100;
 
-	// refresh view
-	UpdateScene();
+	// read seek latencies
+	result.histogram.Read(seek);
 }
 
 void Seeker::EraseResults(DataSet dataset) {
 	if(dataset == RESULTS) {
+		sampler.erase();
 		result.erase();
-		dataTicks->erase();
 	} else {
 		reference.erase();
-		referenceTicks->erase();
 	}
-	UpdateScene();
 }
@@ -25,37 +25,39 @@
 #include <QPointF>
 #include <QtCore>
 #include <QList>
-#include <QGraphicsLineItem>
-#include <QGraphicsTextItem>
 #include <QtXml>
 
-#include "testwidget.h"
+#include "benchmark.h"
 #include "device.h"
 #include "randomgenerator.h"
+#include "ring.h"
+#include "statistics.h"
 
 /// Seeker benchmark main class
 /** Seeker test class. Implements Seeker test. The test test device for ramdom position access.
-Attempts to access different random positions on drive are made. Results are shown as dots.
-Dots shows dependency of seek time on seek length. **/
-class Seeker : public TestWidget {
+Attempts to access different random positions on drive are made. Every seek keeps its
+length and time, so dependency of seek time on seek length can be shown.
+@see SeekerWidget **/
+class Seeker : public Benchmark {
 private:
 	/// Keeps information about running or pased seek test
 	class SeekResult {
 	public:
 		SeekResult():
-				progress(0) {}
+				newseeks(SEEKER_SEEKCOUNT), progress(0) {}
 
 		void erase();					/// Erase all seeks
 		void AddSeek(QPointF seek);		/// Add seek to this test
 		qreal avg();					/// Get overall average seek time
-		qreal average;
+		Statistics stats;				/// Seek time statistics
 
 		QList<QPointF> seeks;		/// List of seeks in results
-		QStack<QPointF> newseeks;	/// List of new seeks (not yet displayed)
+		Ring<QPointF> newseeks;		/// New seeks (not yet displayed)
 		unsigned int progress;		/// Percentage progress of the test
+		Histogram histogram;		/// Seek time latencies
 	};
 public:
-	explicit Seeker(QWidget *parent = 0);
+	explicit Seeker(QObject *parent = 0);
 	~Seeker();
 
 	static const hddsize SEEKER_BLOCKSIZE = 512 * B;	/// seek read size
@@ -65,21 +67,14 @@ public:
 	SeekResult result;		/// Seek results
 	SeekResult reference;	/// Seek reference results
 
+	void InitResults();	/// Erases results before benchmark begins
 	void TestLoop();	/// Main benchmark code
-	void InitScene();	/// Initializes scene before benchmark begins
-	void UpdateScene();	/// Updates scene
 	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+	hddsize GetRandomBlock();	/// Block read at random positions
 
-	QDomElement WriteResults(QDomDocument &doc);				/// Writes results of test to XML
-	void RestoreResults(QDomElement &root, DataSet dataset);	/// Reads results from XML document
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
 	void EraseResults(DataSet dataset);							/// Erases selected results
-
-private:
-	Line *dataAvgLine;
-	Line *referenceAvgLine;
-
-	Ticks *dataTicks;
-	Ticks *referenceTicks;
-
-	Net* net;
 };
@@ -0,0 +1,83 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "seekerwidget.h"
+
+SeekerWidget::SeekerWidget(QWidget *parent) :
+	TestWidget(new Seeker(), parent), test(static_cast<Seeker*>(benchmark)) {
+	dataAvgLine = addLine("ms", "Avg", QColor(255, 0, 0));
+	referenceAvgLine = addLine("ms", "Avg", QColor(0, 0, 255));
+	percentiles = addPercentiles("ms", QColor(255, 160, 0));
+
+	dataTicks = addTicks(QColor(255, 0, 0));
+	referenceTicks = addTicks(QColor(0, 0, 255));
+
+	net = addNet("ms", "Seek length", "Seek time");
+
+	// raw device test can bypass page cache
+	SetDirectIOVisible(true);
+}
+
+void SeekerWidget::InitScene() {
+	// clear ticks of previous results
+	dataTicks->erase();
+}
+
+void SeekerWidget::UpdateScene() {
+	// draw new seeks
+	QPointF seek;
+	while(test->result.newseeks.Pop(seek)) {
+		// mark seek as important if it is close to average
+		if(seek.ry() < Seeker::SEEKER_IMPORTANT * test->result.avg()) {
+			dataTicks->AddTick(seek.y(), seek.x(), true);
+		} else {
+			dataTicks->AddTick(seek.y(), seek.x(), false);
+		}
+	}
+
+	// draw new reference seeks
+	while(test->reference.newseeks.Pop(seek)) {
+		// mark seek as important if it is close to average
+		if(seek.ry() < Seeker::SEEKER_IMPORTANT * test->reference.avg()) {
+			referenceTicks->AddTick(seek.y(), seek.x(), true);
+		} else {
+			referenceTicks->AddTick(seek.y(), seek.x(), false);
+		}
+	}
+
+	// update lines
+	dataAvgLine->SetValue(test->result.avg());
+	referenceAvgLine->SetValue(test->reference.avg());
+	percentiles->Set(Settled(test->result.histogram, Benchmark::RESULTS), ms);
+
+	// rescale view
+	Rescale();
+}
+
+void SeekerWidget::EraseResults(Benchmark::DataSet dataset) {
+	(dataset == Benchmark::REFERENCE)?referenceTicks->erase():dataTicks->erase();
+	TestWidget::EraseResults(dataset);
+}
+
+void SeekerWidget::RestoreResults(const ResultElement &root, Benchmark::DataSet dataset) {
+	// restored seeks are added to empty ticks
+	(dataset == Benchmark::REFERENCE)?referenceTicks->erase():dataTicks->erase();
+	TestWidget::RestoreResults(root, dataset);
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "seeker.h"
+
+/// Seeker benchmark widget
+/** Shows results of Seeker benchmark. Seeks are shown as ticks,
+ticks show dependency of seek time on seek length.
+@see Seeker class **/
+class SeekerWidget : public TestWidget {
+public:
+	explicit SeekerWidget(QWidget *parent = 0);	/// The constructor
+
+	void InitScene();	/// Initializes scene before benchmark begins
+	void UpdateScene();	/// Updates scene
+	void EraseResults(Benchmark::DataSet dataset);	/// Erases selected results and their ticks
+	void RestoreResults(const ResultElement &root, Benchmark::DataSet dataset);	/// Reads results and redraws their ticks
+
+	Seeker *test;	/// Benchmark shown by widget
+
+private:
+	Line *dataAvgLine;
+	Line *referenceAvgLine;
+
+	Percentiles *percentiles;
+
+	Ticks *dataTicks;
+	Ticks *referenceTicks;
+
+	Net* net;
+};
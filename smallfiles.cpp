@@ -20,178 +20,161 @@
 
 #include "smallfiles.h"
 
-SmallFiles::SmallFiles(QWidget *parent):
-	TestWidget(parent) {
-	build_dir_bar = this->addBar(	"s", "Dirs",		QColor(255,	0,		0),	0.03, 0.1);
-	build_files_bar = this->addBar(	"s", "Files 1-10K",	QColor(255,	64,		0),	0.27, 0.1);
-	read_files_bar = this->addBar(	"s", "Read files",	QColor(255,	128,	0),	0.51, 0.1);
-	destroy_bar = this->addBar(		"s", "Delete",		QColor(255,	192,	0),	0.75, 0.1);
-
-	build_dir_reference_bar = this->addBar(		"s", "Dirs",		QColor(0,	0,		255),	0.14, 0.1);
-	build_files_reference_bar = this->addBar(	"s", "Files 1-10K",	QColor(0,	64,		255),	0.38, 0.1);
-	read_files_reference_bar = this->addBar(	"s", "Read files",	QColor(0,	128,	255),	0.62, 0.1);
-	destroy_reference_bar = this->addBar(		"s", "Delete",		QColor(0,	192,	255),	0.86, 0.1);
-
+SmallFiles::SmallFiles(QObject *parent):
+	Benchmark(parent), parallel(this, SMALLFILES_SIZE, SMALLFILES_SIZE, K, 10 * K) {
 	testName = "Small files";
 	testDescription = "This test creates random directory struture containing " + QString::number(SMALLFILES_SIZE) +
 			" then " + QString::number(SMALLFILES_SIZE) +
 			" files in size 1K to 10K are randomly distributed across this strucure." +
 			" after this files are read again in random order. Finally whole structure is deleted including files." +
 			" Every operation has it`s own bar that shows operation time." +
-			" This test is only aviable for devices containing mounted filesystem.";
+			" This test is only aviable for devices containing mounted filesystem." +
+			" Operations are made by system calls relative to open parent directory," +
+			" legacy path mode uses absolute paths and Qt file operations instead.";
+	testDescription += parallel.Description();
+
+	AddMode("Sequential");
+	AddMode("Parallel");
+	AddMode("Sequential, legacy path");
 }
 
-void SmallFiles::InitScene() {
-	results.erase();
+void SmallFiles::InitResults() {
+	if(mode == MODE_PARALLEL) {
+		parallel.EraseResults(RESULTS);
+	} else {
+		results.erase();
+	}
 }
 
 void SmallFiles::TestLoop() {
+	if(mode == MODE_PARALLEL) {
+		parallel.TestLoop();
+		return;
+	}
+
 	// init random
-	RandomGenerator random;
+	RandomGenerator random(seed);
 
-	// list of nodes in test
-	int counter = 1;
-	QList<QString> files;
-	QList<QString> nodes;
-	nodes.push_back(device->GetSafeTemp());	//	add initial node
+	// tree of nodes in test, node 0 is temp
+	results.legacy = (mode == MODE_LEGACY);
+	FileTree tree(device, device->GetSafeTemp(), results.legacy);
 
 	// build dirs
 	results.phase = SmallFilesResults::PHASE_DIR_BUILD;
+	device->timer.SetHistogram(&results.dir_build_histogram);
 	device->DropCaches();
 	device->Sync();
 	for(int i = 0; (i < SMALLFILES_SIZE) && (testState != STOPPING); ++i) {
-		// construct new node name and path
-		QString file = nodes.at(random.Get64() % nodes.size()) + "/" + QString::number(counter++);
-		nodes.push_back(file);
-
-		// create node
-		hddtime time = device->MkDir(file);
+		// create node in random directory
+		hddtime time = tree.MkDir(random.Below(tree.Dirs()));
 		results.dir_build_time += time;
 
 		++results.dirs_build;
 	}
-	results.dir_build_time += device->Sync();
+	results.dir_build_flush += device->Sync();
 
 	// build files
 	results.phase = SmallFilesResults::PHASE_FILE_BUILD;
+	device->timer.SetHistogram(&results.file_build_histogram);
 	device->DropCaches();
 	for(int i = 0; (i < SMALLFILES_SIZE) && (testState != STOPPING); ++i) {
-		// construct new node name and path
-		QString file = nodes.at(random.Get64() % nodes.size()) + "/" + QString::number(counter++);
-		files.push_back(file);
-
-		// create file
-		hddtime time = device->MkFile(file, K + random.Get64() % (9 * K));
+		// create file in random directory
+		int parent = random.Below(tree.Dirs());
+		hddtime time = tree.MkFile(parent, K + random.Below(9 * K));
 		results.file_build_time += time;
 
 		++results.files_build;
 	}
-	results.file_build_time += device->Sync();
+	results.file_build_flush += device->Sync();
 
 	// read files in random order
 	results.phase = SmallFilesResults::PHASE_FILE_READ;
+	device->timer.SetHistogram(&results.file_read_histogram);
 	device->DropCaches();
-	QList<QString> files_to_read(files);
+	QList<int> files_to_read;
+	for(int i = 0; i < tree.Files(); ++i) {
+		files_to_read.push_back(i);
+	}
 	while(!files_to_read.empty() && (testState != STOPPING)) {
 		// generate random index
-		int index = random.Get64() % files_to_read.size();
-		hddtime time = device->ReadFile(files_to_read[index]);
+		int index = random.Below(files_to_read.size());
+		hddtime time = tree.ReadFile(files_to_read[index]);
 		files_to_read.removeAt(index);
 		results.file_read_time += time;
 
 		++results.files_read;
 	}
-	results.file_read_time += device->Sync();
+	results.file_read_flush += device->Sync();
 
 	// make sure caches are empty
 	device->DropCaches();
 
 	// del files
 	results.phase = SmallFilesResults::PHASE_DESTROY;
-	for(int i = 0; i < files.size(); ++i) {
-		results.destroy_time += device->DelFile(files[i]);
+	device->timer.SetHistogram(&results.destroy_histogram);
+	for(int i = 0; i < tree.Files(); ++i) {
+		results.destroy_time += tree.DelFile(i);
 		++results.destroyed;
 	}
-	results.destroy_time += device->Sync();
+	results.destroy_flush += device->Sync();
 
 	// del dirs
-	for(int i = nodes.size() - 1; i > 0 ; --i) {
-		results.destroy_time += device->DelDir(nodes[i]);
+	for(int i = tree.Dirs() - 1; i > 0 ; --i) {
+		results.destroy_time += tree.DelDir(i);
 		++results.destroyed;
 	}
-	results.destroy_time += device->Sync();
+	results.destroy_flush += device->Sync();
 
 	results.done = true;
 	results.phase = SmallFilesResults::PHASE_DONE;
+	device->timer.SetHistogram(NULL);
 
 	device->ClearSafeTemp();
 }
 
-void SmallFiles::UpdateScene() {
-	// get progress
-	hddtime dir_build = results.dir_build_time;
-	hddtime file_build = results.file_build_time;
-	hddtime file_read =  results.file_read_time;
-	hddtime destroy = results.destroy_time;
-
-	// add current operation progress
-	if(device) {
-		switch(results.phase) {
-		case SmallFilesResults::PHASE_DIR_BUILD:
-			dir_build += device->timer.GetCurrentOffset();
-			break;
-		case SmallFilesResults::PHASE_FILE_BUILD:
-			file_build += device->timer.GetCurrentOffset();
-			break;
-		case SmallFilesResults::PHASE_FILE_READ:
-			file_read += device->timer.GetCurrentOffset();
-			break;
-		case SmallFilesResults::PHASE_DESTROY:
-			destroy += device->timer.GetCurrentOffset();
-		default:
-			break;	// other phases do not add extra time
-		}
+int SmallFiles::GetProgress() {
+	if(mode == MODE_PARALLEL) {
+		return parallel.GetProgress();
 	}
 
-	// update bars
-	build_dir_bar->Set(
-			100 * results.dirs_build / SMALLFILES_SIZE,
-			(qreal)dir_build / s);
-	build_files_bar->Set(
-			100 * results.files_build / SMALLFILES_SIZE,
-			(qreal)file_build / s);
-	read_files_bar->Set(
-			100 * results.files_read / SMALLFILES_SIZE,
-			(qreal)file_read / s);
-	destroy_bar->Set(
-			100 * results.destroyed / (SMALLFILES_SIZE * 2),
-			(qreal)(destroy) / s);
-
-	// update reference bars
-	build_dir_reference_bar->Set(
-			100 * reference.dirs_build / SMALLFILES_SIZE,
-			(qreal)reference.dir_build_time / s);
-	build_files_reference_bar->Set(
-			100 * reference.files_build / SMALLFILES_SIZE,
-			(qreal)reference.file_build_time / s);
-	read_files_reference_bar->Set(
-			100 * reference.files_read / SMALLFILES_SIZE,
-			(qreal)reference.file_read_time / s);
-	destroy_reference_bar->Set(
-			100 * reference.destroyed / (SMALLFILES_SIZE * 2),
-			(qreal)reference.destroy_time / s);
-
-	// rescale
-	Rescale();
+	return GetSequentialProgress();
 }
 
-int SmallFiles::GetProgress() {
+int SmallFiles::GetSequentialProgress() {
 	// "+ results.done" and  "+ 1" forces 99% until filan sync is done
 	int state = results.dirs_build + results.files_build + results.files_read + results.destroyed + results.done;
 	int target = 5 * SMALLFILES_SIZE + 1;
 	return (100 * state) / target;
 }
 
+QString SmallFiles::GetSummary() {
+	if(mode == MODE_PARALLEL) {
+		return parallel.GetSummary();
+	}
+
+	return QString("Path: ") + (results.legacy?"legacy":"syscall") + "\n" +
+			"Dirs: " + Def::FormatTime(results.dir_build_time) + ", " + results.dir_build_histogram.Summary() + "\n" +
+			"Files: " + Def::FormatTime(results.file_build_time) + ", " + results.file_build_histogram.Summary() + "\n" +
+			"Read files: " + Def::FormatTime(results.file_read_time) + ", " + results.file_read_histogram.Summary() + "\n" +
+			"Delete: " + Def::FormatTime(results.destroy_time) + ", " + results.destroy_histogram.Summary() + "\n" +
+			"Flush: " + Def::FormatTime(results.dir_build_flush + results.file_build_flush +
+					results.file_read_flush + results.destroy_flush);
+}
+
+QList<Benchmark::Metric> SmallFiles::GetMetrics() {
+	QList<Metric> metrics;
+	if(GetSequentialProgress() == 100) {
+		metrics.append(Metric("Dirs", (qreal)results.dir_build_time / s, "s", false));
+		metrics.append(Metric("Files", (qreal)results.file_build_time / s, "s", false));
+		metrics.append(Metric("Read files", (qreal)results.file_read_time / s, "s", false));
+		metrics.append(Metric("Delete", (qreal)results.destroy_time / s, "s", false));
+		metrics.append(Metric("Flush", (qreal)(results.dir_build_flush + results.file_build_flush +
+				results.file_read_flush + results.destroy_flush) / s, "s", false));
+	}
+
+	return metrics + parallel.GetMetrics();
+}
+
 SmallFilesResults::SmallFilesResults() {
 	erase();
 }
@@ -202,95 +185,130 @@ void SmallFilesResults::erase() {
 	file_read_time = 0;
 	destroy_time = 0;
 
+	dir_build_flush = 0;
+	file_build_flush = 0;
+	file_read_flush = 0;
+	destroy_flush = 0;
+
 	dirs_build = 0;
 	files_build = 0;
 	files_read = 0;
 	destroyed = 0;
 
+	dir_build_histogram.erase();
+	file_build_histogram.erase();
+	file_read_histogram.erase();
+	destroy_histogram.erase();
+
 	done = false;
+	legacy = false;
 	phase = PHASE_NONE;
 }
 
-QDomElement SmallFiles::WriteResults(QDomDocument &doc) {
+void SmallFiles::WriteResults(ResultWriter &writer) {
 	// create main seek element
-	QDomElement master = doc.createElement("Small_Files");
-	master.setAttribute("valid", (this->GetProgress() == 100)?"yes":"no");
-	doc.appendChild(master);
+	writer.StartElement("Small_Files");
+	writer.Attribute("valid", (GetSequentialProgress() == 100)?"yes":"no");
+	writer.Attribute("path", results.legacy?"legacy":"syscall");
+	writer.Attribute("seed", seed);
+	writer.Attribute("pattern", pattern.Name());
 
+	// add phase elements
+	WritePhase(writer, "Build_dirs", results.dir_build_time, results.dir_build_flush, results.dir_build_histogram);
+	WritePhase(writer, "Build_files", results.file_build_time, results.file_build_flush, results.file_build_histogram);
+	WritePhase(writer, "Read_files", results.file_read_time, results.file_read_flush, results.file_read_histogram);
+	WritePhase(writer, "Destroy", results.destroy_time, results.destroy_flush, results.destroy_histogram);
 
-	// add build dirs element
-	QDomElement build_dirs = doc.createElement("Build_dirs");
-	build_dirs.setAttribute("time", results.dir_build_time);
-	master.appendChild(build_dirs);
+	// add parallel mode results
+	parallel.WriteResults(writer);
 
-	// add build files element
-	QDomElement build_files = doc.createElement("Build_files");
-	build_files.setAttribute("time", results.file_build_time);
-	master.appendChild(build_files);
+	sampler.Write(writer);
 
-	// add read files element
-	QDomElement read_files = doc.createElement("Read_files");
-	read_files.setAttribute("time", results.file_read_time);
-	master.appendChild(read_files);
-
-	// add destroy element
-	QDomElement destroy = doc.createElement("Destroy");
-	destroy.setAttribute("time", results.destroy_time);
-	master.appendChild(destroy);
+	writer.EndElement();
+}
 
-	return master;
+void SmallFiles::WritePhase(ResultWriter &writer, QString name, hddtime time, hddtime flush, const Histogram &histogram) {
+	writer.StartElement(name);
+	writer.Attribute("time", time);
+	writer.Attribute("flush", flush);
+	histogram.Write(writer);
+	writer.EndElement();
 }
 
-void SmallFiles::RestoreResults(QDomElement &results, DataSet dataset) {
+void SmallFiles::RestoreResults(const ResultElement &results, DataSet dataset) {
 	SmallFilesResults &res = (dataset == REFERENCE)?this->reference:this->results;
 
 	// Locate main seek element
-	QDomElement main = results.firstChildElement("Small_Files");
-	if(!main.attribute("valid", "no").compare("no"))
+	ResultElement main = results.Child("Small_Files");
+
+	// throughput samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+	}
+
+	// parallel mode results are valid on their own
+	parallel.RestoreResults(main, dataset);
+
+	if(!main.Attribute("valid", "no").compare("no")) {
 		return;
+	}
 
-	// init scene and remove results
+	// remove results
 	res.erase();
+	hddtime unit = Def::StoredTimeUnit(main);
+
+	// results without path were measured by legacy path
+	res.legacy = (main.Attribute("path", "legacy") == "legacy");
 
 	//// get dirs build
-	QDomElement dir_build = main.firstChildElement("Build_dirs");
-	if(dir_build.isNull())
+	ResultElement dir_build = main.Child("Build_dirs");
+	if(dir_build.IsNull())
 		return;
-	res.dir_build_time = dir_build.attribute("time", "0").toDouble();
+	res.dir_build_time = dir_build.Number("time") * unit;
+	res.dir_build_flush = dir_build.Number("flush") * unit;
+	res.dir_build_histogram.Read(dir_build);
 
 	//// get file build
-	QDomElement files_build = main.firstChildElement("Build_files");
-	if(files_build.isNull())
+	ResultElement files_build = main.Child("Build_files");
+	if(files_build.IsNull())
 		return;
-	res.file_build_time = files_build.attribute("time", "0").toDouble();
+	res.file_build_time = files_build.Number("time") * unit;
+	res.file_build_flush = files_build.Number("flush") * unit;
+	res.file_build_histogram.Read(files_build);
 
 	//// get read files
-	QDomElement files_read = main.firstChildElement("Read_files");
-	if(files_read.isNull())
+	ResultElement files_read = main.Child("Read_files");
+	if(files_read.IsNull())
 		return;
-	res.file_read_time = files_read.attribute("time", "0").toDouble();
+	res.file_read_time = files_read.Number("time") * unit;
+	res.file_read_flush = files_read.Number("flush") * unit;
+	res.file_read_histogram.Read(files_read);
 
 	//// get destroy
-	QDomElement destroy = main.firstChildElement("Destroy");
-	if(destroy.isNull())
+	ResultElement destroy = main.Child("Destroy");
+	if(destroy.IsNull())
 		return;
-	res.destroy_time = destroy.attribute("time", "0").toDouble();
+	res.destroy_time = destroy.Number("time") * unit;
+	res.destroy_flush = destroy.Number("flush") * unit;
+	res.destroy_histogram.Read(destroy);
 
-	// set progress and update scene
+	// set progress
 	res.dirs_build = SMALLFILES_SIZE;
 	res.files_build = SMALLFILES_SIZE;
 	res.files_read = SMALLFILES_SIZE;
 	res.destroyed = 2 * SMALLFILES_SIZE;
 	res.done = true;
-
-	UpdateScene();
 }
 
 void SmallFiles::EraseResults(DataSet dataset) {
+	// samples are kept for results only
+	if(dataset == RESULTS) {
+		sampler.erase();
+	}
+
 	if(dataset == RESULTS)
 		results.erase();
 	else
 		reference.erase();
-
-	UpdateScene();
+	parallel.EraseResults(dataset);
 }
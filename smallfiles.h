@@ -20,8 +20,10 @@
 
 #pragma once
 
-#include "testwidget.h"
+#include "benchmark.h"
 #include "randomgenerator.h"
+#include "parallelmetadata.h"
+#include "filetree.h"
 
 /// Stores Small Files benchmark results
 /** SmallFilesResults class encapsulates resutls of SmallFiles benchmark
@@ -38,14 +40,25 @@ public:
 	hddtime file_read_time;		/// File read time
 	hddtime destroy_time;		/// Files and directories erase time
 
+	hddtime dir_build_flush;	/// Filesystem flush time after directory build
+	hddtime file_build_flush;	/// Filesystem flush time after file build
+	hddtime file_read_flush;	/// Filesystem flush time after file read
+	hddtime destroy_flush;		/// Filesystem flush time after erase
+
 	int dirs_build;		/// Count of dirs build
 	int files_build;	/// Count of files build
 	int files_read;		/// Count of files read
 	int destroyed;		/// Count of files and direories deleted
+
+	Histogram dir_build_histogram;	/// Directory create latencies
+	Histogram file_build_histogram;	/// File create latencies
+	Histogram file_read_histogram;	/// File read latencies
+	Histogram destroy_histogram;	/// File and directory delete latencies
 	bool done;		/// Whenever the benchmark has finished
+	bool legacy;	/// Whenever absolute path Qt operations were used
 
 	/** The phase of the benchmark. This is needed when realtime graph is constructed
-	 int order to add sync operation time to preciously measured operation time. **/
+	 int order to add current operation time to preciously measured operation time. **/
 	Phase phase;
 
 	void erase();	/// Erases all results
@@ -54,45 +67,53 @@ public:
 /// Small Files benchmark main class
 /** Small files test class. Small files test is focuse on working with mixure of small files and dirs.
 A huge structure of files and dirs is build then files are read and the whole structure is destroyed again.
-Times of all kinds of operations are measured and whown in the bar graph.
-@see SmallFilesResults class **/
-class SmallFiles : public TestWidget {
+Times of all kinds of operations are measured.
+In parallel mode the structure is split between several threads instead.
+@see SmallFilesResults class
+@see ParallelMetadata class
+@see SmallFilesWidget class **/
+class SmallFiles : public Benchmark {
 public:
-	SmallFiles(QWidget *parent = 0);	/// The SmallFiles constructor
+	SmallFiles(QObject *parent = 0);	/// The SmallFiles constructor
 
 	/** Count of the files and directories used in the benchmark **/
 	static const int SMALLFILES_SIZE = 1000;
 
-	/// Initializes the graph scene
-	void InitScene();
+	/// Benchmark modes
+	enum Mode { MODE_SEQUENTIAL, MODE_PARALLEL, MODE_LEGACY };
+
+	/// Erases results before benchmark begins
+	void InitResults();
 	/// The main benchmark code
 	void TestLoop();
-	/// Updates graph
-	void UpdateScene();
 	/// Returns benchmark progress
 	int GetProgress();
+	/// Returns summary of results
+	QString GetSummary();
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
 
 	/// Primary resutls
 	SmallFilesResults results;
 	/// Reference results
 	SmallFilesResults reference;
+	/// Parallel mode results
+	ParallelMetadata parallel;
 
-	/// Writes results of test to XML
-	QDomElement WriteResults(QDomDocument &doc);
+	/// Writes results of test
+	void WriteResults(ResultWriter &writer);
 	/// Reads results from XML document
-	void RestoreResults(QDomElement &root, DataSet dataset);
+	void RestoreResults(const ResultElement &root, DataSet dataset);
 	/// Erases results
 	void EraseResults(DataSet dataset);
 
-private:
-	Bar *build_dir_bar;
-	Bar *build_files_bar;
-	Bar *read_files_bar;
-	Bar *destroy_bar;
-
-	Bar *build_dir_reference_bar;
-	Bar *build_files_reference_bar;
-	Bar *read_files_reference_bar;
-	Bar *destroy_reference_bar;
+	/** Write phase element with time and latencies
+	  @param writer writer receiving element
+	  @param name element name
+	  @param time phase time
+	  @param flush flush time after phase
+	  @param histogram phase latencies **/
+	void WritePhase(ResultWriter &writer, QString name, hddtime time, hddtime flush, const Histogram &histogram);
 
+private:
+	int GetSequentialProgress();	/// Returns sequential mode progress
 };
@@ -0,0 +1,118 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "smallfileswidget.h"
+
+SmallFilesWidget::SmallFilesWidget(QWidget *parent):
+	TestWidget(new SmallFiles(), parent), test(static_cast<SmallFiles*>(benchmark)),
+	parallel(this, &test->parallel) {
+	build_dir_bar = this->addBar(	"s", "Dirs",		QColor(255,	0,		0),	0.03, 0.1);
+	build_files_bar = this->addBar(	"s", "Files 1-10K",	QColor(255,	64,		0),	0.27, 0.1);
+	read_files_bar = this->addBar(	"s", "Read files",	QColor(255,	128,	0),	0.51, 0.1);
+	destroy_bar = this->addBar(		"s", "Delete",		QColor(255,	192,	0),	0.75, 0.1);
+
+	build_dir_reference_bar = this->addBar(		"s", "Dirs",		QColor(0,	0,		255),	0.14, 0.1);
+	build_files_reference_bar = this->addBar(	"s", "Files 1-10K",	QColor(0,	64,		255),	0.38, 0.1);
+	read_files_reference_bar = this->addBar(	"s", "Read files",	QColor(0,	128,	255),	0.62, 0.1);
+	destroy_reference_bar = this->addBar(		"s", "Delete",		QColor(0,	192,	255),	0.86, 0.1);
+}
+
+void SmallFilesWidget::InitScene() {}
+
+void SmallFilesWidget::UpdateScene() {
+	// get progress
+	hddtime dir_build = test->results.dir_build_time;
+	hddtime file_build = test->results.file_build_time;
+	hddtime file_read =  test->results.file_read_time;
+	hddtime destroy = test->results.destroy_time;
+
+	// add current operation progress
+	if(test->device) {
+		switch(test->results.phase) {
+		case SmallFilesResults::PHASE_DIR_BUILD:
+			dir_build += test->device->timer.GetCurrentOffset();
+			break;
+		case SmallFilesResults::PHASE_FILE_BUILD:
+			file_build += test->device->timer.GetCurrentOffset();
+			break;
+		case SmallFilesResults::PHASE_FILE_READ:
+			file_read += test->device->timer.GetCurrentOffset();
+			break;
+		case SmallFilesResults::PHASE_DESTROY:
+			destroy += test->device->timer.GetCurrentOffset();
+		default:
+			break;	// other phases do not add extra time
+		}
+	}
+
+	// sequential bars are hidden in parallel mode
+	bool sequential = (test->mode != SmallFiles::MODE_PARALLEL);
+	build_dir_bar->SetVisible(sequential);
+	build_files_bar->SetVisible(sequential);
+	read_files_bar->SetVisible(sequential);
+	destroy_bar->SetVisible(sequential);
+	build_dir_reference_bar->SetVisible(sequential);
+	build_files_reference_bar->SetVisible(sequential);
+	read_files_reference_bar->SetVisible(sequential);
+	destroy_reference_bar->SetVisible(sequential);
+	parallel.UpdateScene(!sequential);
+
+	// update bars
+	build_dir_bar->Set(
+			100 * test->results.dirs_build / SmallFiles::SMALLFILES_SIZE,
+			(qreal)dir_build / s);
+	build_files_bar->Set(
+			100 * test->results.files_build / SmallFiles::SMALLFILES_SIZE,
+			(qreal)file_build / s);
+	read_files_bar->Set(
+			100 * test->results.files_read / SmallFiles::SMALLFILES_SIZE,
+			(qreal)file_read / s);
+	destroy_bar->Set(
+			100 * test->results.destroyed / (SmallFiles::SMALLFILES_SIZE * 2),
+			(qreal)(destroy) / s);
+
+	// update reference bars
+	build_dir_reference_bar->Set(
+			100 * test->reference.dirs_build / SmallFiles::SMALLFILES_SIZE,
+			(qreal)test->reference.dir_build_time / s);
+	build_files_reference_bar->Set(
+			100 * test->reference.files_build / SmallFiles::SMALLFILES_SIZE,
+			(qreal)test->reference.file_build_time / s);
+	read_files_reference_bar->Set(
+			100 * test->reference.files_read / SmallFiles::SMALLFILES_SIZE,
+			(qreal)test->reference.file_read_time / s);
+	destroy_reference_bar->Set(
+			100 * test->reference.destroyed / (SmallFiles::SMALLFILES_SIZE * 2),
+			(qreal)test->reference.destroy_time / s);
+
+	// show p99 operation latency with phase name
+	build_dir_bar->SetName("Dirs\np99 " + Def::FormatTime(Settled(test->results.dir_build_histogram, Benchmark::RESULTS).Percentile(99)));
+	build_files_bar->SetName("Files 1-10K\np99 " + Def::FormatTime(Settled(test->results.file_build_histogram, Benchmark::RESULTS).Percentile(99)));
+	read_files_bar->SetName("Read files\np99 " + Def::FormatTime(Settled(test->results.file_read_histogram, Benchmark::RESULTS).Percentile(99)));
+	destroy_bar->SetName("Delete\np99 " + Def::FormatTime(Settled(test->results.destroy_histogram, Benchmark::RESULTS).Percentile(99)));
+
+	build_dir_reference_bar->SetName("Dirs\np99 " + Def::FormatTime(Settled(test->reference.dir_build_histogram, Benchmark::REFERENCE).Percentile(99)));
+	build_files_reference_bar->SetName("Files 1-10K\np99 " + Def::FormatTime(Settled(test->reference.file_build_histogram, Benchmark::REFERENCE).Percentile(99)));
+	read_files_reference_bar->SetName("Read files\np99 " + Def::FormatTime(Settled(test->reference.file_read_histogram, Benchmark::REFERENCE).Percentile(99)));
+	destroy_reference_bar->SetName("Delete\np99 " + Def::FormatTime(Settled(test->reference.destroy_histogram, Benchmark::REFERENCE).Percentile(99)));
+
+	// rescale
+	Rescale();
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "testwidget.h"
+#include "smallfiles.h"
+#include "parallelmetadatabars.h"
+
+/// Small Files benchmark widget
+/** Shows results of Small Files benchmark. Every kind of operation has its
+own bar showing operation time, parallel mode bars are shown instead in parallel mode.
+@see SmallFiles class **/
+class SmallFilesWidget : public TestWidget {
+public:
+	SmallFilesWidget(QWidget *parent = 0);	/// The constructor
+
+	void InitScene();	/// Initializes scene before benchmark begins
+	void UpdateScene();	/// Updates scene
+
+	SmallFiles *test;	/// Benchmark shown by widget
+
+private:
+	ParallelMetadataBars parallel;
+
+	Bar *build_dir_bar;
+	Bar *build_files_bar;
+	Bar *read_files_bar;
+	Bar *destroy_bar;
+
+	Bar *build_dir_reference_bar;
+	Bar *build_files_reference_bar;
+	Bar *read_files_reference_bar;
+	Bar *destroy_reference_bar;
+};
@@ -0,0 +1,85 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "statistics.h"
+
+#include <math.h>
+
+Statistics::Statistics() {
+	erase();
+}
+
+void Statistics::Add(qreal value) {
+	// update mean and variance by Welford's method
+	++count;
+	qreal delta = value - mean;
+	mean += delta / count;
+	m2 += delta * (value - mean);
+
+	if((count == 1) || (value < min)) {
+		min = value;
+	}
+	if((count == 1) || (value > max)) {
+		max = value;
+	}
+}
+
+hddsize Statistics::Count() const {
+	return count;
+}
+
+qreal Statistics::Mean() const {
+	return mean;
+}
+
+qreal Statistics::Variance() const {
+	return (count > 1)?m2 / (count - 1):0;
+}
+
+qreal Statistics::Deviation() const {
+	return sqrt(Variance());
+}
+
+qreal Statistics::Min() const {
+	return min;
+}
+
+qreal Statistics::Max() const {
+	return max;
+}
+
+QString Statistics::Summary(QString unit) const {
+	if(count == 0) {
+		return "no data";
+	}
+
+	return "mean " + QString::number(mean, 'f', 2) + " " + unit +
+			", deviation " + QString::number(Deviation(), 'f', 2) + " " + unit +
+			", min " + QString::number(min, 'f', 2) + " " + unit +
+			", max " + QString::number(max, 'f', 2) + " " + unit;
+}
+
+void Statistics::erase() {
+	count = 0;
+	mean = 0;
+	m2 = 0;
+	min = 0;
+	max = 0;
+}
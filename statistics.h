@@ -0,0 +1,60 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <QString>
+
+#include "definitions.h"
+
+using namespace HDDTest;
+
+/// Streaming statistics of benchmark samples
+/** Statistics class accumulates count, mean, variance (Welford's method),
+minimum and maximum of samples in constant time and memory per sample. **/
+class Statistics {
+public:
+	Statistics();	/// Creates empty statistics
+
+	/** Record one sample
+	  @param value sample value **/
+	void Add(qreal value);
+
+	hddsize Count() const;		/// Count of recorded samples
+	qreal Mean() const;			/// Average of samples
+	qreal Variance() const;		/// Sample variance
+	qreal Deviation() const;	/// Sample standard deviation
+	qreal Min() const;			/// Minimal sample
+	qreal Max() const;			/// Maximal sample
+
+	/** Format main statistics in human readable form
+	  @param unit unit appended to values
+	  @return mean, deviation, min and max or "no data" **/
+	QString Summary(QString unit) const;
+
+	void erase();	/// Erase all samples
+
+private:
+	hddsize count;
+	qreal mean;
+	qreal m2;		// sum of squared differences from mean
+	qreal min;
+	qreal max;
+};
@@ -19,21 +19,47 @@
 ********************************************************************************/
 
 #include "testthread.h"
-#include "testwidget.h"
+#include "benchmark.h"
 
-TestThread::TestThread(TestWidget *widget) :
-	QThread(widget) {
-	this->widget = widget;
+TestThread::TestThread(Benchmark *benchmark) :
+	QThread(benchmark) {
+	this->benchmark = benchmark;
 }
 
 void TestThread::run() {
+	// select access mode requested by benchmark
+	benchmark->device->SetDirect(benchmark->directIO);
+	benchmark->device->SetPattern(benchmark->pattern);
+
+	// stamp written blocks in verify mode
+	benchmark->verifier.erase();
+	benchmark->device->SetVerifier(benchmark->verify?&benchmark->verifier:NULL);
+
 	// prepare device for test
-	widget->device->Warmup();
-	widget->device->DropCaches();
-	widget->device->Sync();
+	benchmark->device->Warmup();
+	benchmark->device->DropCaches();
+	benchmark->device->Sync();
+
+	// sample operations of device, its clones and files on time grid
+	benchmark->device->timer.SetCounters(&benchmark->counters);
+	benchmark->sampler.Start(benchmark->device->path);
 
 	// run test
     emit test_started();
-	widget->TestLoop();
+	benchmark->TestLoop();
+
+	// stop recording latencies to benchmark histograms and counters
+	benchmark->sampler.Stop();
+	benchmark->device->timer.SetHistogram(NULL);
+	benchmark->device->timer.SetCounters(NULL);
+
+	// read back blocks written to device and not read by benchmark
+	benchmark->device->VerifyWritten();
+	benchmark->device->SetVerifier(NULL);
+
+	// return device to read only cached access and free benchmark buffer
+	benchmark->device->SetWritable(false);
+	benchmark->device->SetDirect(false);
+	benchmark->device->ReleaseBuffer();
     emit test_stopped();
 }
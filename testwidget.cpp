@@ -23,22 +23,21 @@
 #include "testwidget.h"
 #include "ui_testwidget.h"
 
-// TestThread holds pointer to TestWidget and vice versa
-// so extra including in cpp file is needed
-#include "testthread.h"
-
-TestWidget::TestWidget(QWidget *parent) :
-	QWidget(parent), ui(new Ui::TestWidget) {
+TestWidget::TestWidget(Benchmark *benchmark, QWidget *parent) :
+	QWidget(parent), benchmark(benchmark), ui(new Ui::TestWidget) {
     ui->setupUi(this);
 
-	device = NULL;
-
-	test_thread = new TestThread(this);
-	testState = STOPPED;
-
 	connect(&refresh_timer, SIGNAL(timeout()), this, SLOT(refresh_timer_timeout()));
-	connect(test_thread, SIGNAL(test_started()), this, SLOT(test_started()));
-	connect(test_thread, SIGNAL(test_stopped()), this, SLOT(test_stopped()));
+	connect(benchmark, SIGNAL(started()), this, SLOT(test_started()));
+	connect(benchmark, SIGNAL(stopped()), this, SLOT(test_stopped()));
+
+	// offer modes of benchmark, do not report mode change while widget is constructed
+	QStringList modes = benchmark->GetModes();
+	ui->mode->blockSignals(true);
+	ui->mode->addItems(modes);
+	ui->mode->setCurrentIndex(benchmark->mode);
+	ui->mode->blockSignals(false);
+	ui->mode->setVisible(!modes.isEmpty());
 
 	Yscale = 1;
 
@@ -59,23 +58,23 @@ TestWidget::~TestWidget() {
 	delete scene;
 
     delete ui;
-	delete test_thread;
+	delete benchmark;
 }
 
 void TestWidget::SetDevice(Device *device) {
-	this->device = device;
+	benchmark->SetDevice(device);
 }
 
 void TestWidget::refresh_timer_timeout() {
-	int progress = GetProgress();
+	int progress = benchmark->GetProgress();
 	ui->progress->setValue(progress);
 	UpdateScene();
 }
 
 void TestWidget::on_startstop_clicked() {
-	if(testState == STOPPED) {
+	if(benchmark->testState == Benchmark::STOPPED) {
 		StartTest();
-	} else if(testState == STARTED) {
+	} else if(benchmark->testState == Benchmark::STARTED) {
 		StopTest();
 	} else {
 		std::cerr << "Start/stop test clicked but should be disabled" << std::endl;
@@ -83,23 +82,69 @@ void TestWidget::on_startstop_clicked() {
 }
 
 void TestWidget::StartTest() {
-	if(!device) {
+	if(!benchmark->device) {
 		std::cerr << "WARNING: Start test without valid device pointer - ignoring" << std::endl;
 		return;
 	}
 
+	// writing benchmarks need explicit permission
+	if(benchmark->destructive && !ConfirmDestructive()) {
+		return;
+	}
+
 	// prepare ui for test
-	testState = STARTING;
 	ui->startstop->setText("Starting");
 	ui->startstop->setEnabled(false);
+	ui->direct->setEnabled(false);
+	ui->mode->setEnabled(false);
 	InitScene();
 
 	// start test in another thread
-	test_thread->start();
+	benchmark->StartTest();
+}
+
+bool TestWidget::ConfirmDestructive() {
+	Device *device = benchmark->device;
+	QString testName = benchmark->testName;
+
+	// never write to device with mounted filesystem
+	if(device->IsMounted()) {
+		QMessageBox box;
+		box.setIcon(QMessageBox::Critical);
+		box.setText(testName + " cannot be run on " + device->path + ".");
+		box.setInformativeText("The device or some of its partitions is mounted or used by the system." +
+				QString(" Unmount it before running write benchmarks."));
+		box.exec();
+		return false;
+	}
+
+	// ask user to confirm data loss
+	QMessageBox box;
+	box.setIcon(QMessageBox::Warning);
+	box.setText(testName + " overwrites data on " + device->path +
+			" (" + device->model + ", " + Def::FormatSize(device->size) + ").");
+	box.setInformativeText("All data on the device will be destroyed. Do you want to continue?");
+	box.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+	box.setDefaultButton(QMessageBox::No);
+	if(box.exec() != QMessageBox::Yes) {
+		return false;
+	}
+
+	// exclusive open fails when device was mounted meanwhile
+	if(!device->SetWritable(true)) {
+		QMessageBox error;
+		error.setIcon(QMessageBox::Critical);
+		error.setText("Cannot open " + device->path + " for exclusive writing.");
+		error.setInformativeText("Check the device is not used and you have permission to write it.");
+		error.exec();
+		return false;
+	}
+
+	return true;
 }
 
 void TestWidget::StopTest() {
-	testState = STOPPING;
+	benchmark->StopTest();
 	ui->startstop->setText("Stopping");
 	ui->startstop->setEnabled(false);
 }
@@ -108,7 +153,6 @@ void TestWidget::test_started() {
 	// start ui refresh
 	refresh_timer.start(100);
 
-	testState = STARTED;
 	ui->startstop->setText("Stop");
 	ui->startstop->setEnabled(true);
 }
@@ -118,20 +162,53 @@ void TestWidget::test_stopped() {
 	refresh_timer_timeout();
 	refresh_timer.stop();
 
-	testState = STOPPED;
 	ui->startstop->setText("Start");
 	ui->startstop->setEnabled(true);
+	ui->direct->setEnabled(true);
+	ui->mode->setEnabled(true);
 }
 
 void TestWidget::SetStartEnabled(bool enabled) {
 	ui->startstop->setEnabled(enabled);
 }
 
+void TestWidget::SetDirectIOVisible(bool visible) {
+	ui->direct->setVisible(visible);
+}
+
+void TestWidget::on_direct_toggled(bool checked) {
+	benchmark->directIO = checked;
+}
+
+void TestWidget::on_mode_currentIndexChanged(int index) {
+	benchmark->SetMode(index);
+	UpdateScene();
+	Rescale(true);
+}
+
+void TestWidget::EraseResults(Benchmark::DataSet dataset) {
+	benchmark->EraseResults(dataset);
+
+	// refresh view
+	UpdateScene();
+}
+
+void TestWidget::RestoreResults(const ResultElement &root, Benchmark::DataSet dataset) {
+	benchmark->RestoreResults(root, dataset);
+
+	// refresh view
+	UpdateScene();
+}
+
+void TestWidget::WriteResults(ResultWriter &writer) {
+	benchmark->WriteResults(writer);
+}
+
 void TestWidget::on_info_clicked() {
 	// Show test description
 	QMessageBox box;
-	box.setText(testName);
-	box.setInformativeText(testDescription);
+	box.setText(benchmark->testName);
+	box.setInformativeText(benchmark->testDescription);
 	box.exec();
 }
 
@@ -152,6 +229,8 @@ void TestWidget::Rescale(bool force) {
 	qreal max = 0.0f;
 	qreal min = 0.0f;
 	for(int i = 0; i < markers.size(); ++i) {
+		if(!markers[i]->visible)
+			continue;
 		if(markers[i]->max > max)
 			max = markers[i]->max;
 		if(markers[i]->min < min)
@@ -175,6 +254,16 @@ void TestWidget::Rescale(bool force) {
 	scene->update();
 }
 
+const Histogram& TestWidget::Settled(const Histogram &histogram, Benchmark::DataSet dataset) {
+	// benchmark thread adds to results until it stops, percentiles are drawn after that
+	static const Histogram empty;
+	if((dataset == Benchmark::RESULTS) && (benchmark->testState != Benchmark::STOPPED)) {
+		return empty;
+	}
+
+	return histogram;
+}
+
 void TestWidget::resizeEvent(QResizeEvent*) {
 	// resize scene to new window dimensions
 	QRect rect = ui->graph->rect();
@@ -196,12 +285,40 @@ void TestWidget::resizeEvent(QResizeEvent*) {
 ///////////////////////////////////////////////////////////////////////////////
 
 TestWidget::Marker::Marker(TestWidget *test):
-	max(0.0f), min(0.0f) {
+	max(0.0f), min(0.0f), visible(true) {
 	this->test = test;
 }
 
 TestWidget::Marker::~Marker() {}
 
+void TestWidget::Marker::SetVisible(bool visible) {
+	this->visible = visible;
+}
+
+void TestWidget::Marker::Paint(QPainter*) {}
+
+TestWidget::PlotItem::PlotItem(Marker *marker):
+	marker(marker) {
+	// keep data above net and below value lines
+	setZValue(50);
+}
+
+void TestWidget::PlotItem::SetRect(QRectF rect) {
+	if(rect != this->rect) {
+		prepareGeometryChange();
+		this->rect = rect;
+	}
+	update();
+}
+
+QRectF TestWidget::PlotItem::boundingRect() const {
+	return rect;
+}
+
+void TestWidget::PlotItem::paint(QPainter *painter, const QStyleOptionGraphicsItem*, QWidget*) {
+	marker->Paint(painter);
+}
+
 TestWidget::Line* TestWidget::addLine(QString unit, QString name, QColor color) {
 	Line * line = new Line(this, unit, name, color);
 	markers.push_back(line);
@@ -209,6 +326,13 @@ TestWidget::Line* TestWidget::addLine(QString unit, QString name, QColor color)
 	return line;
 }
 
+TestWidget::Percentiles* TestWidget::addPercentiles(QString unit, QColor color, bool speed) {
+	Percentiles *percentiles = new Percentiles(this, unit, color, speed);
+	markers.push_back(percentiles);
+
+	return percentiles;
+}
+
 TestWidget::Ticks* TestWidget::addTicks(QColor color) {
 	Ticks *ticks = new Ticks(this, color);
 	markers.push_back(ticks);
@@ -304,13 +428,58 @@ void TestWidget::Line::Reposition() {
 	SetValue(value);
 }
 
+TestWidget::Percentiles::Percentiles(TestWidget *test, QString unit, QColor color, bool speed):
+	Marker(test), speed(speed) {
+	// the slowest operation has the lowest speed
+	lines.push_back(new Line(test, unit, "p50", color));
+	lines.push_back(new Line(test, unit, "p99", color));
+	lines.push_back(new Line(test, unit, "p99.9", color));
+	lines.push_back(new Line(test, unit, speed?"worst":"max", color));
+}
+
+TestWidget::Percentiles::~Percentiles() {
+	for(int i = 0; i < lines.size(); ++i) {
+		delete lines[i];
+	}
+}
+
+void TestWidget::Percentiles::Set(const Histogram &histogram, qreal scale) {
+	hddtime values[] = {
+		histogram.Percentile(50),
+		histogram.Percentile(99),
+		histogram.Percentile(99.9),
+		histogram.Max() };
+
+	// update lines and min and max for percentiles
+	max = min = 0;
+	for(int i = 0; i < lines.size(); ++i) {
+		qreal value = 0;
+		if(values[i] > 0) {
+			value = speed?scale / values[i]:values[i] / scale;
+		}
+		lines[i]->SetValue(value);
+
+		// worst case may be far off, do not scale graph to it
+		if(i < lines.size() - 1) {
+			max = qMax(max, value);
+		}
+	}
+}
+
+void TestWidget::Percentiles::Reposition() {
+	for(int i = 0; i < lines.size(); ++i) {
+		lines[i]->Reposition();
+	}
+}
+
 TestWidget::Ticks::Ticks(TestWidget *test, QColor color):
-	 Marker(test), color(color) {}
+	 Marker(test), color(color) {
+	item = new PlotItem(this);
+	test->scene->addItem(item);
+}
 
 TestWidget::Ticks::~Ticks() {
-	for(int i = 0; i < ticks.size(); ++i) {
-		delete ticks[i].tick;
-	}
+	delete item;
 }
 
 void TestWidget::Ticks::AddTick(qreal value, qreal position, bool important) {
@@ -326,37 +495,60 @@ void TestWidget::Ticks::AddTick(qreal value, qreal position, bool important) {
 
 	// add tick
 	Tick tick;
-
-	tick.tick = test->scene->addRect(
-			test->graph.left() + position *  test->graph.width() * NET_WIDTH,
-			test->graph.top() + test->graph.height() - value * test->Yscale,
-			1,
-			1,
-			QPen(color));
 	tick.position = position;
 	tick.value = value;
+	ticks.push_back(tick);
 
-	ticks.push_back(tick);	
+	// draw tick, ticks added before image is created are drawn by first reposition
+	if(!image.isNull()) {
+		Draw(tick);
+		item->update();
+	}
 }
 
 void TestWidget::Ticks::Reposition() {
-	// reposition ticks
+	// image covers whole scene, so ticks out of graph area are shown too
+	rect = test->scene->sceneRect();
+	QSize size = rect.size().toSize();
+	if(image.size() != size) {
+		image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+	}
+	image.fill(Qt::transparent);
+
+	// redraw ticks at new scale
 	for(int i = 0; i < ticks.size(); ++i) {
-		ticks[i].tick->setRect(
-					test->graph.left() + ticks[i].position *  test->graph.width() * NET_WIDTH,
-					test->graph.top() + test->graph.height() - ticks[i].value * test->Yscale,
-					1,
-					1);
+		Draw(ticks[i]);
 	}
+
+	item->SetRect(rect);
+}
+
+void TestWidget::Ticks::Draw(const Tick &tick) {
+	int x = test->graph.left() + tick.position * test->graph.width() * NET_WIDTH - rect.left();
+	int y = test->graph.top() + test->graph.height() - tick.value * test->Yscale - rect.top();
+
+	// tick is 2x2 pixels square
+	QRgb rgb = qPremultiply(color.rgba());
+	for(int dx = 0; dx < 2; ++dx) {
+		for(int dy = 0; dy < 2; ++dy) {
+			if(image.valid(x + dx, y + dy)) {
+				image.setPixel(x + dx, y + dy, rgb);
+			}
+		}
+	}
+}
+
+void TestWidget::Ticks::Paint(QPainter *painter) {
+	painter->drawImage(rect.topLeft(), image);
 }
 
 void TestWidget::Ticks::erase() {
 	// erase all ticks
-	for(int i = 0; i < ticks.size(); ++i) {
-		test->scene->removeItem(ticks[i].tick);
-		delete ticks[i].tick;
-	}
 	ticks.clear();
+	if(!image.isNull()) {
+		image.fill(Qt::transparent);
+	}
+	item->update();
 
 	// reset min and max
 	min = max = 0.0f;
@@ -405,6 +597,11 @@ void TestWidget::Bar::Set(qreal progress, qreal value) {
 		inner_rect = test->scene->addRect(0, 0, 0, 0, QPen(Qt::NoPen), QBrush(color.darker(70)));
 	}
 
+	// hide items of hidden bar
+	rect->setVisible(visible);
+	inner_rect->setVisible(visible);
+	name_text->setVisible(visible);
+
 	// set items positions
 	int W = test->graph.width() * width;
 	int H = value * test->Yscale;
@@ -413,7 +610,7 @@ void TestWidget::Bar::Set(qreal progress, qreal value) {
 
 	// set items data
 	value_text->setPlainText(QString::number(value, 'f', 2) + " " + unit);
-	value_text->setVisible(progress > 0);
+	value_text->setVisible(visible && (progress > 0));
 
 	//// set positions
 	rect->setRect(X, Y, W, H);
@@ -428,6 +625,19 @@ void TestWidget::Bar::Set(qreal progress, qreal value) {
 			test->graph.top() + test->graph.height() - name_text->boundingRect().height());
 }
 
+void TestWidget::Bar::SetName(QString name) {
+	this->name = name;
+	if(name_text != NULL) {
+		name_text->setPlainText(name);
+	}
+	Set(progress, value);
+}
+
+void TestWidget::Bar::SetVisible(bool visible) {
+	Marker::SetVisible(visible);
+	Set(progress, value);
+}
+
 void TestWidget::Bar::Reposition() {
 	Set(progress, value);
 }
@@ -436,20 +646,25 @@ TestWidget::LineGraph::LineGraph(TestWidget *test, QString unit, QColor color):
 	 Marker(test), unit(unit), color(color) {
 	// set to something else than 0 should be changed by test before first use
 	size = 10;
+
+	item = new PlotItem(this);
+	test->scene->addItem(item);
 }
 
 TestWidget::LineGraph::~LineGraph() {
-	for(int i = 0; i < lines.size(); ++i) {
-		delete lines[i];
-	}
+	delete item;
 }
 
 void TestWidget::LineGraph::SetSize(int count) {
-	size = count;
-	Reposition();
+	// positions of values spread evenly depend on count
+	if(count != size) {
+		size = count;
+		Rebuild();
+		item->update();
+	}
 }
 
-void TestWidget::LineGraph::AddValue(qreal value) {
+void TestWidget::LineGraph::AddValue(qreal value, qreal position) {
 	// update max and min for linegraph
 	if(value > max) {
 		max = value;
@@ -458,42 +673,100 @@ void TestWidget::LineGraph::AddValue(qreal value) {
 		min = value;
 	}
 
-	// add new line
+	// add new value to its column
 	values.push_back(value);
+	positions.push_back(position);
 
-	if(values.size() > 1) {
-		QPen pen(color);
-		pen.setWidth(2);
-		pen.setCapStyle(Qt::RoundCap);
-		pen.setJoinStyle(Qt::RoundJoin);
-		lines.push_back(test->scene->addLine(0, 0, 0, 0, pen));
-		Reposition();
+	if(!columns.empty()) {
+		Insert(values.size() - 1);
+		item->update();
 	}
 }
 
 void TestWidget::LineGraph::erase() {
-	for(int i = 0; i < lines.size(); ++i) {
-		test->scene->removeItem(lines[i]);
-		delete lines[i];
-	}
-
-	lines.clear();
 	values.clear();
+	positions.clear();
 
 	size = 10;
+	Rebuild();
+	item->update();
 
 	// reset min and max
 	min = max = 0.0f;
 }
 
 void TestWidget::LineGraph::Reposition() {
-	// reposition lines
-	for(int i = 0; i < lines.size(); ++i) {
-		lines[i]->setLine(
-				test->graph.left() + (qreal)i  / (size - 1) * test->graph.width() * NET_WIDTH,
-				test->graph.top() + test->graph.height() - values[i] * test->Yscale,
-				test->graph.left() + (qreal)(i + 1)  / (size - 1) * test->graph.width() * NET_WIDTH,
-				test->graph.top() + test->graph.height() - values[i + 1] * test->Yscale);
+	// columns depend on graph width only, vertical scale is applied by Paint
+	if(columns.size() != (int)(test->graph.width() * NET_WIDTH) + 1) {
+		Rebuild();
+	}
+
+	item->SetRect(test->scene->sceneRect());
+}
+
+void TestWidget::LineGraph::Paint(QPainter *painter) {
+	QPen pen(color);
+	pen.setWidth(2);
+	pen.setCapStyle(Qt::RoundCap);
+	pen.setJoinStyle(Qt::RoundJoin);
+	painter->setPen(pen);
+
+	qreal left = test->graph.left();
+	qreal bottom = test->graph.top() + test->graph.height();
+
+	// vertical line shows value range of column, columns are connected
+	QVector<QLineF> lines;
+	lines.reserve(2 * columns.size());
+	int previous = -1;
+	for(int i = 0; i < columns.size(); ++i) {
+		const Column &column = columns[i];
+		if(!column.used) {
+			continue;
+		}
+
+		if(previous >= 0) {
+			lines.push_back(QLineF(
+					left + previous, bottom - columns[previous].last * test->Yscale,
+					left + i, bottom - column.first * test->Yscale));
+		}
+		lines.push_back(QLineF(
+				left + i, bottom - column.min * test->Yscale,
+				left + i, bottom - column.max * test->Yscale));
+		previous = i;
+	}
+
+	painter->drawLines(lines);
+}
+
+int TestWidget::LineGraph::ColumnOf(int index) {
+	// values without position are spread evenly
+	qreal position = positions[index];
+	if(position < 0) {
+		position = (qreal)index / qMax(size - 1, 1);
+	}
+
+	return qBound(0, (int)(position * (columns.size() - 1)), columns.size() - 1);
+}
+
+void TestWidget::LineGraph::Insert(int index) {
+	Column &column = columns[ColumnOf(index)];
+	qreal value = values[index];
+
+	if(!column.used) {
+		column.min = column.max = column.first = value;
+		column.used = true;
+	}
+	column.min = qMin(column.min, value);
+	column.max = qMax(column.max, value);
+	column.last = value;
+}
+
+void TestWidget::LineGraph::Rebuild() {
+	Column empty = {0, 0, 0, 0, false};
+	columns.fill(empty, (int)(test->graph.width() * NET_WIDTH) + 1);
+
+	for(int i = 0; i < values.size(); ++i) {
+		Insert(i);
 	}
 }
 
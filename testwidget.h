@@ -30,25 +30,26 @@
 #include <QGraphicsRectItem>
 #include <QGraphicsTextItem>
 #include <QFileDialog>
+#include <QMessageBox>
+#include <QImage>
+#include <QPainter>
 
-#include "device.h"
-
-// Forward declaration od TestThread class
-class TestThread;
+#include "benchmark.h"
 
 namespace Ui {
     class TestWidget;
 }
 
-/// Base for all benchmarks - common function and untilities
-/** The TestWidget class is base for all specialized benchmark classes.
-It handles widget callbacks, graph drawing and benchmark process itself.
+/// Base for all benchmark widgets - common function and untilities
+/** The TestWidget class is base for all benchmark widgets. Every widget
+owns one Benchmark which measures and keeps results, the widget only shows them.
+It handles widget callbacks and graph drawing.
 It provides several methods for displaying markers and graph parts.
-The benchmarks specific classes should use only these methods provided by
+The benchmark widget classes should use only these methods provided by
 TestWidget class to build their graphs. When graph component is created
 this way the ThetWidget class deinitializes it corectly in its destructor.
-The benchmark classes are intended to extend this class and implement
-pure virtual methods to provide benchmark specific functionality.
+The benchmark widget classes are intended to extend this class and implement
+pure virtual methods to draw benchmark specific graphs.
 This class handles benchmark starting/stopping and peridical refreshing
 the graph by calling UpdateScene method implemented in benchmark specific class.
 The TestWidget class handles GUI parts as Progress bar, start/stop button,
@@ -57,9 +58,6 @@ class TestWidget : public QWidget {
     Q_OBJECT
 
 public:
-	enum DataSet { RESULTS, REFERENCE };
-	enum TestState { STARTING, STARTED, STOPPING, STOPPED };
-
 	//////////////////////////////////////////////////////////////////////////////
 	//// Test markers
 	//////////////////////////////////////////////////////////////////////////////
@@ -83,14 +81,46 @@ public:
 		TestWidget *test;				/// pointer to test containing this marker
 		qreal max;						/// maximal value used by this marker
 		qreal min;						/// minimal value used by this marker
+		bool visible;					/// hidden markers are not used for scaling
 		virtual void Reposition() = 0;	/// reposition marker on view change
+
+		/** Show or hide marker
+		  @param visible whenever the marker is shown **/
+		virtual void SetVisible(bool visible);
+
+		/** Paint marker data, called by PlotItem owned by the marker
+		  @param painter painter in scene coordinates **/
+		virtual void Paint(QPainter *painter);
+	};
+
+	/// Graphics item painted by marker
+	/** PlotItem is single scene item used by markers with many samples.
+	Instead of one scene item per sample the marker keeps samples in flat
+	arrays and paints their decimated form in one Paint call, so scene cost
+	does not grow with sample count.**/
+	class PlotItem : public QGraphicsItem {
+	public:
+		PlotItem(Marker *marker);
+
+		/** Set area painted by marker
+		  @param rect area in scene coordinates **/
+		void SetRect(QRectF rect);
+
+		QRectF boundingRect() const;
+		void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+	private:
+		Marker *marker;
+		QRectF rect;
 	};
 
 	/// Dot graph
 	/** Ticks class extends Marker class and provides dot graph which is used
 	by Seek benchmark. The graph contains dots that can be added by AddTick method
 	one by one. Dots are used to display discrete values in 2D graph.
-	All dost can be erased by erase method.**/
+	All dost can be erased by erase method. Dots are drawn to image of scene
+	size, so adding dot and painting do not depend on count of dots. The image
+	is redrawn from stored dots only when scale changes.**/
 	class Ticks : public Marker {
 	public:
 		Ticks(TestWidget *test, QColor color);
@@ -103,16 +133,21 @@ public:
 
 		void erase();		/// Erases all ticks in graph
 		void Reposition();	/// Resposition ticks according to new scale
+		void Paint(QPainter *painter);	/// Paint ticks image
 
 	private:
 		struct Tick {
 			qreal value;
 			qreal position;
-			QGraphicsRectItem *tick;
 		};
 
+		void Draw(const Tick &tick);	// draw tick to image
+
 		QColor color;
-		QList<Tick> ticks;
+		QVector<Tick> ticks;
+		QImage image;		// ticks drawn in scene coordinates
+		QRectF rect;		// scene area covered by image
+		PlotItem *item;
 	};
 
 	/// Horizontal line marker
@@ -138,6 +173,28 @@ public:
 		qreal value;
 	};
 
+	/// Percentile lines marker
+	/** Percentiles class groups horizontal lines showing p50, p99, p99.9
+	and maximum of latency histogram. Latency can be shown as time or
+	converted to speed of operations of known size. In the second case
+	the slowest operation is shown as the worst speed.**/
+	class Percentiles : public Marker {
+	public:
+		Percentiles(TestWidget *test, QString unit, QColor color, bool speed);
+		~Percentiles();
+
+		/** Set lines from histogram
+		  @param histogram latency histogram
+		  @param scale time unit for time lines or operation size for speed lines **/
+		void Set(const Histogram &histogram, qreal scale);
+
+		void Reposition();	/// Reposition lines to new scale
+
+	private:
+		bool speed;
+		QList<Line*> lines;
+	};
+
 	/// Bar marker
 	/** Bar class implements simple bar in graph.
 	The progress and value can be set for the graph.
@@ -155,6 +212,11 @@ public:
 		  @param value new value **/
 		void Set(qreal progress, qreal value);
 
+		/** Set new label at the bar bottom
+		  @param name new label **/
+		void SetName(QString name);
+
+		void SetVisible(bool visible);	/// Show or hide bar
 		void Reposition();	/// Reposition bar according to new scale
 
 	private:
@@ -171,7 +233,10 @@ public:
 	Parts of polyline can be added one by one. The whole graph
 	can be erased to initial empty state. A count of line segments
 	in the whole graph needs to be set in order to display polyline
-	in the correct width. **/
+	in the correct width. Values are kept in flat arrays and reduced to minimum,
+	maximum, first and last value of every pixel column of graph, so painting
+	cost depends on graph width only. Columns are rebuilt from values only
+	when graph width or value count changes.**/
 	class LineGraph : public Marker {
 	public:
 		LineGraph(TestWidget *test, QString unit, QColor color);
@@ -182,18 +247,33 @@ public:
 		void SetSize(int count);
 
 		/** Add new value to graph
-		  @param value to be added **/
-		void AddValue(qreal value);
+		  @param value to be added
+		  @param position horizontal position in range from 0 to 1,
+		  values without position are spread evenly according to count set by SetSize **/
+		void AddValue(qreal value, qreal position = -1);
 
 		void Reposition();			/// Repositions lines in screen acording to new scale and count
 		void erase();				/// Erase all data in graph
+		void Paint(QPainter *painter);	/// Paint decimated polyline
 
 	private:
+		struct Column {
+			qreal min, max;		// value range in column
+			qreal first, last;	// values connected to neighbouring columns
+			bool used;
+		};
+
+		int ColumnOf(int index);	// pixel column of value
+		void Insert(int index);		// add value to its column
+		void Rebuild();				// recalculate all columns
+
 		int size;
 		QString unit;
 		QColor color;
-		QList<QGraphicsLineItem*> lines;
-		QList<qreal> values;
+		QVector<qreal> values;
+		QVector<qreal> positions;
+		QVector<Column> columns;
+		PlotItem *item;
 	};
 
 	/// Net with measure graph
@@ -244,8 +324,9 @@ public:
 	//// TestWidget class methods ///////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////
 
-	/** TestWidget constructor. Called by Qt when GUI is initialized. **/
-	explicit TestWidget(QWidget *parent = 0);
+	/** TestWidget constructor. Called by benchmark widget constructed by Qt when GUI is initialized.
+	  @param benchmark benchmark shown by widget, widget takes its ownership **/
+	explicit TestWidget(Benchmark *benchmark, QWidget *parent = 0);
 	~TestWidget();
 
 	/** Set pointer to device class when new device is selected in GUI.
@@ -256,43 +337,35 @@ public:
 	  @param enabled whenever the benchmarks is enabled **/
 	void SetStartEnabled(bool enabled);
 
-	void StartTest();	/// Starts the benchmark
-	void StopTest();	/// Cancels benchmark
+	/** Set whenever the direct I/O switch is offered for the benchmark.
+	  Only benchmarks accessing raw device should enable it.
+	  @param visible whenever the switch is shown **/
+	void SetDirectIOVisible(bool visible);
 
-	// test specific functions
-	/** Benchmarking code run in separate thread.
-	This method is implemntd by benchmark specific class. **/
-	virtual void TestLoop() = 0;
+	void StartTest();	/// Starts the benchmark, destructive benchmark asks for confirmation
+	void StopTest();	/// Cancels benchmark
 
+	// widget specific functions
 	/** Code to initialze graph before benchmark starts supplied by
-	benchmarking class. Maybe this will not be needed as benchmarks can initialize
+	benchmark widget class. Maybe this will not be needed as widgets can initialize
 	this in their constructors. **/
 	virtual void InitScene() = 0;
 
-	/** Method implementd by benchmarking class. Called when graph needs refresh.**/
+	/** Method implementd by benchmark widget class. Called when graph needs refresh.**/
 	virtual void UpdateScene() = 0;
 
-	/** Reports test progress in range from 0 to 100.
-	This is implemented by benchmark class. The return value is used to
-	update progress bar below the graph.**/
-	virtual int GetProgress() = 0;
-
-	/** This method is implemented by benchmark specific class.
-	It should erase reference or measured resutls.
-	  @param dataset which resutls should be erased
-	  @see DataSet **/
-	virtual void EraseResults(DataSet dataset) = 0;
+	/** Erases reference or measured results of benchmark and refreshes graph.
+	  @param dataset which resutls should be erased **/
+	virtual void EraseResults(Benchmark::DataSet dataset);
 
-	/** This method is called when resutls should be saved.
-	 The class extending TestWidget should supply code neede to save resutls.
-	 @param doc QDomDocument to which results should be saved. **/
-	virtual QDomElement WriteResults(QDomDocument &doc) = 0;
-
-	/** Method implemented by benchmark specific class. It should load results from
-	XML element.
+	/** Loads results of benchmark from result file element and refreshes graph.
 	 @param root resutls root element
 	 @param dataset which results are to be replace **/
-	virtual void RestoreResults(QDomElement &root, DataSet dataset) = 0;
+	virtual void RestoreResults(const ResultElement &root, Benchmark::DataSet dataset);
+
+	/** Saves results of benchmark.
+	 @param writer ResultWriter to which results should be saved. **/
+	void WriteResults(ResultWriter &writer);
 
 	// Marker adding functions
 	/** Adds line marker
@@ -302,6 +375,13 @@ public:
 	  @return pointer to line marker used to update it **/
 	Line* addLine(QString unit, QString name, QColor color);
 
+	/** Adds percentile lines marker
+	  @param unit units to be displayed
+	  @param color lines and values colour
+	  @param speed whenever latencies are shown as speed
+	  @return pointer to marker used to update it **/
+	Percentiles* addPercentiles(QString unit, QColor color, bool speed = false);
+
 	/** Add ticks marker to graph
 	  @param color colour of the ticks
 	  @return pointer to the resulting marker **/
@@ -335,25 +415,27 @@ public:
 	  @param force rescales even when all values can still be displayed **/
 	void Rescale(bool force = false);
 
-	Device *device;				/// Pointer to device selecte dfor testing in GUI
+	/** Gets histogram safe to be read by graph
+	  @param histogram latencies of results or reference
+	  @param dataset which results histogram belongs to
+	  @return histogram itself or empty one while running benchmark records results to it **/
+	const Histogram& Settled(const Histogram &histogram, Benchmark::DataSet dataset);
+
+	Benchmark *benchmark;		/// Benchmark shown by widget
 	QGraphicsScene *scene;		/// Pointer to current grephics scene
 
 	qreal Yscale;				/// Y axis multipiler
 	QRect graph;				/// Rect in graphics scene occupied by graph
 
-	QString testName;			/// Test name
-	QString testDescription;	/// Test description - used by info box
-
-	TestState testState;		/// Current test state
-
 protected:
 	 void resizeEvent(QResizeEvent*); /// Rescales graph on resize event
 
 private:
+	bool ConfirmDestructive();	// checks device is not used and asks user to confirm data loss
+
 	Ui::TestWidget *ui;
 
 	QTimer refresh_timer;
-	TestThread *test_thread;
 	QList<Marker*> markers;		// List of markers used in scene
 
 private slots:
@@ -361,6 +443,8 @@ private slots:
 	void on_startstop_clicked();
 	void on_info_clicked();
 	void on_image_clicked();
+	void on_direct_toggled(bool checked);
+	void on_mode_currentIndexChanged(int index);
 	void test_started();
 	void test_stopped();
 };
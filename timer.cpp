@@ -21,23 +21,50 @@
 #include "timer.h"
 
 Timer::Timer():
-	start(timeval()), end(timeval()) {}
+	start(0), end(0), histogram(NULL), counters(NULL) {}
+
+hddtime Timer::Now() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	return now.tv_sec * s + now.tv_nsec * ns;
+}
 
 void Timer::MarkStart() {
-	gettimeofday(&start, 0);
+	start = Now();
 }
 
-void Timer::MarkEnd() {
-	gettimeofday(&end, 0);
+void Timer::MarkEnd(hddsize bytes) {
+	end = Now();
+
+	if(histogram != NULL) {
+		histogram->Add(GetFinalOffset());
+	}
+	if(counters != NULL) {
+		counters->Add(GetFinalOffset(), bytes);
+	}
+}
+
+void Timer::SetHistogram(Histogram *histogram) {
+	this->histogram = histogram;
+}
+
+Histogram* Timer::GetHistogram() {
+	return histogram;
+}
+
+void Timer::SetCounters(Counters *counters) {
+	this->counters = counters;
+}
+
+Counters* Timer::GetCounters() {
+	return counters;
 }
 
 hddtime Timer::GetFinalOffset() {
-	return (end.tv_sec * s + end.tv_usec * us) - (start.tv_sec * s + start.tv_usec * us);
+	return end - start;
 }
 
 hddtime Timer::GetCurrentOffset() {
-	timeval now;
-	gettimeofday(&now, 0);
-
-	return (now.tv_sec * s + now.tv_usec * us) - (start.tv_sec * s + start.tv_usec * us);
+	return Now() - start;
 }
@@ -20,21 +20,30 @@
 
 #pragma once
 
-#include <sys/time.h>
+#include <time.h>
 
 #include "definitions.h"
+#include "histogram.h"
+#include "sampler.h"
 
 using namespace HDDTest;
 
 /// Class implementing software stopwatch
 /** The Timer class works like stopwatch.
-  The start and stop position can be marked. **/
+  The start and stop position can be marked.
+  Time is read from raw monotonic clock with nanosecond resolution,
+  so it is not affected by NTP adjustments of system time.
+  Every measured interval can be recorded to histogram and added to
+  counters sampled over time. **/
 class Timer {
 public:
 	Timer();	/// The Timer constuctor
 
 	void MarkStart();	/// Marks start time
-	void MarkEnd();		/// Marks end time
+
+	/** Marks end time
+	  @param bytes bytes transferred by measured operation **/
+	void MarkEnd(hddsize bytes = 0);
 
 	/** Gets time difference between start and stop time
 	  @return the difference is returned as hddtime
@@ -46,7 +55,23 @@ public:
 	  @see definitions.h for time constants **/
 	hddtime GetCurrentOffset();
 
+	/** Sets histogram receiving every interval measured by MarkEnd
+	  @param histogram target histogram, NULL stops recording **/
+	void SetHistogram(Histogram *histogram);
+
+	Histogram* GetHistogram();	/// Gets histogram receiving measured intervals
+
+	/** Sets counters receiving every operation measured by MarkEnd
+	  @param counters target counters, NULL stops counting **/
+	void SetCounters(Counters *counters);
+
+	Counters* GetCounters();	/// Gets counters receiving measured operations
+
 private:
-	timeval start;
-	timeval end;
+	static hddtime Now();	// current raw monotonic time
+
+	hddtime start;
+	hddtime end;
+	Histogram *histogram;
+	Counters *counters;
 };
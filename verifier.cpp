@@ -0,0 +1,362 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "verifier.h"
+#include "resultfile.h"
+#include "resultwriter.h"
+#include "timer.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <QVector>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+/// Stamp at the beginning of every block
+struct Header {
+	quint64 offset;		// block position
+	quint64 sequence;	// sequence number of write
+	quint32 crc;		// checksum of block without this field
+	quint32 magic;		// marks stamped block
+};
+
+/// Computes CRC32C by table
+static quint32 CRC32CSoftware(quint32 crc, const uchar *data, hddsize size) {
+	// reflected Castagnoli polynomial table, built once
+	static const QVector<quint32> table = [] {
+		QVector<quint32> values(256);
+		for(quint32 i = 0; i < 256; ++i) {
+			quint32 value = i;
+			for(int bit = 0; bit < 8; ++bit) {
+				value = (value >> 1) ^ ((value & 1)?0x82F63B78:0);
+			}
+			values[i] = value;
+		}
+		return values;
+	}();
+
+	for(hddsize i = 0; i < size; ++i) {
+		crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+	}
+
+	return crc;
+}
+
+#if defined(__x86_64__)
+/// Computes CRC32C by SSE4.2 crc32 instruction, 8 bytes at once
+__attribute__((target("sse4.2")))
+static quint32 CRC32CHardware(quint32 crc, const uchar *data, hddsize size) {
+	quint64 value = crc;
+	for(; size >= 8; size -= 8, data += 8) {
+		quint64 word;
+		memcpy(&word, data, sizeof(quint64));
+		value = _mm_crc32_u64(value, word);
+	}
+	crc = value;
+	for(; size > 0; --size, ++data) {
+		crc = _mm_crc32_u8(crc, *data);
+	}
+
+	return crc;
+}
+#endif
+
+Verifier::Verifier() {
+	stopping = false;
+	erase();
+}
+
+quint32 Verifier::CRC32C(const char *data, hddsize size, quint32 crc) {
+	crc = ~crc;
+#if defined(__x86_64__)
+	static const bool sse42 = __builtin_cpu_supports("sse4.2");
+	if(sse42) {
+		return ~CRC32CHardware(crc, (const uchar*)data, size);
+	}
+#endif
+
+	return ~CRC32CSoftware(crc, (const uchar*)data, size);
+}
+
+void Verifier::Stamp(char *buffer, hddsize size, hddsize pos) {
+	Timer timer;
+	timer.MarkStart();
+	++sequence;
+
+	// forget blocks overwritten by this write, also the ones overwritten partially
+	Extents::iterator it = First(pos);
+	while((it != expected.end()) && (it.key() < pos + size)) {
+		hddsize begin = it.key();
+		hddsize from = begin + (qMax(pos, begin) - begin) / BLOCK * BLOCK;
+		hddsize to = qMin(it->end, begin + (pos + size - begin + BLOCK - 1) / BLOCK * BLOCK);
+		it = Remove(it, from, to);
+	}
+
+	// stamp every block
+	hddsize end = pos;
+	for(hddsize done = 0; done + (hddsize)sizeof(Header) <= size; done += BLOCK) {
+		hddsize length = qMin((hddsize)BLOCK, size - done);
+		char *block = buffer + done;
+
+		Header header;
+		header.offset = pos + done;
+		header.sequence = sequence;
+		header.magic = MAGIC;
+		header.crc = CRC32C(block + sizeof(Header), length - sizeof(Header),
+				CRC32C((const char*)&header, offsetof(Header, crc)));
+		memcpy(block, &header, sizeof(Header));
+		end = pos + done + length;
+	}
+
+	if(end > pos) {
+		// continue extent of preceding sequential writes of the same size
+		it = expected.lowerBound(pos);
+		Extents::iterator previous = it;
+		if((it != expected.begin()) && ((--previous)->end == pos) && (previous->stride == size) &&
+				(size % BLOCK == 0) && ((pos - previous.key()) % size == 0) &&
+				(previous->sequence + (pos - previous.key()) / size == sequence)) {
+			previous->end = end;
+		} else {
+			Extent extent;
+			extent.end = end;
+			extent.sequence = sequence;
+			extent.stride = size;
+			expected.insert(pos, extent);
+		}
+	}
+
+	stamped += size;
+	timer.MarkEnd();
+	stamp_time += timer.GetFinalOffset();
+}
+
+void Verifier::Check(const char *buffer, hddsize size, hddsize pos) {
+	Timer timer;
+	timer.MarkStart();
+
+	// blocks read whole only
+	Extents::iterator it = First(pos);
+	while((it != expected.end()) && (it.key() < pos + size)) {
+		hddsize begin = it.key();
+		hddsize from = begin + (qMax(pos, begin) - begin + BLOCK - 1) / BLOCK * BLOCK;
+		hddsize to = (it->end <= pos + size)?it->end:begin + (pos + size - begin) / BLOCK * BLOCK;
+		if(from >= to) {
+			++it;
+			continue;
+		}
+
+		for(hddsize offset = from; offset < to; offset += BLOCK) {
+			const char *block = buffer + (offset - pos);
+			hddsize length = qMin((hddsize)BLOCK, to - offset);
+
+			Header header;
+			memcpy(&header, block, sizeof(Header));
+			quint32 crc = CRC32C(block + sizeof(Header), length - sizeof(Header),
+					CRC32C((const char*)&header, offsetof(Header, crc)));
+			if((header.magic != MAGIC) || (header.crc != crc)) {
+				AddMismatch(offset, "checksum");
+			} else if(header.offset != (quint64)offset) {
+				AddMismatch(offset, "offset");
+			} else if(header.sequence != it->sequence + (offset - begin) / it->stride) {
+				AddMismatch(offset, "sequence");
+			}
+		}
+
+		verified += to - from;
+		it = Remove(it, from, to);
+	}
+
+	timer.MarkEnd();
+	check_time += timer.GetFinalOffset();
+}
+
+void Verifier::Fail(hddsize size, hddsize pos, QString reason) {
+	// blocks reaching into range were not read whole
+	Extents::iterator it = First(pos);
+	while((it != expected.end()) && (it.key() < pos + size)) {
+		hddsize begin = it.key();
+		hddsize from = begin + (qMax(pos, begin) - begin) / BLOCK * BLOCK;
+		hddsize to = qMin(it->end, begin + (pos + size - begin + BLOCK - 1) / BLOCK * BLOCK);
+		for(hddsize offset = from; offset < to; offset += BLOCK) {
+			AddMismatch(offset, reason);
+		}
+		it = Remove(it, from, to);
+	}
+}
+
+bool Verifier::NextRange(hddsize limit, hddsize &pos, hddsize &size) const {
+	if(expected.isEmpty()) {
+		return false;
+	}
+
+	// join adjacent extents
+	Extents::const_iterator it = expected.constBegin();
+	pos = it.key();
+	size = 0;
+	while((it != expected.constEnd()) && (it.key() == pos + size) && (size < limit)) {
+		size += it->end - it.key();
+		++it;
+	}
+	size = qMin(size, limit);
+
+	return true;
+}
+
+Verifier::Extents::iterator Verifier::First(hddsize pos) {
+	// the extent before may reach behind pos
+	Extents::iterator it = expected.lowerBound(pos);
+	if(it != expected.begin()) {
+		Extents::iterator previous = it;
+		--previous;
+		if(previous->end > pos) {
+			it = previous;
+		}
+	}
+
+	return it;
+}
+
+Verifier::Extents::iterator Verifier::Remove(Extents::iterator it, hddsize from, hddsize to) {
+	hddsize begin = it.key();
+	Extent extent = *it;
+	expected.erase(it);
+
+	// keep blocks in front of removed ones
+	if(from > begin) {
+		Extent left = extent;
+		left.end = from;
+		expected.insert(begin, left);
+	}
+
+	// keep blocks behind removed ones, sequence numbers follow write boundaries
+	if(to < extent.end) {
+		hddsize writes = (to - begin) / extent.stride;
+		hddsize boundary = qMin(begin + (writes + 1) * extent.stride, extent.end);
+		if((to - begin) % extent.stride != 0) {
+			// rest of write split in the middle
+			Extent head;
+			head.end = boundary;
+			head.sequence = extent.sequence + writes;
+			head.stride = boundary - to;
+			expected.insert(to, head);
+		} else {
+			boundary = to;
+		}
+		if(boundary < extent.end) {
+			Extent right = extent;
+			right.sequence = extent.sequence + (boundary - begin) / extent.stride;
+			expected.insert(boundary, right);
+		}
+	}
+
+	return expected.lowerBound(to);
+}
+
+void Verifier::AddMismatch(hddsize offset, QString reason) {
+	++mismatch_count;
+	if(mismatches.size() < MAX_MISMATCHES) {
+		Mismatch mismatch;
+		mismatch.offset = offset;
+		mismatch.reason = reason;
+		mismatches.append(mismatch);
+	}
+}
+
+bool Verifier::IsValid() const {
+	return stamped > 0;
+}
+
+qreal Verifier::Speed() const {
+	hddtime time = read_time + check_time;
+	return (time > 0)?(qreal)verified * us / time:0;
+}
+
+QString Verifier::Summary() const {
+	QString summary = "verified " + Def::FormatSize(verified) + " of " + Def::FormatSize(stamped) +
+			" at " + QString::number(Speed(), 'f', 1) + " MB/s, stamping " + Def::FormatTime(stamp_time) +
+			", checking " + Def::FormatTime(check_time) + ", " + QString::number(mismatch_count) + " mismatches";
+	for(int i = 0; i < mismatches.size(); ++i) {
+		summary += "\n" + mismatches[i].reason + " mismatch at " + QString::number(mismatches[i].offset);
+	}
+
+	return summary;
+}
+
+void Verifier::Write(ResultWriter &writer) const {
+	if(!IsValid()) {
+		return;
+	}
+
+	writer.StartElement("Verify");
+	writer.Attribute("stamped", stamped);
+	writer.Attribute("verified", verified);
+	writer.Attribute("stamp_time", stamp_time);
+	writer.Attribute("check_time", check_time);
+	writer.Attribute("read_time", read_time);
+	writer.Attribute("mismatches", mismatch_count);
+	for(int i = 0; i < mismatches.size(); ++i) {
+		writer.StartElement("Mismatch");
+		writer.Attribute("offset", mismatches[i].offset);
+		writer.Attribute("reason", mismatches[i].reason);
+		writer.EndElement();
+	}
+	writer.EndElement();
+}
+
+void Verifier::Read(const ResultElement &root) {
+	erase();
+
+	ResultElement master = root.Child("Verify");
+	if(master.IsNull()) {
+		return;
+	}
+
+	stamped = master.Integer("stamped");
+	verified = master.Integer("verified");
+	stamp_time = master.Integer("stamp_time");
+	check_time = master.Integer("check_time");
+	read_time = master.Integer("read_time");
+	mismatch_count = master.Integer("mismatches");
+
+	ResultList list = master.Children("Mismatch");
+	ResultColumn offsets = list.Column("offset");
+	ResultColumn reasons = list.Column("reason");
+	for(int i = 0; i < list.Size(); ++i) {
+		Mismatch mismatch;
+		mismatch.offset = offsets.Integer(i);
+		mismatch.reason = reasons.Text(i);
+		mismatches.append(mismatch);
+	}
+}
+
+void Verifier::erase() {
+	stamped = 0;
+	verified = 0;
+	stamp_time = 0;
+	check_time = 0;
+	read_time = 0;
+	mismatch_count = 0;
+	mismatches.clear();
+	expected.clear();
+	sequence = 0;
+}
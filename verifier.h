@@ -0,0 +1,130 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "definitions.h"
+
+class ResultWriter;
+class ResultElement;
+
+using namespace HDDTest;
+
+/// Verifies integrity of written data
+/** In verify mode every written block is stamped by its offset, sequence
+number of the write and CRC32C checksum of the whole block. Verifier keeps
+stamps expected at written blocks until the blocks are read back, either
+by benchmark itself or by VerifyWritten of device or file at its end, and
+records offsets of blocks that do not match. Expected stamps are kept as
+extents, sequential writes of the same size are merged to one extent and
+extents are split when they are partially overwritten or read, so memory
+does not grow with amount of data written. Checksum uses SSE4.2 crc32
+instruction when processor has it. Stamping and checking is done outside
+of measured operations and its time is reported separately. **/
+class Verifier {
+public:
+	static const hddsize BLOCK = 4 * K;		/// Unit of stamping, smaller writes are stamped whole
+	static const int MAX_MISMATCHES = 1000;	/// Count of mismatch offsets kept
+	static const hddsize READ_BACK_SIZE = 1 * M;	/// Maximal read of blocks read back at the end
+
+	/// Block that did not match its stamp
+	struct Mismatch {
+		hddsize offset;	/// Offset of block
+		QString reason;	/// checksum, offset, sequence or read
+	};
+
+	Verifier();
+
+	/** Computes CRC32C (Castagnoli) checksum
+	  @param data checked data
+	  @param size data size
+	  @param crc checksum of preceding data for chaining
+	  @return checksum **/
+	static quint32 CRC32C(const char *data, hddsize size, quint32 crc = 0);
+
+	/** Stamps blocks of buffer before write and remembers them
+	  @param buffer data to be written
+	  @param size size of write
+	  @param pos target position of write **/
+	void Stamp(char *buffer, hddsize size, hddsize pos);
+
+	/** Checks remembered blocks inside read data and forgets them
+	  @param buffer read data
+	  @param size size of read
+	  @param pos position data was read from **/
+	void Check(const char *buffer, hddsize size, hddsize pos);
+
+	/** Records remembered blocks of range that could not be read as mismatches and forgets them
+	  @param size range size
+	  @param pos first byte of range
+	  @param reason mismatch reason **/
+	void Fail(hddsize size, hddsize pos, QString reason);
+
+	/** Gets range of remembered blocks to be read back
+	  @param limit maximal range size
+	  @param pos receives first byte of range
+	  @param size receives range size
+	  @return false when all blocks were checked **/
+	bool NextRange(hddsize limit, hddsize &pos, hddsize &size) const;
+
+	bool IsValid() const;		/// Whenever anything was stamped
+	qreal Speed() const;		/// Verified MB/s including read and check time
+	QString Summary() const;	/// Verification result in human readable form
+
+	void Write(ResultWriter &writer) const;	/// Writes verify element
+	void Read(const ResultElement &root);	/// Reads verify element of benchmark element
+	void erase();	/// Erase results and remembered blocks
+
+	hddsize stamped;		/// Bytes stamped
+	hddsize verified;		/// Bytes checked
+	hddtime stamp_time;		/// Time spent stamping
+	hddtime check_time;		/// Time spent checking
+	hddtime read_time;		/// Time of reading back blocks not read by benchmark
+	qint64 mismatch_count;	/// Count of blocks not matching their stamp
+	QList<Mismatch> mismatches;	/// The first mismatching blocks
+	std::atomic<bool> stopping;	/// Set when benchmark is stopping, read back ends early
+
+private:
+	/// Stamped blocks from extent begin (the map key) to end
+	/** Blocks start every BLOCK bytes from begin, the last one can be shorter.
+	Extent is written by writes of stride bytes, block at x has sequence
+	number sequence + (x - begin) / stride. **/
+	struct Extent {
+		hddsize end;		// byte behind extent
+		quint64 sequence;	// sequence number of write at begin
+		hddsize stride;		// size of every write in extent
+	};
+	typedef QMap<hddsize, Extent> Extents;
+
+	static const quint32 MAGIC = 0x48444476;	// marks stamped block
+
+	void AddMismatch(hddsize offset, QString reason);	// record mismatch
+	Extents::iterator First(hddsize pos);			// first extent reaching behind pos
+	Extents::iterator Remove(Extents::iterator it, hddsize from, hddsize to);	// removes blocks from to of extent, returns next extent
+
+	Extents expected;	// blocks written but not checked, extents do not overlap
+	quint64 sequence;	// sequence number of last write
+};
@@ -0,0 +1,205 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "writeblock.h"
+
+WriteBlock::WriteBlock(QObject *parent):
+	Benchmark(parent) {
+	// add subtests to subtest list
+	int base = WRITE_BLOCK_BASE_BLOCK_SIZE;
+	for(int i = 0; i < WRITE_BLOCK_BLOCK_SIZE_COUNT; ++i) {
+		results.push_back(WriteBlockResult(base));
+		reference.push_back(WriteBlockResult(base));
+		base /= WRITE_BLOCK_BLOCK_SIZE_STEP;
+	}
+
+	// test name and description
+	testName = "Write block";
+	testDescription = "Write Block test writes " + Def::FormatSize(WRITE_BLOCK_SIZE) +
+			" with different block sizes. Blocks of specified size are place next to each other." +
+			" No seekeing is required to access next block." +
+			" WARNING: all data on the device are destroyed, test runs only on device that is not mounted." +
+			" Block sizes are: ";
+	for(int i = 0; i < results.size(); ++i) {
+		if(i > 0)
+			testDescription += ", ";
+		testDescription += Def::FormatSize(results[i].__block_size);
+	}
+
+	SetDestructive(true);
+}
+
+void WriteBlock::TestLoop() {
+	// erase prevoius results
+	for(int i = 0;i < results.size(); ++i){
+		results[i].erase();
+	}
+
+	// allocate write buffer for the biggest block before timed writes
+	device->PrepareWriteBuffer(WRITE_BLOCK_BASE_BLOCK_SIZE);
+
+	// run subtests
+	hddsize pos = 0;
+	for(int i = 0; i < results.size(); ++i) {
+		WriteBlockResult *result = &results[i];
+
+		// record latency of every block
+		device->timer.SetHistogram(&result->__histogram);
+
+		// run subtest
+		while(result->__bytes_written < WRITE_BLOCK_SIZE) {
+			// start over when end of device is reached
+			if(pos + result->__block_size > device->GetSize()) {
+				pos = 0;
+			}
+
+			result->__time_elapsed += device->WriteAt(result->__block_size, pos);
+
+			// direct access writes whole logical blocks, count what was really written
+			hddsize done = device->GetTransferred();
+			if(done <= 0) {
+				break;
+			}
+			result->__bytes_written += done;
+			pos += done;
+
+			if(testState == STOPPING) {
+				return;
+			}
+		}
+
+		if(testState == STOPPING) {
+			return;
+		}
+	}
+}
+
+int WriteBlock::GetProgress() {
+	hddsize written = 0;
+
+	for(int i = 0; i < results.size(); ++i)
+		written += results[i].__bytes_written;
+	return (100 * written) / (results.size() * WRITE_BLOCK_SIZE);
+}
+
+QString WriteBlock::GetSummary() {
+	QString summary;
+	for(int i = 0; i < results.size(); ++i) {
+		const WriteBlockResult &result = results.at(i);
+		qreal speed = (result.__time_elapsed > 0)?(qreal)result.__bytes_written * us / (qreal)result.__time_elapsed:0;
+		summary += Def::FormatSize(result.__block_size) + ": " + QString::number(speed, 'f', 1) + " MB/s, " +
+				result.__histogram.Summary() + "\n";
+	}
+
+	return summary.trimmed();
+}
+
+QList<Benchmark::Metric> WriteBlock::GetMetrics() {
+	QList<Metric> metrics;
+	for(int i = 0; i < results.size(); ++i) {
+		const WriteBlockResult &result = results.at(i);
+		if(result.__time_elapsed > 0) {
+			metrics.append(Metric("Speed " + Def::FormatSize(result.__block_size),
+					(qreal)result.__bytes_written * us / (qreal)result.__time_elapsed, "MB/s", true));
+		}
+	}
+
+	return metrics;
+}
+
+WriteBlockResult::WriteBlockResult(hddsize block_size):
+	__bytes_written(0), __time_elapsed(0), __block_size(block_size) {
+	erase();
+}
+
+void WriteBlockResult::erase() {
+	__bytes_written = 0;
+	__time_elapsed = 0;
+	__histogram.erase();
+}
+
+void WriteBlock::WriteResults(ResultWriter &writer) {
+	// create main element
+	writer.StartElement("Write_Block");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("pattern", pattern.Name());
+
+	// write subresults
+	for(int i = 0; i < results.size(); ++i) {
+		writer.StartElement("Result");
+		writer.Attribute("size", results[i].__block_size);
+		writer.Attribute("time", results[i].__time_elapsed);
+		results[i].__histogram.Write(writer);
+		writer.EndElement();
+	}
+
+	sampler.Write(writer);
+	verifier.Write(writer);
+
+	writer.EndElement();
+}
+
+void WriteBlock::RestoreResults(const ResultElement &results, DataSet dataset) {
+	QList<WriteBlockResult> &res = (dataset == REFERENCE)?this->reference:this->results;
+
+	// Locate main writeblock element
+	ResultElement main = results.Child("Write_Block");
+
+	// throughput samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+		verifier.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// remove old results
+	for(int i = 0; i < res.size(); ++i) {
+		res[i].erase();
+	}
+
+	// read subresults
+	hddtime unit = Def::StoredTimeUnit(main);
+	ResultList xmlresults = main.Children("Result");
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		ResultElement xmlresult = xmlresults.At(i);
+		res[i].__block_size = xmlresult.Integer("size");
+		res[i].__time_elapsed = xmlresult.Integer("time") * unit;
+		res[i].__bytes_written = WRITE_BLOCK_SIZE;
+		res[i].__histogram.Read(xmlresult);
+	}
+}
+
+void WriteBlock::EraseResults(DataSet dataset) {
+	// samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.erase();
+		verifier.erase();
+	}
+
+	// erase data
+	QList<WriteBlockResult> &res = (dataset == RESULTS)?results:reference;
+	for(int i = 0; i < res.size(); ++i) {
+		res[i].erase();
+	}
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "device.h"
+
+/// Stores WriteBlock benchmark results
+/** Class for keeping WriteBlock subtest results and progress
+@see WriteBlock class **/
+class WriteBlockResult {
+public:
+	WriteBlockResult(hddsize block_size);
+
+	hddsize __bytes_written;	/// Count of bytes written by selected block size
+	hddtime __time_elapsed;		/// Time elased while writing
+	hddsize __block_size;		/// Size of the block for this subtest
+	Histogram __histogram;		/// Block write latencies
+
+	void erase(); /// Erase all values
+};
+
+/// Write Block benchmark main class
+/** Write Block test. The test writes blocks of different sizes to the device.
+Blocks follow each other so no seeking is needed. The test is destructive
+and it is only run on device which is not mounted.
+@see WriteBlockResult class
+@see WriteBlockWidget class **/
+class WriteBlock : public Benchmark {
+public:
+	WriteBlock(QObject *parent = 0);	/// The constructor
+
+	static const hddsize WRITE_BLOCK_SIZE = 256 * M;			/// Data to be written by every block size
+	static const hddsize WRITE_BLOCK_BASE_BLOCK_SIZE = 1 * M;	/// base block size for first substes
+	static const int WRITE_BLOCK_BLOCK_SIZE_COUNT = 12;			/// Subtest count
+	static const int WRITE_BLOCK_BLOCK_SIZE_STEP = 2;			/// Divisior for next subtest
+
+	void TestLoop();	/// Main benchmark code
+	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+
+	// list of subtest results
+	QList<WriteBlockResult> results;	/// Primary results
+	QList<WriteBlockResult> reference;	/// Reference results
+
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
+	void EraseResults(DataSet dataset);							/// Erases selected results
+};
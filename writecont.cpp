@@ -0,0 +1,167 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "writecont.h"
+
+WriteCont::WriteCont(QObject *parent):
+	Benchmark(parent) {
+	SetDestructive(true);
+
+	testName = "Write Continuous";
+	testDescription = "Write Continuous test writes " + Def::FormatSize(WRITE_CONT_SIZE) + " to device." +
+			" Write operation is divided into blocks of " + Def::FormatSize(WRITE_CONT_BLOCK) + " in order to draw graph." +
+			" Horizontal axis is device position and vertical is write speed." +
+			" The amount of data is large enough to fill write cache of most drives." +
+			" WARNING: all data on the device are destroyed, test runs only on device that is not mounted.";
+}
+
+WriteCont::~WriteCont() {}
+
+void WriteCont::TestLoop() {
+	// get test size
+	hddsize bytes_to_write = WRITE_CONT_SIZE;
+	if(bytes_to_write > device->GetSize())
+		bytes_to_write = device->GetSize();
+
+	// get block count
+	results.blocks = bytes_to_write / WRITE_CONT_BLOCK;
+	results.span = results.blocks * WRITE_CONT_BLOCK;
+
+	// allocate result lists and write buffer before timed writes
+	results.results.reserve(results.blocks);
+	results.positions.reserve(results.blocks);
+	device->PrepareWriteBuffer(WRITE_CONT_BLOCK);
+
+	// record latency of every block
+	device->timer.SetHistogram(&results.histogram);
+
+	// write block until enough data is written
+	device->SetPos(0);
+	for(results.blocks_done = 1; results.blocks_done <= results.blocks; ++results.blocks_done) {
+		hddtime time = device->Write(WRITE_CONT_BLOCK);
+		results.AddResult((qreal)WRITE_CONT_BLOCK * us / time, (results.blocks_done - 1) * WRITE_CONT_BLOCK);
+
+		if(testState == STOPPING)
+			break;
+	}
+}
+
+void WriteCont::InitResults() {
+	results.erase();
+}
+
+int WriteCont::GetProgress() {
+	if(results.blocks == 0)
+		return 0;
+
+	return 100 * results.blocks_done / results.blocks;
+}
+
+QString WriteCont::GetSummary() {
+	return "Speed: " + results.stats.Summary("MB/s") + "\n" +
+			"Block write time: " + results.histogram.Summary();
+}
+
+QList<Benchmark::Metric> WriteCont::GetMetrics() {
+	QList<Metric> metrics;
+	if(results.stats.Count() > 0) {
+		metrics.append(Metric("Speed", results.stats.Mean(), "MB/s", true));
+		metrics.append(Metric("Minimal speed", results.stats.Min(), "MB/s", true));
+		metrics.append(Metric("Block write time p99", (qreal)results.histogram.Percentile(99) / ms, "ms", false));
+	}
+
+	return metrics;
+}
+
+void WriteCont::WriteResults(ResultWriter &writer) {
+	// create main element
+	writer.StartElement("Write_Continuous");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("pattern", pattern.Name());
+	writer.Attribute("span", results.span);
+
+	// write subresults
+	for(int i = 0; i < results.results.size(); ++i) {
+		// add speed element
+		writer.StartElement("Speed");
+		writer.Attribute("value", results.results[i]);
+		writer.Attribute("position", results.positions[i]);
+		writer.EndElement();
+	}
+
+	// write block latencies
+	results.histogram.Write(writer);
+
+	sampler.Write(writer);
+	verifier.Write(writer);
+
+	writer.EndElement();
+}
+
+void WriteCont::RestoreResults(const ResultElement &root, DataSet dataset) {
+	ReadContResults &results = (dataset == REFERENCE)?this->reference:this->results;
+
+	// Locate main writecont element
+	ResultElement main = root.Child("Write_Continuous");
+
+	// throughput samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+		verifier.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// remove results
+	results.erase();
+
+	// get list of write continuous values
+	ResultList res = main.Children("Speed");
+	ResultColumn values = res.Column("value");
+	ResultColumn positions = res.Column("position");
+	results.blocks = res.Size();
+
+	results.span = qMax(main.Integer("span", 1), (hddsize)1);
+
+	// read result data
+	for(int i = 0; i < res.Size(); ++i) {
+		results.AddResult(values.Number(i), positions.Integer(i));
+	}
+
+	// set progress
+	results.blocks_done = results.blocks = res.Size();
+
+	// read block latencies
+	results.histogram.Read(main);
+}
+
+void WriteCont::EraseResults(DataSet dataset) {
+	// erase data
+	if(dataset == RESULTS) {
+		sampler.erase();
+		verifier.erase();
+		results.erase();
+	} else {
+		reference.erase();
+	}
+}
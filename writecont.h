@@ -0,0 +1,54 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "readcont.h"
+
+/// Write Continuous benchmark main class
+/** Implements write continuous test. The test writes blocks one by one from
+the beginning of the device. Enough data is written to exhaust write caches of
+the drive so the speed drop is visible in the graph. The test is destructive
+and it is only run on device which is not mounted.
+Results are kept the same way as Read Continuous results.
+@see ReadContResults
+@see WriteContWidget **/
+class WriteCont : public Benchmark {
+public:
+	WriteCont(QObject *parent = 0);	/// The constructor
+	~WriteCont(); /// The destructor
+
+	static const hddsize WRITE_CONT_SIZE = 64 * G;	/// Size of data written to device
+	static const hddsize WRITE_CONT_BLOCK = 4 * M;	/// Block size by which data are written
+
+	void InitResults();	/// Erases results before benchmark begins
+	void TestLoop();	/// Main benchmark code
+	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+
+	ReadContResults results;	/// Primary results
+	ReadContResults reference;	/// Reference results
+
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
+	void EraseResults(DataSet dataset);							/// Erase elected results
+};
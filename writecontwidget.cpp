@@ -0,0 +1,81 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "writecontwidget.h"
+
+WriteContWidget::WriteContWidget(QWidget *parent):
+	TestWidget(new WriteCont(), parent), test(static_cast<WriteCont*>(benchmark)) {
+	// add line components to graph
+	averageLine = addLine("MB/s", "", QColor(255, 0, 0));
+	refAverageLine = addLine("MB/s", "", QColor(0, 0, 255));
+
+	// add block latency percentiles shown as block write speed
+	percentiles = addPercentiles("MB/s", QColor(255, 160, 0), true);
+
+	// add line graph component to graph
+	graph = addLineGraph("MB/s", QColor(255, 128, 128));
+	refGraph = addLineGraph("MB/s", QColor(128, 128, 255));
+
+	// add background net
+	net = addNet("MB/s", "Device position", "Write speed");
+
+	// raw device test can bypass page cache
+	SetDirectIOVisible(true);
+}
+
+void WriteContWidget::InitScene() {
+	graph->erase();
+}
+
+void WriteContWidget::UpdateScene() {
+	// set line graph line count
+	graph->SetSize(test->results.blocks);
+	refGraph->SetSize(test->reference.blocks);
+
+	// add all new values to line graph at their device position
+	ReadContResults::Sample sample;
+	while(test->results.new_results.Pop(sample)) {
+		graph->AddValue(sample.speed, (qreal)sample.position / test->results.span);
+	}
+
+	// add all new values to reference line graph
+	while(test->reference.new_results.Pop(sample)) {
+		refGraph->AddValue(sample.speed, (qreal)sample.position / test->reference.span);
+	}
+
+	// update horizontal lines
+	averageLine->SetValue(test->results.stats.Mean());
+	refAverageLine->SetValue(test->reference.stats.Mean());
+	percentiles->Set(Settled(test->results.histogram, Benchmark::RESULTS), WriteCont::WRITE_CONT_BLOCK * us);
+
+	// rescale scene to reflect possible new max
+	Rescale();
+}
+
+void WriteContWidget::EraseResults(Benchmark::DataSet dataset) {
+	(dataset == Benchmark::REFERENCE)?refGraph->erase():graph->erase();
+	TestWidget::EraseResults(dataset);
+}
+
+void WriteContWidget::RestoreResults(const ResultElement &root, Benchmark::DataSet dataset) {
+	// restored values are added to empty graph
+	(dataset == Benchmark::REFERENCE)?refGraph->erase():graph->erase();
+	TestWidget::RestoreResults(root, dataset);
+}
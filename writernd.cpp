@@ -0,0 +1,217 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "writernd.h"
+
+WriteRnd::WriteRnd(QObject *parent):
+	Benchmark(parent) {
+	// add subtests to subtest list
+	int base = WRITE_RND_BASE_BLOCK_SIZE;
+	for(int i = 0; i < WRITE_RND_BLOCK_SIZE_COUNT; ++i) {
+		results.push_back(WriteRndResult(base));
+		reference.push_back(WriteRndResult(base));
+		base /= WRITE_RND_BLOCK_SIZE_STEP;
+	}
+
+	// test name and description
+	testName = "Write random";
+	testDescription = "Write random test writes " + QString::number(WRITE_RND_SIZE) +
+			" blocks for each block size. Blocks are distributed randomly across the device." +
+			" WARNING: all data on the device are destroyed, test runs only on device that is not mounted." +
+			" Block sizes are: ";
+	for(int i = 0; i < results.size(); ++i) {
+		if(i > 0) {
+			testDescription += ", ";
+		}
+		testDescription += Def::FormatSize(results[i].__block_size);
+	}
+
+	SetDestructive(true);
+}
+
+void WriteRnd::TestLoop() {
+	// erase prevoius results
+	for(int i = 0;i < results.size(); ++i)
+		results[i].erase();
+
+	// initialize random number generator
+	RandomGenerator gen(seed);
+
+	// allocate write buffer for the biggest block before timed writes
+	device->PrepareWriteBuffer(WRITE_RND_BASE_BLOCK_SIZE);
+
+	// run subtests
+	for(int i = 0; i < results.size(); ++i) {
+		WriteRndResult &result = results[i];
+
+		// record latency of every block
+		device->timer.SetHistogram(&result.__histogram);
+		RandomOffset offsets = GetOffsets(result.__block_size);
+		if(offsets.Count() == 0) {
+			return;
+		}
+
+		// run subtest
+		while(result.__blocks_done < WRITE_RND_SIZE) {
+			// get new position
+			hddsize newpos = offsets.Get(gen);
+
+			result.__time_elapsed += device->WriteAt(result.__block_size, newpos);
+			result.__bytes_written += device->GetTransferred();
+			result.__blocks_done++;
+
+			if(testState == STOPPING) {
+				return;
+			}
+		}
+
+		if(testState == STOPPING) {
+			return;
+		}
+	}
+}
+
+int WriteRnd::GetProgress() {
+	hddsize progress = 0;
+
+	for(int i = 0; i < results.size(); ++i) {
+		progress += results[i].__blocks_done;
+	}
+
+	return (100 * progress) / (results.size() * WRITE_RND_SIZE);
+}
+
+QString WriteRnd::GetSummary() {
+	QString summary;
+	for(int i = 0; i < results.size(); ++i) {
+		const WriteRndResult &result = results.at(i);
+		summary += Def::FormatSize(result.__block_size) + ": " +
+				QString::number(result.Speed(), 'f', 1) + " MB/s, " +
+				result.__histogram.Summary() + "\n";
+	}
+
+	return summary.trimmed();
+}
+
+QList<Benchmark::Metric> WriteRnd::GetMetrics() {
+	QList<Metric> metrics;
+	for(int i = 0; i < results.size(); ++i) {
+		const WriteRndResult &result = results.at(i);
+		if(result.__time_elapsed > 0) {
+			metrics.append(Metric("Speed " + Def::FormatSize(result.__block_size), result.Speed(), "MB/s", true));
+		}
+	}
+
+	return metrics;
+}
+
+hddsize WriteRnd::GetRandomBlock() {
+	return WRITE_RND_BASE_BLOCK_SIZE;
+}
+
+WriteRndResult::WriteRndResult(hddsize block_size):
+	__bytes_written(0), __time_elapsed(0), __block_size(block_size), __blocks_done(0) {
+	erase();
+}
+
+qreal WriteRndResult::Speed() const {
+	return (__time_elapsed > 0)?(qreal)__bytes_written * us / (qreal)__time_elapsed:0;
+}
+
+void WriteRndResult::erase() {
+	__bytes_written = 0;
+	__time_elapsed = 0;
+	__blocks_done = 0;
+	__histogram.erase();
+}
+
+void WriteRnd::WriteResults(ResultWriter &writer) {
+	// create main element
+	writer.StartElement("Write_Random");
+	writer.Attribute("valid", (GetProgress() == 100)?"yes":"no");
+	writer.Attribute("io", directIO?"direct":"cached");
+	writer.Attribute("seed", seed);
+	writer.Attribute("pattern", pattern.Name());
+	writer.Attribute("range_begin", rangeBegin);
+	writer.Attribute("range_end", rangeEnd);
+
+	// write subresults
+	for(int i = 0; i < results.size(); ++i) {
+		writer.StartElement("Result");
+		writer.Attribute("size", results[i].__block_size);
+		writer.Attribute("time", results[i].__time_elapsed);
+		writer.Attribute("written", results[i].__bytes_written);
+		results[i].__histogram.Write(writer);
+		writer.EndElement();
+	}
+
+	sampler.Write(writer);
+	verifier.Write(writer);
+
+	writer.EndElement();
+}
+
+void WriteRnd::RestoreResults(const ResultElement &results, DataSet dataset) {
+	QList<WriteRndResult> &res = (dataset == REFERENCE)?this->reference:this->results;
+
+	// Locate main writernd element
+	ResultElement main = results.Child("Write_Random");
+
+	// throughput samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.Read(main);
+		verifier.Read(main);
+	}
+
+	if(!main.Attribute("valid", "no").compare("no")) {
+		return;
+	}
+
+	// remove old results
+	for(int i = 0; i < res.size(); ++i) {
+		res[i].erase();
+	}
+
+	// read subresults
+	hddtime unit = Def::StoredTimeUnit(main);
+	ResultList xmlresults = main.Children("Result");
+	for(int i = 0; (i < res.size()) && (i < xmlresults.Size()); ++i) {
+		ResultElement xmlresult = xmlresults.At(i);
+		res[i].__block_size = xmlresult.Integer("size");
+		res[i].__time_elapsed = xmlresult.Integer("time") * unit;
+		res[i].__bytes_written = xmlresult.Integer("written");
+		res[i].__blocks_done = WRITE_RND_SIZE;
+		res[i].__histogram.Read(xmlresult);
+	}
+}
+
+void WriteRnd::EraseResults(DataSet dataset) {
+	// samples and verification are kept for results only
+	if(dataset == RESULTS) {
+		sampler.erase();
+		verifier.erase();
+	}
+
+	// erase data
+	QList<WriteRndResult> &res = (dataset == RESULTS)?results:reference;
+	for(int i = 0; i < res.size(); ++i) {
+		res[i].erase();
+	}
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#pragma once
+
+#include "benchmark.h"
+#include "randomgenerator.h"
+#include "device.h"
+
+/// Stores Write Random benchmark results
+/** WriteRndResult class for keeping subtest results and progress
+@see WriteRnd class **/
+class WriteRndResult {
+public:
+	WriteRndResult(hddsize block_size);	/// The constructor
+
+	hddsize __bytes_written;	/// Number of bytes written in this subtest
+	hddtime __time_elapsed;		/// time spend writing in this subtest
+	hddsize __block_size;		/// Block size in this subtest
+	hddsize __blocks_done;		/// Count of blocks done in this subtest
+	Histogram __histogram;		/// Block write latencies
+
+	qreal Speed() const;	/// Write speed in bytes per microsecond (MB/s)
+
+	void erase();	/// Erase results
+};
+
+/// Write Random benchmark main class
+/** Write random test. The test writes blocks of different sizes to random positions on the device.
+The test is destructive and it is only run on device which is not mounted.
+@see WriteRndResult
+@see WriteRndWidget **/
+class WriteRnd : public Benchmark {
+public:
+	WriteRnd(QObject *parent = 0); /// WriteRnd class constructor
+
+	static const hddsize WRITE_RND_SIZE = 1000;				/// Count of blocks written by every subtest
+	static const hddsize WRITE_RND_BASE_BLOCK_SIZE = 1 * M;	/// Base block size (first subtest block size)
+	static const int WRITE_RND_BLOCK_SIZE_COUNT = 12;		/// Subtest count
+	static const int WRITE_RND_BLOCK_SIZE_STEP = 2;			/// next subtest divisior
+
+	void TestLoop();	/// Main benchmark code
+	int GetProgress();	/// Returns benchmark progress
+	QString GetSummary();	/// Returns summary of results
+	QList<Metric> GetMetrics();	/// Returns main numbers of results
+	hddsize GetRandomBlock();	/// Largest block written at random positions
+
+	// list of subtest results
+	QList<WriteRndResult> results;		/// Primary results
+	QList<WriteRndResult> reference;	/// Reference results
+
+	void WriteResults(ResultWriter &writer);				/// Writes results of test
+	void RestoreResults(const ResultElement &root, DataSet dataset);	/// Reads results from result file
+	void EraseResults(DataSet dataset);							/// Erases selected resutls
+};
@@ -0,0 +1,70 @@
+/*******************************************************************************
+*
+*	HDDTest the graphical drive benchmarking tool.
+*	Copyright (C) 2011  Vladimír Matěna <vlada.matena@gmail.com>
+*
+*	This program is free software: you can redistribute it and/or modify
+*	it under the terms of the GNU General Public License as published by
+*	the Free Software Foundation, either version 3 of the License, or
+*	(at your option) any later version.
+*
+*	This program is distributed in the hope that it will be useful,
+*	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	GNU General Public License for more details.
+*
+*	You should have received a copy of the GNU General Public License
+*	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+********************************************************************************/
+
+#include "writerndwidget.h"
+
+WriteRndWidget::WriteRndWidget(QWidget *parent):
+	TestWidget(new WriteRnd(), parent), test(static_cast<WriteRnd*>(benchmark)) {
+	// add bars to scene
+	for(int i = 0; i < test->results.size(); ++i) {
+		Bar *bar = this->addBar(
+				"MB/s",
+				Def::FormatSize(test->results[i].__block_size),
+				QColor(0xff, 0xa0 * (i+1) / test->results.size(), 0),
+				2*i * 1.0f / (test->results.size() + test->reference.size()),
+				1.0f / (test->results.size() + test->reference.size() + 1));
+		bars.push_back(bar);
+	}
+
+	// add reference bars to scene
+	for(int i = 0; i < test->reference.size(); ++i) {
+		Bar *bar = this->addBar(
+				"MB/s",
+				Def::FormatSize(test->reference[i].__block_size),
+				QColor(0, 0xc0 * (i+1) / test->reference.size(), 0xff),
+				(2*i + 1) * 1.0f / (test->reference.size() + test->reference.size()),
+				1.0f / (test->reference.size() + test->reference.size() + 1));
+		reference_bars.push_back(bar);
+	}
+
+	// raw device test can bypass page cache
+	SetDirectIOVisible(true);
+}
+
+void WriteRndWidget::InitScene() {}
+
+void WriteRndWidget::UpdateScene() {
+	// update subtest results
+	for(int i = 0; i < test->results.size(); ++i) {
+		const WriteRndResult &result = test->results.at(i);
+		const WriteRndResult &refer = test->reference.at(i);
+
+		bars[i]->Set((qreal)(100 * result.__blocks_done) / WriteRnd::WRITE_RND_SIZE, result.Speed());
+		reference_bars[i]->Set((qreal)(100 * refer.__blocks_done) / WriteRnd::WRITE_RND_SIZE, refer.Speed());
+
+		// show p99 latency with block size
+		bars[i]->SetName(Def::FormatSize(result.__block_size) + "\np99 " +
+				Def::FormatTime(Settled(result.__histogram, Benchmark::RESULTS).Percentile(99)));
+		reference_bars[i]->SetName(Def::FormatSize(refer.__block_size) + "\np99 " +
+				Def::FormatTime(Settled(refer.__histogram, Benchmark::REFERENCE).Percentile(99)));
+	}
+
+	Rescale();
+}